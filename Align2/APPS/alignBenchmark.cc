@@ -0,0 +1,287 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// --*- C++ -*------x-----------------------------------------------------------
+//
+//
+// Description:     Measures the speed of pairwise alignments in matrix cells
+//                  per second, of the score tabulation alone and of the
+//                  score-only kernel. With --memory it reports the heap
+//                  bytes held by one alignment, with --linear it uses the
+//                  linear space mode of the alignments. With -s it times
+//                  the generation of suboptimal alignments.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <ScoringS2S.h>
+#include <ScoringP2S.h>
+#include <NWAlign.h>
+#include <SWAlign.h>
+#include <FSAlign.h>
+#include <SubMatrix.h>
+#include <AGPFunction.h>
+#include <Alignment.h>
+#include <SequenceData.h>
+#include <Profile.h>
+#include <ScoreKernel.h>
+#include <GetArg.h>
+#include <iostream>
+#include <ctime>
+
+using namespace Victor::Align2;
+using namespace Victor;
+
+// Heap accounting for --memory: the size of every block is kept in
+// front of it, so that live bytes can be followed.
+static const size_t HEADER = 16; // keeps the blocks 16 byte aligned
+static size_t heapBytes = 0; // bytes currently allocated
+static size_t heapPeak = 0; // maximum of heapBytes
+
+void* operator new(size_t n) throw (std::bad_alloc) {
+    size_t* p = static_cast<size_t*> (malloc(n + HEADER));
+    if (p == NULL)
+        throw std::bad_alloc();
+    *p = n;
+    heapBytes += n;
+    heapPeak = max(heapPeak, heapBytes);
+    return reinterpret_cast<char*> (p) + HEADER;
+}
+
+void operator delete(void* q) throw () {
+    if (q == NULL)
+        return;
+    size_t* p = reinterpret_cast<size_t*> (static_cast<char*> (q) - HEADER);
+    heapBytes -= *p;
+    free(p);
+}
+
+/// Show command line options and help text.
+
+void
+sShowHelp() {
+    cout << "\nALIGNMENT BENCHMARK"
+            << "\nTimes sequence-to-sequence (or profile-to-sequence) alignments of the two"
+            << "\nsequences in a FASTA file.\n"
+            << "\nOptions:"
+            << "\n"
+            << "\n * [--in <name>]     \t Name of input FASTA file"
+            << "\n   [--pro1 <name>]   \t Name of target profile (FASTA format) file"
+            << "\n   [--global]        \t Needleman-Wunsch global alignment (default)"
+            << "\n   [--local]         \t Smith-Waterman local alignment"
+            << "\n   [--freeshift]     \t Free-shift alignment"
+            << "\n   [-r <int>]        \t Concatenate each sequence r times (default = 1)"
+            << "\n   [-n <int>]        \t Repetitions (default = 10)"
+            << "\n   [-m <name>]       \t Name of substitution matrix file (default = blosum62.dat)"
+            << "\n   [-o <double>]     \t Open gap penalty (default = 12.00)"
+            << "\n   [-e <double>]     \t Extension gap penalty (default = 3.00)"
+            << "\n   [--memory]        \t Report heap bytes held by one alignment and peak bytes"
+            << "\n   [--linear]        \t Align in linear space mode"
+            << "\n   [-s <int>]        \t Time s suboptimal alignments (default = 0)"
+            << "\n" << endl;
+}
+
+/// Return s concatenated r times.
+
+string
+sRepeat(const string &s, unsigned int r) {
+    string res;
+    for (unsigned int i = 0; i < r; i++)
+        res += s;
+    return res;
+}
+
+/// Average seconds per score of sk, optionally vectorised.
+
+double
+sTimeKernel(ScoreKernel &sk, bool vectorised, bool local, unsigned int num,
+        double &score) {
+    sk.setVectorised(vectorised);
+    clock_t start = clock();
+    for (unsigned int k = 0; k < num; k++)
+        score = (local ? sk.getLocalScore() : sk.getGlobalScore());
+    return static_cast<double> (clock() - start) / CLOCKS_PER_SEC / num;
+}
+
+/// Return an alignment of the selected type.
+
+Align*
+sNewAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss, bool local,
+        bool freeshift, bool linear) {
+    if (local)
+        return new SWAlign(ad, gf, ss, linear);
+    if (freeshift)
+        return new FSAlign(ad, gf, ss, linear);
+    return new NWAlign(ad, gf, ss, linear);
+}
+
+int
+main(int argc, char **argv) {
+    string inputFileName, pro1FileName, matrixFileName;
+    double openGapPenalty, extensionGapPenalty;
+    unsigned int rep, num, subopt;
+    bool local, freeshift, memory, linear;
+
+    if (getArg("h", argc, argv)) {
+        sShowHelp();
+        return 1;
+    }
+
+    getArg("-in", inputFileName, argc, argv, "!");
+    getArg("-pro1", pro1FileName, argc, argv, "!");
+    local = getArg("-local", argc, argv);
+    freeshift = getArg("-freeshift", argc, argv);
+    getArg("r", rep, argc, argv, 1);
+    getArg("n", num, argc, argv, 10);
+    getArg("m", matrixFileName, argc, argv, "blosum62.dat");
+    getArg("o", openGapPenalty, argc, argv, 12.00);
+    getArg("e", extensionGapPenalty, argc, argv, 3.00);
+    memory = getArg("-memory", argc, argv);
+    linear = getArg("-linear", argc, argv);
+    getArg("s", subopt, argc, argv, 0);
+    if (num == 0)
+        num = 1;
+    if (rep == 0)
+        rep = 1;
+
+    string path = getenv("VICTOR_ROOT");
+    if (path.length() < 3)
+        cout << "Warning: environment variable VICTOR_ROOT is not set." << endl;
+    string dataPath = path + "data/";
+
+    if (inputFileName == "!")
+        ERROR("alignBenchmark needs input FASTA file.", exception);
+    ifstream inputFile(inputFileName.c_str());
+    if (!inputFile)
+        ERROR("Error opening input FASTA file.", exception);
+    Alignment ali;
+    ali.loadFasta(inputFile);
+    if (ali.size() < 1)
+        ERROR("Input FASTA file must contain two sequences.", exception);
+    string seq1 = sRepeat(Alignment::getPureSequence(ali.getTarget()), rep);
+    string seq2 = sRepeat(Alignment::getPureSequence(ali.getTemplate()), rep);
+
+    matrixFileName = dataPath + matrixFileName;
+    ifstream matrixFile(matrixFileName.c_str());
+    if (!matrixFile)
+        ERROR("Error opening substitution matrix file.", exception);
+    SubMatrix sub(matrixFile);
+
+    AlignmentData *ad = new SequenceData(2, seq1, seq2, ali.getTargetName(),
+            ali.getTemplateName());
+    GapFunction *gf = new AGPFunction(openGapPenalty, extensionGapPenalty);
+    ScoringScheme *ss;
+    if (pro1FileName != "!") {
+        if (rep != 1)
+            ERROR("Profiles can not be concatenated.", exception);
+        ifstream pro1File(pro1FileName.c_str());
+        if (!pro1File)
+            ERROR("Error opening target profile file.", exception);
+        Alignment ali1;
+        ali1.loadFasta(pro1File);
+        Profile *pro1 = new Profile();
+        pro1->setProfile(ali1);
+        ss = new ScoringP2S(&sub, ad, 0, pro1, 1.00);
+    } else
+        ss = new ScoringS2S(&sub, ad, 0, 1.00);
+
+    unsigned int n = seq1.size();
+    unsigned int m = seq2.size();
+    double cells = static_cast<double> (n) * m;
+
+    // score tabulation: one scoring() call per cell vs. scoringMatrix()
+    vector<double> cellScores(n * m);
+    clock_t start = clock();
+    for (unsigned int k = 0; k < num; k++)
+        for (unsigned int i = 0; i < n; i++)
+            for (unsigned int j = 0; j < m; j++)
+                cellScores[i * m + j] = ss->scoring(i + 1, j + 1);
+    double tCell = static_cast<double> (clock() - start) / CLOCKS_PER_SEC / num;
+
+    vector<double> matrixScores;
+    vector<unsigned int> row;
+    start = clock();
+    for (unsigned int k = 0; k < num; k++)
+        ss->scoringMatrix(n, m, matrixScores, row);
+    double tMatrix = static_cast<double> (clock() - start) / CLOCKS_PER_SEC / num;
+    bool same = true;
+    for (unsigned int i = 0; i < n; i++)
+        for (unsigned int j = 0; j < m; j++)
+            if (matrixScores[row[i] + j] != cellScores[i * m + j])
+                same = false;
+
+    // complete alignments
+    double score = 0.0;
+    start = clock();
+    for (unsigned int k = 0; k < num; k++) {
+        Align *a = sNewAlign(ad, gf, ss, local, freeshift, linear);
+        score = a->getScore();
+        delete a;
+    }
+    double tAlign = static_cast<double> (clock() - start) / CLOCKS_PER_SEC / num;
+
+    cout << "n\tm\tscore\tscoring() (s)\tscoringMatrix() (s)\talign (s)\tMcells/s\n"
+            << n << "\t" << m << "\t" << score << "\t"
+            << tCell << "\t" << tMatrix << "\t" << tAlign << "\t"
+            << (tAlign > 0 ? cells / tAlign / 1e6 : 0.0)
+            << (same ? "" : "\tMISMATCH") << endl;
+
+    if (memory) {
+        size_t startBytes = heapBytes;
+        heapPeak = heapBytes;
+        Align *a = sNewAlign(ad, gf, ss, local, freeshift, linear);
+        double bytes = heapBytes - startBytes;
+        double peak = heapPeak - startBytes;
+        delete a;
+        cout << "\nalignment (MB)\tbytes/cell\tpeak (MB)\tbytes/cell\n"
+                << bytes / 1048576 << "\t" << bytes / cells << "\t"
+                << peak / 1048576 << "\t" << peak / cells << endl;
+    }
+
+    // suboptimal alignments after the optimal one
+    if (subopt > 0) {
+        if (linear)
+            ERROR("Suboptimal alignments are not available in linear space mode.",
+                exception);
+        Align *a = sNewAlign(ad, gf, ss, local, freeshift, linear);
+        start = clock();
+        vector<double> scores = a->generateMultiMatchScore(subopt + 1);
+        double tSubopt = static_cast<double> (clock() - start) / CLOCKS_PER_SEC;
+        delete a;
+        cout << "\nsuboptimals\tlast score\ttotal (s)\tper alignment (s)\n"
+                << subopt << "\t" << scores.back() << "\t" << tSubopt << "\t"
+                << tSubopt / subopt << endl;
+    }
+
+    // score-only kernel, global or local
+    if (!freeshift) {
+        ScoreKernel sk(ss, openGapPenalty, extensionGapPenalty);
+        double scalarScore, vectorScore;
+        double tScalar = sTimeKernel(sk, false, local, num, scalarScore);
+        double tVector = sTimeKernel(sk, true, local, num, vectorScore);
+        if (scalarScore != vectorScore)
+            same = false;
+
+        cout << "\nkernel score\tscalar (s)\tMcells/s\tSSE2 (s)\tMcells/s\n"
+                << vectorScore << "\t" << tScalar << "\t"
+                << (tScalar > 0 ? cells / tScalar / 1e6 : 0.0) << "\t"
+                << tVector << "\t"
+                << (tVector > 0 ? cells / tVector / 1e6 : 0.0)
+                << (sk.isVectorised() ? "" : "\t(scalar fallback)")
+                << (scalarScore == vectorScore ? "" : "\tMISMATCH") << endl;
+    }
+
+    return (same ? 0 : 1);
+}
@@ -52,6 +52,7 @@
 #include <AlignmentBase.h>
 #include <SequenceData.h>
 #include <SecSequenceData.h>
+#include <ScoreKernel.h>
 #include <GetArg.h>
 #include <iostream>
 #include <ctime>
@@ -106,6 +107,10 @@ sShowHelp() {
             << "\n   [-n <int>]        \t Number of suboptimal alignments (default = 1)"
             << "\n   [-p <double>]     \t Penalty multiplier for suboptimal alignments (default = 1.00)"
             << "\n   [-a <double>]     \t Penalty subtractor for suboptimal alignments (default = 1.00)"
+            << "\n   [--kernel]        \t Score the pair with the vectorised affine gap kernel first"
+            << "\n                     \t (global or local alignment with AGP only)"
+            << "\n   [--minScore <double>] \t Calculate alignments only if the kernel score reaches this value"
+            << "\n   [--linear]        \t Keep O(m sqrt(n)) matrix cells instead of n * m (optimal alignment only)"
             << "\n"
             << "\n   [-m <name>]       \t Name of substitution matrix file (default = blosum62.dat)"
             << "\n   [-M <name>]       \t Name of structural substitution matrix file (default = secid.dat)"
@@ -156,7 +161,8 @@ main(int argc, char **argv) {
     double weightHelix, weightStrand, weightBuried, weightStraight, weightSpace;
     double cSeq, cStr;
     unsigned int weightingScheme, scoringFunction, suboptNum, gapFunction, extensionType, structure;
-    bool fasta, global, local, freeshift, verbose;
+    double minScore;
+    bool fasta, global, local, freeshift, verbose, kernel, linear;
     struct tm* newtime;
     time_t t;
 
@@ -189,6 +195,9 @@ main(int argc, char **argv) {
     getArg("n", suboptNum, argc, argv, 1);
     getArg("p", suboptPenaltyMul, argc, argv, 1.00);
     getArg("a", suboptPenaltyAdd, argc, argv, 1.00);
+    kernel = getArg("-kernel", argc, argv);
+    getArg("-minScore", minScore, argc, argv, -numeric_limits<double>::max());
+    linear = getArg("-linear", argc, argv);
 
     getArg("m", matrixFileName, argc, argv, "blosum62.dat");
     getArg("M", matrixStrFileName, argc, argv, "secid.dat");
@@ -536,19 +545,34 @@ main(int argc, char **argv) {
     // 4. Calculate alignments
     // --------------------------------------------------
 
+    if (kernel) {
+        if (freeshift || (gapFunction != 0))
+            ERROR("--kernel supports global and local alignments with AGP only.", exception);
+        ScoreKernel sk(ss, openGapPenalty, extensionGapPenalty);
+        double kernelScore = (local ? sk.getLocalScore() : sk.getGlobalScore());
+        cout << "Kernel score = " << kernelScore << endl;
+        if (kernelScore < minScore) {
+            cout << "Kernel score below " << minScore << ", no alignments calculated.\n";
+            return 0;
+        }
+    }
+
+    if (linear && (suboptNum > 1))
+        ERROR("--linear calculates the optimal alignment only (-n 1).", exception);
+
     Align *a;
 
     if (global) {
         cout << "\nSuboptimal Needleman-Wunsch alignments:\n" << endl;
-        a = new NWAlign(ad, gf, ss);
+        a = new NWAlign(ad, gf, ss, linear);
     } else
         if (local) {
         cout << "\nSuboptimal Smith-Waterman alignments:\n" << endl;
-        a = new SWAlign(ad, gf, ss);
+        a = new SWAlign(ad, gf, ss, linear);
     } else {
         cout << "\nSuboptimal free-shift alignments:\n" << endl;
         try {
-            a = new FSAlign(ad, gf, ss);
+            a = new FSAlign(ad, gf, ss, linear);
         } catch (const char* a) {
             cout << "FSAlign error!\n";
         }
@@ -28,17 +28,16 @@ namespace Victor { namespace Align2{
 
     // CONSTRUCTORS:
 
-    Align::Align(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss) : ad(ad),
-    gf(gf), ss(ss), F((ad->getSequence(1)).size() + 1),
-    B((ad->getSequence(1)).size() + 1), n((ad->getSequence(1)).size()),
-    m((ad->getSequence(2)).size()), res1Pos(), res2Pos() {
-        //cout<<"building align objA\n";
-        vector<double> frow(m + 1, 0);
-        vector<Traceback> brow(m + 1);
-        //cout<<"building align objB\n";
-        for (unsigned int i = 0; i < F.size(); ++i) {
-            F[i] = frow;
-            B[i] = brow;
+    Align::Align(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+            bool linearSpace) : ad(ad), gf(gf), ss(ss),
+    n((ad->getSequence(1)).size()),
+    m((ad->getSequence(2)).size()), res1Pos(), res2Pos(),
+    linearSpace(linearSpace), linearScore(0.00) {
+        if (!linearSpace) {
+            //cout<<"building align objA\n";
+            F.assign(n + 1, vector<double>(m + 1, 0));
+            //cout<<"building align objB\n";
+            B.resize(n + 1, m + 1);
         }
         //cout<<"building align objC\n";
         setPenalties(0.98, 0.00);
@@ -237,22 +236,12 @@ namespace Victor { namespace Align2{
         gf = orig.gf->newCopy();
         ss = orig.ss->newCopy();
 
-        F.clear();
-        for (unsigned int i = 0; i < orig.F.size(); i++) {
-            vector<double> *tmp = new vector<double>;
-            for (unsigned int j = 0; j < orig.F[i].size(); j++)
-                tmp->push_back(orig.F[i][j]);
-            F.push_back(*tmp);
-        }
+        F = orig.F;
 
-        B.clear();
-        for (unsigned int i = 0; i < orig.B.size(); i++) {
-            vector<Traceback> *tmp = new vector<Traceback>;
-            for (unsigned int j = 0; j < orig.B[i].size(); j++)
-                tmp->push_back(orig.B[i][j]);
-            B.push_back(*tmp);
-        }
+        B = orig.B;
 
+        S = orig.S;
+        SRow = orig.SRow;
         B0 = orig.B0;
         n = orig.n;
         m = orig.m;
@@ -267,6 +256,10 @@ namespace Victor { namespace Align2{
 
         penaltyMul = orig.penaltyMul;
         penaltyAdd = orig.penaltyAdd;
+        linearSpace = orig.linearSpace;
+        linearScore = orig.linearScore;
+        path = orig.path;
+        modified = orig.modified;
     }
 /**
  * 
@@ -277,19 +270,232 @@ namespace Victor { namespace Align2{
             for (unsigned int j = 0; j < F[i].size(); j++)
                 F[i][j] = -999;
 
-        for (unsigned int i = 0; i < B.size(); i++)
-            for (unsigned int j = 0; j < B[i].size(); j++) {
-                B[i][j].i = -999;
-                B[i][j].j = -999;
-            }
+        B.clear();
 
         B0.i = -999;
         B0.j = -999;
 
         res1Pos.clear();
         res2Pos.clear();
+        modified.clear();
 
         pCalculateMatrix(true);
     }
 
+
+    // HELPERS:
+    /**
+     * Tabulates ss->scoring() for all positions, so the matrix calculation
+     * reads the scores of position (i, j) linearly from S[SRow[i - 1] + j - 1].
+     * The scores do not change between suboptimal alignments, hence they
+     * are only recalculated on update.
+     * @param update
+     */
+    void
+    Align::pCalculateScores(bool update) {
+        if (update || (SRow.size() != n))
+            ss->scoringMatrix(n, m, S, SRow);
+    }
+    /**
+     * SSEA variant: the score of (i, j) is multiplied by the shorter of
+     * the segment lengths v1[i - 1] and v2[j - 1].
+     * @param i
+     * @param v1
+     * @param v2
+     * @param s buffer for the weighted scores
+     * @return
+     */
+    const double*
+    Align::pScoreRow(int i, const vector<unsigned int> &v1,
+            const vector<unsigned int> &v2, vector<double> &s) const {
+        const double *row = pScoreRow(i);
+        s.resize(m);
+        for (unsigned int j = 0; j < m; j++)
+            s[j] = row[j] * min(v1[i - 1], v2[j]);
+        return (s.empty() ? NULL : &s[0]);
+    }
+    /**
+     * The forward pass keeps two rows, the last column and every k-th row.
+     * The traceback then recalculates the rows between two stored ones,
+     * from the block of the end point B0 upwards, and keeps the path only.
+     * The scores are calculated one row at a time, S is not kept.
+     * With update false (suboptimal alignment) the path is discarded, as
+     * there is no matrix to recalculate it from.
+     * @param update
+     */
+    void
+    Align::pCalculateLinear(bool update) {
+        if (!update) {
+            if (path.empty())
+                ERROR("Suboptimal alignments are not available in linear space mode.",
+                    exception);
+            path.clear();
+            B0 = Traceback::getInvalidTraceback();
+            return;
+        }
+
+        vector<double>().swap(S);
+        vector<unsigned int>().swap(SRow);
+        int k = static_cast<int> (ceil(sqrt(n + 1.0)));
+
+        // forward pass
+        vector<double> s, fUp(m + 1, 0), f(m + 1, 0), lastCol(n + 1);
+        TracebackMatrix b(2, m + 1);
+        vector< vector<double> > fStored(n / k + 1);
+        TracebackMatrix bStored(n / k + 1, m + 1);
+
+        pInitialiseRow(0, fUp, b, 0);
+        fStored[0] = fUp;
+        bStored.copyRow(0, b, 0);
+        lastCol[0] = fUp[m];
+        for (int i = 1; i <= static_cast<int> (n); i++) {
+            pInitialiseRow(i, f, b, 1);
+            ss->scoringRow(i, m, s);
+            pCalculateRow(i, 1, m, (s.empty() ? NULL : &s[0]), fUp, f, b, 1);
+            lastCol[i] = f[m];
+            if (i % k == 0) {
+                fStored[i / k] = f;
+                bStored.copyRow(i / k, b, 1);
+            }
+            fUp.swap(f);
+            b.copyRow(0, b, 1);
+        }
+        pFindEnd(fUp, lastCol);
+
+        // traceback, one block of k rows at a time
+        path.clear();
+        TracebackMatrix block(k, m + 1);
+        int first = -1; // first row of block
+        Traceback tb = B0;
+        while (!Traceback::isInvalidTraceback(tb)) {
+            if ((first < 0) || (tb.i < first)) {
+                first = (tb.i / k) * k;
+                fUp = fStored[first / k];
+                block.copyRow(0, bStored, first / k);
+                if (B0.i == first)
+                    linearScore = fUp[B0.j];
+                for (int i = first + 1; (i < first + k) && (i <= static_cast<int> (n)); i++) {
+                    pInitialiseRow(i, f, block, i - first);
+                    ss->scoringRow(i, m, s);
+                    pCalculateRow(i, 1, m, (s.empty() ? NULL : &s[0]), fUp, f,
+                            block, i - first);
+                    if (B0.i == i)
+                        linearScore = f[B0.j];
+                    fUp.swap(f);
+                }
+            }
+
+            path.push_back(tb);
+            TracebackMatrix::Direction d = block.getDirection(tb.i - first, tb.j);
+            if (d == TracebackMatrix::INVALID)
+                break;
+            tb = Traceback(tb.i - (d & TracebackMatrix::UP),
+                    tb.j - ((d & TracebackMatrix::LEFT) >> 1));
+        }
+    }
+    void
+    Align::pFindMatrixEnd() {
+        vector<double> lastCol(n + 1);
+        for (unsigned int i = 0; i <= n; i++)
+            lastCol[i] = F[i][m];
+        pFindEnd(F[n], lastCol);
+    }
+    /**
+     * Same result as pCalculateMatrix(false), which recalculates B from
+     * all of F after each suboptimal alignment. Since F only changes at
+     * the modified cells, a cell of B can only change if a neighbour in F
+     * was modified, or if the cell above or to the left changed direction.
+     * Each row is recalculated over the window of such columns. The window
+     * is extended to the right while directions keep changing.
+     */
+    void
+    Align::pUpdateMatrix() {
+        if (linearSpace) {
+            pCalculateLinear(false);
+            return;
+        }
+        pCalculateScores(false);
+
+        // modified columns of each row
+        vector<int> modLo(n + 1, m + 1), modHi(n + 1, -1);
+        int lastRow = -1;
+        for (unsigned int k = 0; k < modified.size(); k++) {
+            int i = modified[k].i;
+            modLo[i] = min(modLo[i], modified[k].j);
+            modHi[i] = max(modHi[i], modified[k].j);
+            lastRow = max(lastRow, i);
+        }
+        modified.clear();
+
+        TracebackMatrix old(1, m + 1);
+        int changedLo = m + 1; // columns of row i - 1 that changed direction
+        int changedHi = -1;
+        for (int i = 1; i <= static_cast<int> (n); i++) {
+            int lo = m + 1;
+            int hi = -1;
+            if (modHi[i - 1] >= 0) {
+                lo = min(lo, modLo[i - 1]);
+                hi = max(hi, modHi[i - 1] + 1);
+            }
+            if (modHi[i] >= 0) {
+                lo = min(lo, modLo[i] + 1);
+                hi = max(hi, modHi[i] + 1);
+            }
+            if (changedHi >= 0) {
+                lo = min(lo, changedLo);
+                hi = max(hi, changedHi);
+            }
+            lo = max(lo, 1);
+            hi = min(hi, static_cast<int> (m));
+
+            changedLo = m + 1;
+            changedHi = -1;
+            if (lo > hi) {
+                if (i > lastRow)
+                    break;
+                continue;
+            }
+
+            old.copyRow(0, B, i);
+            int width = hi - lo + 1;
+            while (true) {
+                pCalculateRow(i, lo, hi, pScoreRow(i), F[i - 1], F[i], B, i,
+                        false);
+                for (int j = lo; j <= hi; j++)
+                    if (B.getDirection(i, j) != old.getDirection(0, j)) {
+                        changedLo = min(changedLo, j);
+                        changedHi = max(changedHi, j);
+                    }
+
+                if ((hi == static_cast<int> (m)) || (changedHi != hi))
+                    break;
+                lo = hi + 1;
+                width *= 2;
+                hi = min(hi + width, static_cast<int> (m));
+            }
+        }
+
+        pFindMatrixEnd();
+    }
+    /**
+     * The path is ordered by decreasing i and j, hence binary search.
+     * @param tb
+     * @return
+     */
+    Traceback
+    Align::pNextOnPath(const Traceback &tb) const {
+        unsigned int lo = 0;
+        unsigned int hi = path.size();
+        while (lo < hi) {
+            unsigned int mid = (lo + hi) / 2;
+            if ((path[mid].i > tb.i) || ((path[mid].i == tb.i) && (path[mid].j > tb.j)))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if ((lo + 1 < path.size()) && (path[lo] == tb))
+            return path[lo + 1];
+        return Traceback::getInvalidTraceback();
+    }
+
 }} // namespace
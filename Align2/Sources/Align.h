@@ -24,6 +24,7 @@
 #include <IoTools.h>
 #include <ScoringScheme.h>
 #include <Traceback.h>
+#include <TracebackMatrix.h>
 #include <algorithm>
 #include <iostream>
 #include <limits>
@@ -44,6 +45,15 @@ namespace Victor { namespace Align2{
      *    originally based
      *                  on the Java implementation from Peter Sestoft.
      *                  http://www.dina.dk/~sestoft
+     *
+     *  In linear space mode F and B are not kept. The forward pass stores
+     * every k-th row, k = sqrt(n + 1), and the traceback recalculates the
+     * rows between two stored ones, which takes O(m sqrt(n)) memory and
+     * about 1.5 times the time. The position scores are calculated per
+     * row with ScoringScheme::scoringRow() instead of being tabulated in
+     * S. The same recurrences are used as for the full matrix, hence
+     * alignment and score are identical, but suboptimal alignments are
+     * not available.
      **/
     class Align {
     public:
@@ -58,7 +68,8 @@ namespace Victor { namespace Align2{
         // CONSTRUCTORS:
 
         /// Default constructor.
-        Align(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        Align(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+                bool linearSpace = false);
 
         /// Copy constructor.
         Align(const Align &orig);
@@ -84,6 +95,9 @@ namespace Victor { namespace Align2{
         /// Return ScoringScheme pointer.
         ScoringScheme* getScoringScheme();
 
+        /// Return true if only the optimal path is kept (linear space mode).
+        bool isLinearSpace() const;
+
         /// Return next Traceback element.
         virtual Traceback next(const Traceback &tb) const;
 
@@ -151,6 +165,42 @@ namespace Victor { namespace Align2{
         virtual void pCalculateMatrix(const vector<unsigned int> &v1,
                 const vector<unsigned int> &v2, bool update = true) = 0;
 
+        /// Update/create the scores of all positions.
+        void pCalculateScores(bool update = true);
+
+        /// Return the scores of row i, s[j - 1] being the score of (i, j).
+        const double* pScoreRow(int i) const;
+
+        /// Return the scores of row i weighted by segment lengths v1 and v2.
+        const double* pScoreRow(int i, const vector<unsigned int> &v1,
+                const vector<unsigned int> &v2, vector<double> &s) const;
+
+        /// Set the border cells of row i, stored in f and in row bi of b.
+        virtual void pInitialiseRow(int i, vector<double> &f,
+                TracebackMatrix &b, int bi, bool update = true) = 0;
+
+        /// Calculate columns jFirst to jLast of row i into f and row bi of b
+        /// from row i - 1 (fUp, bi - 1).
+        virtual void pCalculateRow(int i, int jFirst, int jLast,
+                const double *s, const vector<double> &fUp, vector<double> &f,
+                TracebackMatrix &b, int bi, bool update = true) = 0;
+
+        /// Set B0 from the last row and the last column of F.
+        virtual void pFindEnd(const vector<double> &lastRow,
+                const vector<double> &lastCol) = 0;
+
+        /// Set B0 from F.
+        void pFindMatrixEnd();
+
+        /// Recalculate B and B0 where they depend on the modified cells.
+        void pUpdateMatrix();
+
+        /// Calculate score and optimal path in linear space mode.
+        void pCalculateLinear(bool update = true);
+
+        /// Return the predecessor of tb on the optimal path.
+        Traceback pNextOnPath(const Traceback &tb) const;
+
 
         // ATTRIBUTES:
 
@@ -158,7 +208,9 @@ namespace Victor { namespace Align2{
         GapFunction *gf; ///< Pointer to GapFunction.
         ScoringScheme *ss; ///< Pointer to ScoringScheme.
         vector< vector<double> > F; ///< Score matrix.
-        vector< vector<Traceback> > B; ///< Traceback matrix.
+        vector<double> S; ///< Rows of position scores.
+        vector<unsigned int> SRow; ///< Offset in S of each target position.
+        TracebackMatrix B; ///< Traceback matrix.
         Traceback B0; ///< Starting point of the traceback.
         unsigned int n; ///< Length of target sequence.
         unsigned int m; ///< Length of template sequence.
@@ -166,6 +218,10 @@ namespace Victor { namespace Align2{
         mutable vector<int> res2Pos; ///< Aligned positions for template sequence.
         double penaltyMul; ///< Multiplicative penalty for suboptimal alignment.
         double penaltyAdd; ///< Additive penalty for suboptimal alignment.
+        bool linearSpace; ///< Keep the optimal path instead of F and B.
+        double linearScore; ///< Alignment score in linear space mode.
+        vector<Traceback> path; ///< Optimal path from B0 in linear space mode.
+        vector<Traceback> modified; ///< Cells modified since the last update of B.
 
 
     protected:
@@ -196,17 +252,26 @@ namespace Victor { namespace Align2{
         return ss;
     }
 
+    inline bool
+    Align::isLinearSpace() const {
+        return linearSpace;
+    }
+
     inline Traceback
     Align::next(const Traceback& tb) const {
-        if ((B.size() > 0) && (tb.i >= 0) && (tb.j >= 0) &&
-                (tb.i < static_cast<int> (B.size())) &&
-                (tb.j < static_cast<int> (B[tb.i].size())))
-            return B[tb.i][tb.j];
+        if (linearSpace)
+            return pNextOnPath(tb);
+        if ((tb.i >= 0) && (tb.j >= 0) &&
+                (tb.i < static_cast<int> (B.rows())) &&
+                (tb.j < static_cast<int> (B.cols())))
+            return B.get(tb.i, tb.j);
         return Traceback::getInvalidTraceback();
     }
 
     inline double
     Align::getScore() const {
+        if (linearSpace)
+            return linearScore;
         return F[B0.i][B0.j];
     }
 
@@ -230,7 +295,18 @@ namespace Victor { namespace Align2{
      */
     inline void
     Align::pModifyMatrix(int i, int j) {
-        F[i][j] = penaltyMul * F[i][j] - penaltyAdd;
+        if (!linearSpace) {
+            F[i][j] = penaltyMul * F[i][j] - penaltyAdd;
+            modified.push_back(Traceback(i, j));
+        }
+    }
+
+
+    // HELPERS:
+
+    inline const double*
+    Align::pScoreRow(int i) const {
+        return (S.empty() ? NULL : &S[SRow[i - 1]]);
     }
 
 }} // namespace
@@ -31,8 +31,9 @@ namespace Victor { namespace Align2{
 
         // CONSTRUCTORS:
 
-        /// Default constructor.
-        NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        /// Default constructor, optionally in linear space mode.
+        NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+                bool linearSpace = false);
 
         /// Constructor with weighted alignment positions.
         NWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
@@ -75,6 +76,20 @@ namespace Victor { namespace Align2{
         virtual void pCalculateMatrix(const vector<unsigned int> &v1,
                 const vector<unsigned int> &v2, bool update = true);
 
+        /// Set the border cells of row i, stored in f and in row bi of b.
+        virtual void pInitialiseRow(int i, vector<double> &f,
+                TracebackMatrix &b, int bi, bool update = true);
+
+        /// Calculate columns jFirst to jLast of row i into f and row bi of b
+        /// from row i - 1 (fUp, bi - 1).
+        virtual void pCalculateRow(int i, int jFirst, int jLast,
+                const double *s, const vector<double> &fUp, vector<double> &f,
+                TracebackMatrix &b, int bi, bool update = true);
+
+        /// Set B0 to (n, m).
+        virtual void pFindEnd(const vector<double> &lastRow,
+                const vector<double> &lastCol);
+
 
     protected:
 
@@ -30,9 +30,11 @@ namespace Victor { namespace Align2{
      * @param ad
      * @param gf
      * @param ss
+     * @param linearSpace
      */
     NWAlignNoTermGaps::NWAlignNoTermGaps(AlignmentData *ad, GapFunction *gf,
-            ScoringScheme *ss) : Align(ad, gf, ss) {
+            ScoringScheme *ss, bool linearSpace)
+    : Align(ad, gf, ss, linearSpace) {
         pCalculateMatrix(true);
     }
     /**
@@ -95,7 +97,7 @@ namespace Victor { namespace Align2{
             tb = next(tb);
         }
 
-        pCalculateMatrix(false); // recalculate F, B and B0 from modified data
+        pUpdateMatrix(); // recalculate B and B0 from modified data
         ad->getMatch();
     }
 
@@ -124,61 +126,18 @@ namespace Victor { namespace Align2{
      */
     void
     NWAlignNoTermGaps::pCalculateMatrix(bool update) {
-        if (update)
-            F[0][0] = 0;
-
-        for (int i = 1; i <= static_cast<int> (n); i++) {
-            if (update)
-                F[i][0] = 0;
-            B[i][0] = Traceback(i - 1, 0);
+        if (linearSpace) {
+            pCalculateLinear(update);
+            return;
         }
 
-        for (int j = 1; j <= static_cast<int> (m); j++) {
-            if (update)
-                F[0][j] = 0;
-            B[0][j] = Traceback(0, j - 1);
-        }
+        pCalculateScores(update);
 
-        for (int i = 1; i <= static_cast<int> (n); i++)
-            for (int j = 1; j <= static_cast<int> (m); j++) {
-                double s = ss->scoring(i, j);
-                double extI, extJ;
-
-                if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
-                    else
-                        if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
-                } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
-
-                if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
-                    else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
-                } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
-
-                double z = F[i - 1][j - 1] + s;
-                double val = max(max(z, extI), extJ);
+        for (int i = 0; i <= static_cast<int> (n); i++)
+            pInitialiseRow(i, F[i], B, i, update);
 
-                if (update)
-                    F[i][j] = val;
-
-                if (EQUALS(val, z))
-                    B[i][j] = Traceback(i - 1, j - 1);
-                else
-                    if (EQUALS(val, extJ))
-                    B[i][j] = Traceback(i, j - 1);
-                else
-                    if (EQUALS(val, extI))
-                    B[i][j] = Traceback(i - 1, j);
-                else
-                    ERROR("Error in NWAlignNoTermGaps: NW 1", exception);
-            }
+        for (int i = 1; i <= static_cast<int> (n); i++)
+            pCalculateRow(i, 1, m, pScoreRow(i), F[i - 1], F[i], B, i, update);
 
         B0 = Traceback(n, m);
     }
@@ -196,73 +155,102 @@ namespace Victor { namespace Align2{
             const vector<unsigned int> &v2, bool update) {
         // start SSEA variant code
         PRECOND((v1.size() == sq1.size()) && (v2.size() == sq2.size()), exception);
-        unsigned int minL = 0;
+        vector<double> s;
         // end SSEA variant code
 
-        if (update)
-            F[0][0] = 0;
+        pCalculateScores(update);
 
-        for (int i = 1; i <= static_cast<int> (n); i++) {
-            if (update)
-                F[i][0] = 0;
-            B[i][0] = Traceback(i - 1, 0);
-        }
-
-        for (int j = 1; j <= static_cast<int> (m); j++) {
-            if (update)
-                F[0][j] = 0;
-            B[0][j] = Traceback(0, j - 1);
-        }
+        for (int i = 0; i <= static_cast<int> (n); i++)
+            pInitialiseRow(i, F[i], B, i, update);
 
         for (int i = 1; i <= static_cast<int> (n); i++)
-            for (int j = 1; j <= static_cast<int> (m); j++) {
-                // start SSEA variant code
-                if (v1[i - 1] < v2[j - 1])
-                    minL = v1[i - 1];
-                else
-                    minL = v2[j - 1];
-
-                double s = ss->scoring(i, j) * minL;
-                // end SSEA variant code
-
-                double extI, extJ;
-
-                if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
-                    else
-                        if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
-                } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
-
-                if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
-                    else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
-                } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
-
-                double z = F[i - 1][j - 1] + s;
-                double val = max(max(z, extI), extJ);
+            pCalculateRow(i, 1, m, pScoreRow(i, v1, v2, s), F[i - 1], F[i], B,
+                i, update);
 
+        B0 = Traceback(n, m);
+    }
+    /**
+     * Leading gaps are free.
+     * @param i
+     * @param f
+     * @param b
+     * @param bi
+     * @param update
+     */
+    void
+    NWAlignNoTermGaps::pInitialiseRow(int i, vector<double> &f, TracebackMatrix &b,
+            int bi, bool update) {
+        if (i == 0) {
+            if (update)
+                f[0] = 0;
+            for (int j = 1; j <= static_cast<int> (m); j++) {
                 if (update)
-                    F[i][j] = val;
-
-                if (EQUALS(val, z))
-                    B[i][j] = Traceback(i - 1, j - 1);
-                else
-                    if (EQUALS(val, extJ))
-                    B[i][j] = Traceback(i, j - 1);
-                else
-                    if (EQUALS(val, extI))
-                    B[i][j] = Traceback(i - 1, j);
-                else
-                    ERROR("Error in NWAlignNoTermGaps: NW 1", exception);
+                    f[j] = 0;
+                b.set(bi, j, TracebackMatrix::LEFT);
             }
+        } else {
+            if (update)
+                f[0] = 0;
+            b.set(bi, 0, TracebackMatrix::UP);
+        }
+    }
+    /**
+     * 
+     * @param i
+     * @param jFirst
+     * @param jLast
+     * @param s
+     * @param fUp
+     * @param f
+     * @param b
+     * @param bi
+     * @param update
+     */
+    void
+    NWAlignNoTermGaps::pCalculateRow(int i, int jFirst, int jLast, const double *s,
+            const vector<double> &fUp, vector<double> &f, TracebackMatrix &b,
+            int bi, bool update) {
+        for (int j = jFirst; j <= jLast; j++) {
+            double extI, extJ;
+
+            if ((i != 1) && (j != 1) &&
+                    (b.getDirection(bi - 1, j) == TracebackMatrix::UP))
+                extI = fUp[j] - gf->getExtensionPenalty(j);
+            else
+                extI = fUp[j] - gf->getOpenPenalty(j);
+
+            if ((i != 1) && (j != 1) &&
+                    (b.getDirection(bi, j - 1) == TracebackMatrix::LEFT))
+                extJ = f[j - 1] - gf->getExtensionPenalty(j);
+            else
+                extJ = f[j - 1] - gf->getOpenPenalty(j);
+
+            double z = fUp[j - 1] + s[j - 1];
+            double val = max(max(z, extI), extJ);
 
+            if (update)
+                f[j] = val;
+
+            if (EQUALS(val, z))
+                b.set(bi, j, TracebackMatrix::DIAGONAL);
+            else
+                if (EQUALS(val, extJ))
+                b.set(bi, j, TracebackMatrix::LEFT);
+            else
+                if (EQUALS(val, extI))
+                b.set(bi, j, TracebackMatrix::UP);
+            else
+                ERROR("Error in NWAlignNoTermGaps: NW 1", exception);
+        }
+    }
+    /**
+     * 
+     * @param lastRow
+     * @param lastCol
+     */
+    void
+    NWAlignNoTermGaps::pFindEnd(const vector<double> &lastRow,
+            const vector<double> &lastCol) {
         B0 = Traceback(n, m);
     }
 
@@ -31,9 +31,10 @@ namespace Victor { namespace Align2{
      * @param ad
      * @param gf
      * @param ss
+     * @param linearSpace
      */
-    SWAlign::SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss)
-    : Align(ad, gf, ss) {
+    SWAlign::SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+            bool linearSpace) : Align(ad, gf, ss, linearSpace) {
         pCalculateMatrix(true);
     }
 
@@ -81,7 +82,7 @@ namespace Victor { namespace Align2{
             tb = next(tb);
         }
 
-        pCalculateMatrix(false); // recalculate F, B and B0 from modified data
+        pUpdateMatrix(); // recalculate B and B0 from modified data
         ad->getMatch();
     }
 
@@ -91,6 +92,8 @@ namespace Victor { namespace Align2{
     void
     SWAlign::copy(const SWAlign &orig) {
         Align::copy(orig);
+        blockMax = orig.blockMax;
+        blockMaxJ = orig.blockMaxJ;
     }
     /**
      * 
@@ -110,64 +113,20 @@ namespace Victor { namespace Align2{
      */
     void
     SWAlign::pCalculateMatrix(bool update) {
-        int maxi = n;
-        int maxj = m;
-        double maxval = INT_MIN;
-
-        for (int i = 1; i <= static_cast<int> (n); i++)
-            for (int j = 1; j <= static_cast<int> (m); j++) {
-                double s = ss->scoring(i, j);
-                double extI, extJ;
-
-                if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
-                    else
-                        if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
-                } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
-
-                if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
-                    else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
-                } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
-
-                double z = F[i - 1][j - 1] + s;
-                double val = max(max(max(z, extI), extJ), 0.00);
+        if (linearSpace) {
+            pCalculateLinear(update);
+            return;
+        }
 
-                if (update)
-                    F[i][j] = val;
+        pCalculateScores(update);
 
-                if (EQUALS(val, 0))
-                    B[i][j] = Traceback::getInvalidTraceback();
-                else
-                    if (val > 0) {
-                    if (EQUALS(val, z))
-                        B[i][j] = Traceback(i - 1, j - 1);
-                    else
-                        if (EQUALS(val, extJ))
-                        B[i][j] = Traceback(i, j - 1);
-                    else
-                        if (EQUALS(val, extI))
-                        B[i][j] = Traceback(i - 1, j);
-                    else
-                        ERROR("Error in SWAlign: SW 1", exception);
-                } else
-                    ERROR("Error in SWAlign: SW 2", exception);
+        for (int i = 0; i <= static_cast<int> (n); i++)
+            pInitialiseRow(i, F[i], B, i, update);
 
-                if (val > maxval) {
-                    maxval = val;
-                    maxi = i;
-                    maxj = j;
-                }
+        for (int i = 1; i <= static_cast<int> (n); i++)
+            pCalculateRow(i, 1, m, pScoreRow(i), F[i - 1], F[i], B, i, update);
 
-                B0 = Traceback(maxi, maxj);
-            }
+        pFindMatrixEnd();
     }
 
 
@@ -183,75 +142,154 @@ namespace Victor { namespace Align2{
             const vector<unsigned int> &v2, bool update) {
         // start SSEA variant code
         PRECOND((v1.size() == sq1.size()) && (v2.size() == sq2.size()), exception);
-        unsigned int minL = 0;
+        vector<double> s;
         // end SSEA variant code
 
-        int maxi = n;
-        int maxj = m;
-        double maxval = INT_MIN;
+        pCalculateScores(update);
 
-        for (int i = 1; i <= static_cast<int> (n); i++)
-            for (int j = 1; j <= static_cast<int> (m); j++) {
-                // start SSEA variant code
-                if (v1[i - 1] < v2[j - 1])
-                    minL = v1[i - 1];
-                else
-                    minL = v2[j - 1];
+        for (int i = 0; i <= static_cast<int> (n); i++)
+            pInitialiseRow(i, F[i], B, i, update);
 
-                double s = ss->scoring(i, j) * minL;
-                // end SSEA variant
+        for (int i = 1; i <= static_cast<int> (n); i++)
+            pCalculateRow(i, 1, m, pScoreRow(i, v1, v2, s), F[i - 1], F[i], B,
+                i, update);
 
+        pFindMatrixEnd();
+    }
+    /**
+     * The border cells keep their initial score 0 and no predecessor.
+     * @param i
+     * @param f
+     * @param b
+     * @param bi
+     * @param update
+     */
+    void
+    SWAlign::pInitialiseRow(int i, vector<double> &f, TracebackMatrix &b,
+            int bi, bool update) {
+    }
+    /**
+     * Keeps the first maximum of each block of columns for pFindEnd().
+     * Columns jFirst to jLast are extended to whole blocks, so that the
+     * maxima stay exact when only part of a row is recalculated.
+     * @param i
+     * @param jFirst
+     * @param jLast
+     * @param s
+     * @param fUp
+     * @param f
+     * @param b
+     * @param bi
+     * @param update
+     */
+    void
+    SWAlign::pCalculateRow(int i, int jFirst, int jLast, const double *s,
+            const vector<double> &fUp, vector<double> &f, TracebackMatrix &b,
+            int bi, bool update) {
+        int width = pBlockWidth();
+        unsigned int blocks = (m + width - 1) / width;
+        if (blockMax.size() != (n + 1) * blocks) {
+            blockMax.assign((n + 1) * blocks, INT_MIN);
+            blockMaxJ.assign((n + 1) * blocks, -1);
+        }
+        int firstBlock = (jFirst - 1) / width;
+        int lastBlock = (jLast - 1) / width;
+        jFirst = firstBlock * width + 1;
+
+        for (int k = firstBlock; k <= lastBlock; k++) {
+            double maxi = INT_MIN;
+            int maxJ = -1;
+            int jEnd = min((k + 1) * width, static_cast<int> (m));
+            for (int j = k * width + 1; j <= jEnd; j++) {
                 double extI, extJ;
+                pGapScores(i, j, fUp, f, b, bi, extI, extJ);
 
-                if ((i != 1) && (j != 1)) {
-                    if (B[i - 1][j].j == j)
-                        extI = F[i - 1][j] - gf->getExtensionPenalty(j);
-                    else
-                        if (B[i - 1][j].j == (j - 1))
-                        extI = F[i - 1][j] - gf->getOpenPenalty(j);
-                } else
-                    extI = F[i - 1][j] - gf->getOpenPenalty(j);
-
-                if ((i != 1) && (j != 1)) {
-                    if (B[i][j - 1].i == i)
-                        extJ = F[i][j - 1] - gf->getExtensionPenalty(j);
-                    else
-                        if (B[i][j - 1].i == (i - 1))
-                        extJ = F[i][j - 1] - gf->getOpenPenalty(j);
-                } else
-                    extJ = F[i][j - 1] - gf->getOpenPenalty(j);
-
-                double z = F[i - 1][j - 1] + s;
+                double z = fUp[j - 1] + s[j - 1];
                 double val = max(max(max(z, extI), extJ), 0.00);
 
                 if (update)
-                    F[i][j] = val;
+                    f[j] = val;
 
                 if (EQUALS(val, 0))
-                    B[i][j] = Traceback::getInvalidTraceback();
+                    b.set(bi, j, TracebackMatrix::INVALID);
                 else
                     if (val > 0) {
                     if (EQUALS(val, z))
-                        B[i][j] = Traceback(i - 1, j - 1);
+                        b.set(bi, j, TracebackMatrix::DIAGONAL);
                     else
                         if (EQUALS(val, extJ))
-                        B[i][j] = Traceback(i, j - 1);
+                        b.set(bi, j, TracebackMatrix::LEFT);
                     else
                         if (EQUALS(val, extI))
-                        B[i][j] = Traceback(i - 1, j);
+                        b.set(bi, j, TracebackMatrix::UP);
                     else
                         ERROR("Error in SWAlign: SW 1", exception);
                 } else
                     ERROR("Error in SWAlign: SW 2", exception);
 
-                if (val > maxval) {
-                    maxval = val;
-                    maxi = i;
-                    maxj = j;
+                if (val > maxi) {
+                    maxi = val;
+                    maxJ = j;
                 }
-
-                B0 = Traceback(maxi, maxj);
             }
+            blockMax[i * blocks + k] = maxi;
+            blockMaxJ[i * blocks + k] = maxJ;
+        }
+    }
+    /**
+     * B0 is the first cell with the maximum score, in row order.
+     * @param lastRow
+     * @param lastCol
+     */
+    void
+    SWAlign::pFindEnd(const vector<double> &lastRow,
+            const vector<double> &lastCol) {
+        int width = pBlockWidth();
+        unsigned int blocks = (m + width - 1) / width;
+        double maxi = INT_MIN;
+        for (unsigned int k = blocks; k < blockMax.size(); k++)
+            if (blockMax[k] > maxi) {
+                maxi = blockMax[k];
+                B0 = Traceback(k / blocks, blockMaxJ[k]);
+            }
+    }
+    /**
+     * A gap is extended from a neighbour reached by a gap in the same
+     * direction, otherwise opened. A neighbour without predecessor scores
+     * 0, hence a gap from it is opened as well.
+     * @param i
+     * @param j
+     * @param fUp
+     * @param f
+     * @param b
+     * @param bi
+     * @param extI
+     * @param extJ
+     */
+    void
+    SWAlign::pGapScores(int i, int j, const vector<double> &fUp,
+            const vector<double> &f, const TracebackMatrix &b, int bi,
+            double &extI, double &extJ) const {
+        if ((i != 1) && (j != 1) &&
+                (b.getDirection(bi - 1, j) == TracebackMatrix::UP))
+            extI = fUp[j] - gf->getExtensionPenalty(j);
+        else
+            extI = fUp[j] - gf->getOpenPenalty(j);
+
+        if ((i != 1) && (j != 1) &&
+                (b.getDirection(bi, j - 1) == TracebackMatrix::LEFT))
+            extJ = f[j - 1] - gf->getExtensionPenalty(j);
+        else
+            extJ = f[j - 1] - gf->getOpenPenalty(j);
+    }
+    /**
+     * Rows are only recalculated in part outside linear space mode, where
+     * one maximum per row is enough.
+     * @return
+     */
+    int
+    SWAlign::pBlockWidth() const {
+        return (linearSpace ? max(static_cast<int> (m), 1) : MAX_BLOCK);
     }
 
 }} // namespace
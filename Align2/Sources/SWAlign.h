@@ -30,10 +30,18 @@ namespace Victor { namespace Align2{
     class SWAlign : public Align {
     public:
 
+        /// Columns sharing one maximum in pCalculateRow(), unless in linear
+        /// space mode.
+
+        enum {
+            MAX_BLOCK = 64
+        };
+
         // CONSTRUCTORS:
 
-        /// Default constructor.
-        SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss);
+        /// Default constructor, optionally in linear space mode.
+        SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
+                bool linearSpace = false);
 
         /// Constructor with weighted alignment positions.
         SWAlign(AlignmentData *ad, GapFunction *gf, ScoringScheme *ss,
@@ -76,12 +84,39 @@ namespace Victor { namespace Align2{
         virtual void pCalculateMatrix(const vector<unsigned int> &v1,
                 const vector<unsigned int> &v2, bool update = true);
 
+        /// Set the border cells of row i, stored in f and in row bi of b.
+        virtual void pInitialiseRow(int i, vector<double> &f,
+                TracebackMatrix &b, int bi, bool update = true);
+
+        /// Calculate columns jFirst to jLast of row i into f and row bi of b
+        /// from row i - 1 (fUp, bi - 1).
+        virtual void pCalculateRow(int i, int jFirst, int jLast,
+                const double *s, const vector<double> &fUp, vector<double> &f,
+                TracebackMatrix &b, int bi, bool update = true);
+
+        /// Set B0 to the maximum found by pCalculateRow().
+        virtual void pFindEnd(const vector<double> &lastRow,
+                const vector<double> &lastCol);
+
+        /// Update the gap scores extI and extJ of (i, j) from column j - 1.
+        void pGapScores(int i, int j, const vector<double> &fUp,
+                const vector<double> &f, const TracebackMatrix &b, int bi,
+                double &extI, double &extJ) const;
+
+        /// Return the number of columns sharing one maximum in pCalculateRow().
+        int pBlockWidth() const;
+
 
     protected:
 
 
     private:
 
+        // ATTRIBUTES:
+
+        vector<double> blockMax; ///< Maximum score of each block of a row.
+        vector<int> blockMaxJ; ///< Column of the first maximum of each block.
+
     };
 
 }} // namespace
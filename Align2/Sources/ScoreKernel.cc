@@ -0,0 +1,247 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// --*- C++ -*------x-----------------------------------------------------------
+//
+// Description:     Score-only affine gap alignment of target and template.
+//
+// -----------------x-----------------------------------------------------------
+
+#include <ScoreKernel.h>
+#include <algorithm>
+#include <map>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Victor { namespace Align2{
+
+    /// Score of impossible states, far from any real score.
+    static const float NEG_SCORE = -1e30f;
+
+#ifdef __SSE2__
+    /// Number of template positions per register.
+    static const unsigned int LANES = 4;
+
+    /// Return v moved up by one lane, with first in lane 0.
+    static inline __m128
+    sShift(__m128 v, float first) {
+        return _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)),
+                _mm_set_ss(first));
+    }
+#else
+    static const unsigned int LANES = 1;
+#endif
+
+    // CONSTRUCTORS:
+    /**
+     *
+     * @param ss
+     * @param open
+     * @param ext
+     */
+    ScoreKernel::ScoreKernel(ScoringScheme *ss, double open, double ext)
+    : n(ss->ad->getSequence(1).size()), m(ss->ad->getSequence(2).size()),
+    open(open), ext(ext), segLen((m + LANES - 1) / LANES), vectorised(true) {
+        vector<double> s;
+        ss->scoringMatrix(n, m, s, row);
+        prof.assign(s.begin(), s.end());
+
+        // one striped copy of each distinct row
+        map<unsigned int, unsigned int> copies;
+        stripedRow.resize(n);
+        for (unsigned int i = 0; i < n; i++) {
+            map<unsigned int, unsigned int>::iterator it = copies.find(row[i]);
+            if (it == copies.end()) {
+                unsigned int base = striped.size();
+                striped.resize(base + segLen * LANES, NEG_SCORE);
+                for (unsigned int j = 0; j < m; j++)
+                    striped[base + (j % segLen) * LANES + j / segLen] = prof[row[i] + j];
+                it = copies.insert(make_pair(row[i], base)).first;
+            }
+            stripedRow[i] = it->second;
+        }
+    }
+
+    ScoreKernel::~ScoreKernel() {
+    }
+
+
+    // PREDICATES:
+
+    double
+    ScoreKernel::getLocalScore() const {
+        return (isVectorised() ? pStripedScore(true) : pScalarScore(true));
+    }
+
+    double
+    ScoreKernel::getGlobalScore() const {
+        return (isVectorised() ? pStripedScore(false) : pScalarScore(false));
+    }
+    /**
+     * The striped loop stops propagating horizontal gaps once they can
+     * not improve a cell, which requires ext > 0 and open >= ext.
+     * @return
+     */
+    bool
+    ScoreKernel::isVectorised() const {
+#ifdef __SSE2__
+        return (vectorised && (ext > 0) && (open >= ext) && (n > 0) && (m > 0));
+#else
+        return false;
+#endif
+    }
+
+
+    // MODIFIERS:
+
+    void
+    ScoreKernel::setVectorised(bool v) {
+        vectorised = v;
+    }
+
+
+    // HELPERS:
+    /**
+     * Row by row Gotoh recurrences. H holds the best scores of the previous
+     * row left of j and of the current row from j on, E the best scores
+     * ending with a gap in the template.
+     * @param local
+     * @return
+     */
+    float
+    ScoreKernel::pScalarScore(bool local) const {
+        vector<float> H(m + 1), E(m + 1);
+        for (unsigned int j = 0; j <= m; j++) {
+            H[j] = (local ? 0 : pBorder(j));
+            E[j] = H[j] - open;
+        }
+
+        float best = 0;
+        for (unsigned int i = 1; i <= n; i++) {
+            const float *s = &prof[row[i - 1]] - 1;
+            float diag = H[0];
+            H[0] = (local ? 0 : pBorder(i));
+            float f = H[0] - open;
+
+            for (unsigned int j = 1; j <= m; j++) {
+                float e = E[j];
+                float h = max(max(diag + s[j], e), f);
+                if (local)
+                    h = max(h, 0.0f);
+                diag = H[j];
+                H[j] = h;
+                best = max(best, h);
+                E[j] = max(e - ext, h - open);
+                f = max(f - ext, h - open);
+            }
+        }
+
+        return (local ? best : H[m]);
+    }
+    /**
+     * Farrar's striped Smith-Waterman (Bioinformatics 23, 156, 2007),
+     * extended to global alignment by initialising the borders.
+     * Register k holds template positions k, k + segLen, k + 2 * segLen
+     * and k + 3 * segLen. A first pass over the registers assumes no
+     * horizontal gap crosses from one lane to the next; the lazy loop
+     * afterwards propagates those gaps until they stop improving a cell.
+     * @param local
+     * @return
+     */
+    float
+    ScoreKernel::pStripedScore(bool local) const {
+#ifdef __SSE2__
+        vector<float> hLoad(segLen * LANES), hStore(segLen * LANES),
+                e(segLen * LANES);
+        for (unsigned int k = 0; k < segLen; k++)
+            for (unsigned int l = 0; l < LANES; l++) {
+                unsigned int idx = k * LANES + l;
+                hLoad[idx] = (local ? 0 : pBorder(l * segLen + k + 1));
+                e[idx] = hLoad[idx] - open;
+            }
+
+        const __m128 vOpen = _mm_set1_ps(open);
+        const __m128 vExt = _mm_set1_ps(ext);
+        const __m128 vNoGain = _mm_set1_ps(open - ext);
+        const __m128 vZero = _mm_setzero_ps();
+        __m128 vBest = vZero;
+        float *pLoad = &hLoad[0];
+        float *pStore = &hStore[0];
+        float *pE = &e[0];
+
+        for (unsigned int i = 1; i <= n; i++) {
+            const float *p = &striped[stripedRow[i - 1]];
+            float left = (local ? 0 : pBorder(i));
+            __m128 vF = sShift(_mm_set1_ps(NEG_SCORE), left - open);
+            __m128 vH = sShift(_mm_loadu_ps(pLoad + (segLen - 1) * LANES),
+                    (local ? 0 : pBorder(i - 1)));
+
+            for (unsigned int k = 0; k < segLen; k++) {
+                vH = _mm_add_ps(vH, _mm_loadu_ps(p + k * LANES));
+                __m128 vE = _mm_loadu_ps(pE + k * LANES);
+                vH = _mm_max_ps(_mm_max_ps(vH, vE), vF);
+                if (local) {
+                    vH = _mm_max_ps(vH, vZero);
+                    vBest = _mm_max_ps(vBest, vH);
+                }
+                _mm_storeu_ps(pStore + k * LANES, vH);
+
+                __m128 vHOpen = _mm_sub_ps(vH, vOpen);
+                _mm_storeu_ps(pE + k * LANES, _mm_max_ps(_mm_sub_ps(vE, vExt), vHOpen));
+                vF = _mm_max_ps(_mm_sub_ps(vF, vExt), vHOpen);
+                vH = _mm_loadu_ps(pLoad + k * LANES);
+            }
+
+            // lazy F loop: carry horizontal gaps into the next lane
+            vF = sShift(vF, NEG_SCORE);
+            unsigned int k = 0;
+            while (true) {
+                vH = _mm_loadu_ps(pStore + k * LANES);
+                if (!_mm_movemask_ps(_mm_cmpgt_ps(vF, _mm_sub_ps(vH, vNoGain))))
+                    break;
+                vH = _mm_max_ps(vH, vF);
+                if (local)
+                    vBest = _mm_max_ps(vBest, vH);
+                _mm_storeu_ps(pStore + k * LANES, vH);
+                _mm_storeu_ps(pE + k * LANES, _mm_max_ps(
+                        _mm_loadu_ps(pE + k * LANES), _mm_sub_ps(vH, vOpen)));
+                vF = _mm_sub_ps(vF, vExt);
+                if (++k == segLen) {
+                    k = 0;
+                    vF = sShift(vF, NEG_SCORE);
+                }
+            }
+
+            swap(pLoad, pStore);
+        }
+
+        if (!local)
+            return pLoad[((m - 1) % segLen) * LANES + (m - 1) / segLen];
+
+        float lanes[LANES];
+        _mm_storeu_ps(lanes, vBest);
+        return *max_element(lanes, lanes + LANES);
+#else
+        return pScalarScore(local);
+#endif
+    }
+
+    float
+    ScoreKernel::pBorder(unsigned int k) const {
+        return (k == 0 ? 0 : -open - ext * (k - 1));
+    }
+
+}} // namespace
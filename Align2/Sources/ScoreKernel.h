@@ -0,0 +1,104 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __ScoreKernel_H__
+#define __ScoreKernel_H__
+
+#include <ScoringScheme.h>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief  Score-only affine gap alignment of target and template.
+     *
+     *  Computes the optimal local (Smith-Waterman) or global
+     * (Needleman-Wunsch) score with Gotoh's recurrences, a gap of length L
+     * costing open + (L - 1) * ext. No traceback is kept, which makes it a
+     * fast filter to decide which pairs deserve a full alignment.
+     *
+     *  The template is processed in Farrar's striped layout, four single
+     * precision positions per SSE2 register. Without SSE2, or for gap
+     * penalties the striped loop does not support (ext <= 0 or
+     * open < ext), a scalar loop computes the same recurrences. Position
+     * scores come from ScoringScheme::scoringMatrix(), hence sequence and
+     * profile scoring schemes are both supported.
+     **/
+    class ScoreKernel {
+    public:
+
+        // CONSTRUCTORS:
+
+        /// Default constructor.
+        ScoreKernel(ScoringScheme *ss, double open, double ext);
+
+        /// Destructor.
+        virtual ~ScoreKernel();
+
+
+        // PREDICATES:
+
+        /// Return the optimal local alignment score.
+        double getLocalScore() const;
+
+        /// Return the optimal global alignment score.
+        double getGlobalScore() const;
+
+        /// Return true if the striped SSE2 loop is used.
+        bool isVectorised() const;
+
+
+        // MODIFIERS:
+
+        /// Use the striped SSE2 loop if possible (default) or the scalar one.
+        void setVectorised(bool v);
+
+
+    protected:
+
+
+    private:
+
+        // HELPERS:
+
+        /// Score with the scalar loop.
+        float pScalarScore(bool local) const;
+
+        /// Score with the striped SSE2 loop.
+        float pStripedScore(bool local) const;
+
+        /// Global alignment score of a leading gap of length k.
+        float pBorder(unsigned int k) const;
+
+
+        // ATTRIBUTES:
+
+        unsigned int n; ///< Length of target sequence.
+        unsigned int m; ///< Length of template sequence.
+        float open; ///< Open gap penalty.
+        float ext; ///< Extension gap penalty.
+        vector<float> prof; ///< Rows of position scores.
+        vector<unsigned int> row; ///< Offset in prof of each target position.
+        unsigned int segLen; ///< Number of template positions per lane.
+        vector<float> striped; ///< Rows of prof in striped order.
+        vector<unsigned int> stripedRow; ///< Offset in striped of each target position.
+        bool vectorised; ///< Use the striped loop.
+
+    };
+
+}} // namespace
+
+#endif
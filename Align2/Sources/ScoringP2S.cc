@@ -74,6 +74,74 @@ namespace Victor { namespace Align2{
 
         return s;
     }
+    /**
+     * Reads the substitution scores of every template position and the
+     * profile frequencies of every target position only once.
+     * @param n
+     * @param m
+     * @param s
+     * @param row
+     */
+    void
+    ScoringP2S::scoringMatrix(unsigned int n, unsigned int m,
+            vector<double> &s, vector<unsigned int> &row) {
+        const unsigned int nAmino = TYR - ALA;
+        vector<double> subCol(m * nAmino);
+        for (unsigned int j = 0; j < m; j++)
+            for (AminoAcidCode amino = ALA; amino < TYR; amino++)
+                subCol[j * nAmino + (amino - ALA)] =
+                    sub->score[seq2[j]][aminoAcidOneLetterTranslator(amino)];
+
+        vector<double> freq(nAmino);
+        s.resize(n * m);
+        row.resize(n);
+        for (unsigned int i = 0; i < n; i++) {
+            row[i] = i * m;
+            for (AminoAcidCode amino = ALA; amino < TYR; amino++)
+                freq[amino - ALA] = pro->getAminoFrequencyFromCode(amino, i);
+
+            for (unsigned int j = 0; j < m; j++) {
+                const double *col = &subCol[j * nAmino];
+                double sc = 0.00;
+                for (unsigned int k = 0; k < nAmino; k++)
+                    sc += col[k] * freq[k];
+                sc *= cSeq;
+
+                if (str != 0)
+                    sc += str->scoringStr(i + 1, j + 1);
+                s[i * m + j] = sc;
+            }
+        }
+    }
+    /**
+     * Same scores as row i - 1 of scoringMatrix(), reading the profile
+     * frequencies of target position i only once.
+     * @param i
+     * @param m
+     * @param s
+     */
+    void
+    ScoringP2S::scoringRow(int i, unsigned int m, vector<double> &s) {
+        const unsigned int nAmino = TYR - ALA;
+        vector<char> residue(nAmino);
+        vector<double> freq(nAmino);
+        for (AminoAcidCode amino = ALA; amino < TYR; amino++) {
+            residue[amino - ALA] = aminoAcidOneLetterTranslator(amino);
+            freq[amino - ALA] = pro->getAminoFrequencyFromCode(amino, i - 1);
+        }
+
+        s.resize(m);
+        for (unsigned int j = 0; j < m; j++) {
+            double sc = 0.00;
+            for (unsigned int k = 0; k < nAmino; k++)
+                sc += sub->score[seq2[j]][residue[k]] * freq[k];
+            sc *= cSeq;
+
+            if (str != 0)
+                sc += str->scoringStr(i, j + 1);
+            s[j] = sc;
+        }
+    }
 
 
     // MODIFIERS:
@@ -74,6 +74,50 @@ namespace Victor { namespace Align2{
 
         return s;
     }
+    /**
+     * Without structural scores this is a query profile: one row of
+     * template scores per residue type occurring in the target.
+     * @param n
+     * @param m
+     * @param s
+     * @param row
+     */
+    void
+    ScoringS2S::scoringMatrix(unsigned int n, unsigned int m,
+            vector<double> &s, vector<unsigned int> &row) {
+        if (str != 0) {
+            ScoringScheme::scoringMatrix(n, m, s, row);
+            return;
+        }
+
+        vector<int> residueRow(256, -1);
+        s.clear();
+        row.resize(n);
+        for (unsigned int i = 0; i < n; i++) {
+            int &r = residueRow[static_cast<unsigned char> (seq1[i])];
+            if (r < 0) {
+                r = s.size();
+                for (unsigned int j = 0; j < m; j++)
+                    s.push_back(cSeq * sub->score[seq1[i]][seq2[j]]);
+            }
+            row[i] = r;
+        }
+    }
+    /**
+     * 
+     * @param i
+     * @param m
+     * @param s
+     */
+    void
+    ScoringS2S::scoringRow(int i, unsigned int m, vector<double> &s) {
+        s.resize(m);
+        for (unsigned int j = 0; j < m; j++) {
+            s[j] = cSeq * sub->score[seq1[i - 1]][seq2[j]];
+            if (str != 0)
+                s[j] += str->scoringStr(i, j + 1);
+        }
+    }
 
 
     // MODIFIERS:
@@ -53,6 +53,13 @@ namespace Victor { namespace Align2{
         /// Calculate scores to create matrix values.
         virtual double scoring(int i, int j);
 
+        /// Calculate the scores of all n x m positions at once.
+        virtual void scoringMatrix(unsigned int n, unsigned int m,
+                vector<double> &s, vector<unsigned int> &row);
+
+        /// Calculate the scores of the m template positions of target position i.
+        virtual void scoringRow(int i, unsigned int m, vector<double> &s);
+
 
         // MODIFIERS:
 
@@ -94,6 +94,43 @@ namespace Victor { namespace Align2{
 
         return true;
     }
+    /**
+     * Fills s with rows of m scores, such that s[row[i] + j] equals
+     * scoring(i + 1, j + 1) for all 0 <= i < n, 0 <= j < m. Target
+     * positions with identical scores may share a row. Alignments call
+     * this once instead of scoring() in the inner loop of the matrix
+     * calculation, so schemes override it when the scores can be
+     * tabulated faster than cell by cell.
+     * @param n
+     * @param m
+     * @param s
+     * @param row
+     */
+    void
+    ScoringScheme::scoringMatrix(unsigned int n, unsigned int m,
+            vector<double> &s, vector<unsigned int> &row) {
+        s.resize(n * m);
+        row.resize(n);
+        for (unsigned int i = 0; i < n; i++) {
+            row[i] = i * m;
+            for (unsigned int j = 0; j < m; j++)
+                s[i * m + j] = scoring(i + 1, j + 1);
+        }
+    }
+    /**
+     * Fills s with the m scores of target position i, s[j - 1] being
+     * scoring(i, j). Used instead of scoringMatrix() when the n x m scores
+     * are not to be kept, eg. by alignments in linear space mode.
+     * @param i
+     * @param m
+     * @param s
+     */
+    void
+    ScoringScheme::scoringRow(int i, unsigned int m, vector<double> &s) {
+        s.resize(m);
+        for (unsigned int j = 0; j < m; j++)
+            s[j] = scoring(i, j + 1);
+    }
 
 
     // MODIFIERS:
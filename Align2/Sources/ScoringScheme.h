@@ -57,6 +57,13 @@ namespace Victor { namespace Align2{
         /// Calculate scores to create matrix values.
         virtual double scoring(int i, int j) = 0;
 
+        /// Calculate the scores of all n x m positions at once.
+        virtual void scoringMatrix(unsigned int n, unsigned int m,
+                vector<double> &s, vector<unsigned int> &row);
+
+        /// Calculate the scores of the m template positions of target position i.
+        virtual void scoringRow(int i, unsigned int m, vector<double> &s);
+
         /// Check if s consists only of characters defined in sub.getResidues.
         virtual bool checkSequence(const string &s) const;
 
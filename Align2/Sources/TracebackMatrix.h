@@ -0,0 +1,141 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __TracebackMatrix_H__
+#define __TracebackMatrix_H__
+
+#include <Traceback.h>
+#include <algorithm>
+#include <vector>
+
+namespace Victor { namespace Align2{
+
+    /** @brief    Traceback directions of an alignment matrix, 2 bits per cell.
+     *
+     *  The predecessor of cell (i, j) is always (i - 1, j - 1), (i, j - 1)
+     * or (i - 1, j), or there is none. Storing the direction instead of a
+     * Traceback object takes 2 bits instead of 16 bytes per cell, in one
+     * contiguous block. Bit 0 of a direction means a step back in i, bit 1
+     * a step back in j.
+     **/
+    class TracebackMatrix {
+    public:
+
+        /// Direction of the predecessor of a cell.
+
+        enum Direction {
+            INVALID = 0, ///< No predecessor.
+            UP = 1, ///< (i - 1, j): gap in the template.
+            LEFT = 2, ///< (i, j - 1): gap in the target.
+            DIAGONAL = 3 ///< (i - 1, j - 1): match.
+        };
+
+
+        // CONSTRUCTORS:
+
+        /// Default constructor.
+
+        TracebackMatrix() : nRows(0), nCols(0), rowBytes(0) {
+        }
+
+        /// Constructor allocating rows x cols invalid cells.
+
+        TracebackMatrix(unsigned int rows, unsigned int cols) {
+            resize(rows, cols);
+        }
+
+
+        // PREDICATES:
+
+        /// Return the number of rows.
+
+        unsigned int rows() const {
+            return nRows;
+        }
+
+        /// Return the number of columns.
+
+        unsigned int cols() const {
+            return nCols;
+        }
+
+        /// Return the direction of the predecessor of (i, j).
+
+        Direction getDirection(int i, int j) const {
+            return static_cast<Direction> ((data[i * rowBytes + j / 4] >> (2 * (j % 4))) & 3);
+        }
+
+        /// Return the predecessor of (i, j).
+
+        Traceback get(int i, int j) const {
+            Direction d = getDirection(i, j);
+            if (d == INVALID)
+                return Traceback::getInvalidTraceback();
+            return Traceback(i - (d & UP), j - ((d & LEFT) >> 1));
+        }
+
+
+        // MODIFIERS:
+
+        /// Set the direction of the predecessor of (i, j).
+
+        void set(int i, int j, Direction d) {
+            unsigned char &c = data[i * rowBytes + j / 4];
+            c = (c & ~(3 << (2 * (j % 4)))) | (d << (2 * (j % 4)));
+        }
+
+        /// Copy row srcRow of src, with the same number of columns, to row i.
+
+        void copyRow(int i, const TracebackMatrix &src, int srcRow) {
+            std::copy(src.data.begin() + srcRow * rowBytes,
+                    src.data.begin() + (srcRow + 1) * rowBytes,
+                    data.begin() + i * rowBytes);
+        }
+
+        /// Reallocate rows x cols invalid cells.
+
+        void resize(unsigned int rows, unsigned int cols) {
+            nRows = rows;
+            nCols = cols;
+            rowBytes = (cols + 3) / 4;
+            data.assign(nRows * rowBytes, 0);
+        }
+
+        /// Set all cells invalid.
+
+        void clear() {
+            data.assign(data.size(), 0);
+        }
+
+
+    protected:
+
+
+    private:
+
+        // ATTRIBUTES:
+
+        unsigned int nRows; ///< Number of rows.
+        unsigned int nCols; ///< Number of columns.
+        unsigned int rowBytes; ///< Bytes per row, 4 cells per byte.
+        vector<unsigned char> data; ///< Directions, row-major.
+
+    };
+
+}} // namespace
+
+#endif
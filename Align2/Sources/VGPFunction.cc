@@ -245,6 +245,7 @@ namespace Victor { namespace Align2{
         //TODO improve default assignment for unseen residues
         //define SA that will be used in case of gaps.
         //double previousSolvAcc = 0.5;
+        SolvExpos solv; // keeps the neighbour grid of the chain
 
         for (unsigned int k = 0; k < sp->sizeAmino(); k++) {
             // Helical/strand content
@@ -276,7 +277,6 @@ namespace Victor { namespace Align2{
 
             // Solvent accessibility
             try {
-                SolvExpos solv;
                 double solvAcc = solv.getSolvAccess(*sp, k, 0, sp->sizeAmino());
                 solvAccess.push_back(solvAcc);
                 //previousSolvAcc = solvAcc;
@@ -13,11 +13,16 @@
 #include <cppunit/TestCase.h>
 #include <AGPFunction.h>
 #include <ScoringS2S.h>
+#include <ScoringP2S.h>
+#include <Profile.h>
 #include <SequenceData.h>
 #include <SecSequenceData.h>
 #include <AlignmentBase.h>
 #include <Alignment.h>
 #include <NWAlign.h>
+#include <SWAlign.h>
+#include <FSAlign.h>
+#include <ScoreKernel.h>
 #include <Align.h>
 using namespace std;
 using namespace Victor;
@@ -103,6 +108,16 @@ public:
                 &TestAlign::testAlign_B));
         suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test3 - setting penalty values.",
                 &TestAlign::testAlign_C));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test4 - tabulated scores.",
+                &TestAlign::testAlign_D));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test5 - score-only kernel.",
+                &TestAlign::testAlign_E));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test6 - packed traceback directions.",
+                &TestAlign::testAlign_F));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test7 - linear space mode.",
+                &TestAlign::testAlign_G));
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestAlign>("Test8 - incremental suboptimal alignments.",
+                &TestAlign::testAlign_H));
 
         return suiteOfTests;
     }
@@ -140,4 +155,191 @@ protected:
         CPPUNIT_ASSERT((testAlign->penaltyMul== 14 )&&(testAlign->penaltyAdd== 10 ));
     }
 
+    void testAlign_D() {
+        string dataPath = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/";
+        ifstream matrixFile((dataPath + "blosum62.dat").c_str());
+        SubMatrix sub(matrixFile);
+        SequenceData sd(2, "IVKIIGREIIDSRGNPTVEAEV", "KIIGHEIMDSRGNPTVEV",
+                "target", "template");
+        ScoringS2S s2s(&sub, &sd, 0, 1.00);
+
+        // every position reads the same score as scoring()
+        vector<double> s;
+        vector<unsigned int> row;
+        s2s.scoringMatrix(22, 18, s, row);
+        CPPUNIT_ASSERT(row.size() == 22);
+        bool same = true;
+        for (unsigned int i = 0; i < 22; i++)
+            for (unsigned int j = 0; j < 18; j++)
+                if (s[row[i] + j] != s2s.scoring(i + 1, j + 1))
+                    same = false;
+        CPPUNIT_ASSERT(same);
+        CPPUNIT_ASSERT(s.size() < 22 * 18); // rows shared by residue type
+
+        AGPFunction agp(12, 3);
+        SWAlign sw(&sd, &agp, &s2s);
+        CPPUNIT_ASSERT(sw.SRow == row);
+        CPPUNIT_ASSERT(sw.getScore() > 0);
+    }
+
+    void testAlign_E() {
+        string dataPath = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/";
+        ifstream matrixFile((dataPath + "blosum62.dat").c_str());
+        SubMatrix sub(matrixFile);
+
+        // A-A scores 4, a gap of length 2 costs 12 + 3
+        SequenceData shortData(2, "AAA", "A", "target", "template");
+        ScoringS2S shortS2S(&sub, &shortData, 0, 1.00);
+        ScoreKernel shortKernel(&shortS2S, 12, 3);
+        CPPUNIT_ASSERT(shortKernel.getGlobalScore() == -11);
+        CPPUNIT_ASSERT(shortKernel.getLocalScore() == 4);
+
+        // the striped and the scalar loop agree for all lengths
+        string seq1 = "IVKIIGREIIDSRGNPTVEAEVHLEGGFVGMAAAPSGASTGSREALELRDGDKSRFLGKG";
+        string seq2 = "VTKAVAAVNGPIAQALIGKDAKDQAGIDKIMIDLDGTENKSKFGANAILAVSLANAKAAA";
+        bool same = true;
+        for (unsigned int len = 1; len <= seq2.size(); len += 3) {
+            SequenceData sd(2, seq1, seq2.substr(0, len), "target", "template");
+            ScoringS2S s2s(&sub, &sd, 0, 1.00);
+            ScoreKernel sk(&s2s, 10, 1);
+            double local = sk.getLocalScore();
+            double global = sk.getGlobalScore();
+            sk.setVectorised(false);
+            if ((local != sk.getLocalScore()) || (global != sk.getGlobalScore()))
+                same = false;
+        }
+        CPPUNIT_ASSERT(same);
+
+        // identical sequences align without gaps
+        SequenceData selfData(2, seq1, seq1, "target", "template");
+        ScoringS2S selfS2S(&sub, &selfData, 0, 1.00);
+        double diagonal = 0;
+        for (unsigned int i = 1; i <= seq1.size(); i++)
+            diagonal += selfS2S.scoring(i, i);
+        ScoreKernel selfKernel(&selfS2S, 12, 3);
+        CPPUNIT_ASSERT(selfKernel.getLocalScore() == diagonal);
+        CPPUNIT_ASSERT(selfKernel.getGlobalScore() == diagonal);
+    }
+
+    void testAlign_F() {
+        TracebackMatrix tm(3, 7);
+        CPPUNIT_ASSERT(Traceback::isInvalidTraceback(tm.get(2, 6)));
+
+        // neighbouring cells share bytes
+        for (int j = 0; j < 7; j++)
+            tm.set(2, j, static_cast<TracebackMatrix::Direction> (j % 4));
+        tm.set(1, 3, TracebackMatrix::LEFT);
+        CPPUNIT_ASSERT(Traceback::isInvalidTraceback(tm.get(2, 4)));
+        CPPUNIT_ASSERT(tm.get(2, 5) == Traceback(1, 5));
+        CPPUNIT_ASSERT(tm.get(2, 6) == Traceback(2, 5));
+        CPPUNIT_ASSERT(tm.get(2, 3) == Traceback(1, 2));
+        CPPUNIT_ASSERT(tm.get(1, 3) == Traceback(1, 2));
+        CPPUNIT_ASSERT(tm.getDirection(1, 2) == TracebackMatrix::INVALID);
+
+        // next() follows the directions back to the origin
+        Traceback tb = testAlign->B0;
+        unsigned int steps = 0;
+        while ((tb.i > 0) || (tb.j > 0)) {
+            tb = testAlign->next(tb);
+            steps++;
+        }
+        CPPUNIT_ASSERT((tb.i == 0) && (tb.j == 0));
+        CPPUNIT_ASSERT(steps == testAlign->n);
+        CPPUNIT_ASSERT(Traceback::isInvalidTraceback(testAlign->next(Traceback(0, 0))));
+    }
+
+    void testAlign_G() {
+        string dataPath = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/";
+        ifstream matrixFile((dataPath + "blosum62.dat").c_str());
+        SubMatrix sub(matrixFile);
+        SequenceData sd(2,
+                "IVKIIGREIIDSRGNPTVEAEVHLEGGFVGMAAAPSGASTGSREALELRDGDKSRFLGKG",
+                "VTKAVAAVNGPIAQALIGKDAKDQAGIDKIMIDLDGTENKSKFGANAILAVSLANAKAAA",
+                "target", "template");
+        ScoringS2S s2s(&sub, &sd, 0, 1.00);
+        AGPFunction agp(10, 1);
+
+        // same score and alignment as with the full matrix
+        NWAlign nw(&sd, &agp, &s2s);
+        NWAlign nwLinear(&sd, &agp, &s2s, true);
+        CPPUNIT_ASSERT(nwLinear.isLinearSpace() && nwLinear.F.empty());
+        CPPUNIT_ASSERT(nwLinear.getScore() == nw.getScore());
+        CPPUNIT_ASSERT(nwLinear.getMatch() == nw.getMatch());
+
+        SWAlign sw(&sd, &agp, &s2s);
+        SWAlign swLinear(&sd, &agp, &s2s, true);
+        CPPUNIT_ASSERT(swLinear.B0 == sw.B0);
+        CPPUNIT_ASSERT(swLinear.getScore() == sw.getScore());
+        CPPUNIT_ASSERT(swLinear.getMatch() == sw.getMatch());
+
+        FSAlign fs(&sd, &agp, &s2s);
+        FSAlign fsLinear(&sd, &agp, &s2s, true);
+        CPPUNIT_ASSERT(fsLinear.B0 == fs.B0);
+        CPPUNIT_ASSERT(fsLinear.getScore() == fs.getScore());
+        CPPUNIT_ASSERT(fsLinear.getMatch() == fs.getMatch());
+
+        // next() answers off the path with an invalid position
+        Traceback tb = nwLinear.B0;
+        while ((tb.i > 0) || (tb.j > 0)) {
+            CPPUNIT_ASSERT(nwLinear.next(tb) == nw.next(tb));
+            tb = nw.next(tb);
+        }
+        CPPUNIT_ASSERT(Traceback::isInvalidTraceback(nwLinear.next(Traceback(0, 0))));
+        CPPUNIT_ASSERT(Traceback::isInvalidTraceback(nwLinear.next(Traceback(0, 60))));
+
+        // profile-to-sequence scores are calculated per row, S is not kept
+        ifstream proFile((dataPath + "t0111.prof.fasta").c_str());
+        Alignment ali;
+        ali.loadFasta(proFile);
+        Profile pro;
+        pro.setProfile(ali);
+        SequenceData proData(2, ali.getTarget(),
+                "VTKAVAAVNGPIAQALIGKDAKDQAGIDKIMIDLDGTENKSKFGANAILAVSLANAKAAA",
+                "target", "template");
+        ScoringP2S p2s(&sub, &proData, 0, &pro, 1.00);
+
+        NWAlign nwP2S(&proData, &agp, &p2s);
+        NWAlign nwP2SLinear(&proData, &agp, &p2s, true);
+        CPPUNIT_ASSERT(nwP2SLinear.S.empty() && nwP2SLinear.SRow.empty());
+        CPPUNIT_ASSERT(nwP2SLinear.getScore() == nwP2S.getScore());
+        CPPUNIT_ASSERT(nwP2SLinear.getMatch() == nwP2S.getMatch());
+
+        SWAlign swP2S(&proData, &agp, &p2s);
+        SWAlign swP2SLinear(&proData, &agp, &p2s, true);
+        CPPUNIT_ASSERT(swP2SLinear.S.empty());
+        CPPUNIT_ASSERT(swP2SLinear.B0 == swP2S.B0);
+        CPPUNIT_ASSERT(swP2SLinear.getScore() == swP2S.getScore());
+        CPPUNIT_ASSERT(swP2SLinear.getMatch() == swP2S.getMatch());
+    }
+
+    void testAlign_H() {
+        string dataPath = string(getenv("VICTOR_ROOT")) + "Align2/Tests/data/";
+        ifstream matrixFile((dataPath + "blosum62.dat").c_str());
+        SubMatrix sub(matrixFile);
+        SequenceData sd(2,
+                "IVKIIGREIIDSRGNPTVEAEVHLEGGFVGMAAAPSGASTGSREALELRDGDKSRFLGKG",
+                "VTKAVAAVNGPIAQALIGKDAKDQAGIDKIMIDLDGTENKSKFGANAILAVSLANAKAAA",
+                "target", "template");
+        ScoringS2S s2s(&sub, &sd, 0, 1.00);
+        AGPFunction agp(10, 1);
+
+        // B and B0 as if the whole matrix was recalculated
+        NWAlign nw(&sd, &agp, &s2s);
+        SWAlign sw(&sd, &agp, &s2s);
+        FSAlign fs(&sd, &agp, &s2s);
+        Align *aligns[] = {&nw, &sw, &fs};
+        for (unsigned int k = 0; k < 3; k++)
+            for (unsigned int l = 0; l < 5; l++) {
+                aligns[k]->getMultiMatch();
+                TracebackMatrix b = aligns[k]->B;
+                Traceback b0 = aligns[k]->B0;
+                aligns[k]->pCalculateMatrix(false);
+                CPPUNIT_ASSERT(aligns[k]->B0 == b0);
+                for (unsigned int i = 0; i <= aligns[k]->n; i++)
+                    for (unsigned int j = 0; j <= aligns[k]->m; j++)
+                        CPPUNIT_ASSERT(aligns[k]->B.getDirection(i, j)
+                            == b.getDirection(i, j));
+            }
+    }
+
 };
@@ -0,0 +1,255 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**  
+@Description Measures the time needed to load PDB files, eg. large
+ multi-chain assemblies or NMR ensembles. With --parse it measures the
+ ATOM/HETATM record parser alone, in lines per second, against the
+ substring based parsing formerly used by PdbLoader. With --memory it
+ reports the heap bytes and allocations per loaded atom. */
+#include <string>
+#include <ctime>
+#include <cstdlib>
+#include <new>
+#include <GetArg.h>
+#include <PdbLoader.h>
+#include <PdbAtomRecord.h>
+#include <Protein.h>
+#include <IoTools.h>
+
+using namespace Victor;
+using namespace Victor::Biopool;
+
+// Heap accounting for --memory: the size of every block is kept in 
+// front of it, so that live bytes can be followed.
+static const size_t HEADER = 16; // keeps the blocks 16 byte aligned
+static size_t heapBytes = 0; // bytes currently allocated
+static size_t heapAllocs = 0; // allocations so far
+
+void* operator new(size_t n) throw(std::bad_alloc) {
+  size_t* p = static_cast<size_t*>(malloc(n + HEADER));
+  if (p == NULL)
+    throw std::bad_alloc();
+  *p = n;
+  heapBytes += n;
+  heapAllocs++;
+  return reinterpret_cast<char*>(p) + HEADER;
+}
+
+void operator delete(void* q) throw() {
+  if (q == NULL)
+    return;
+  size_t* p = reinterpret_cast<size_t*>(static_cast<char*>(q) - HEADER);
+  heapBytes -= *p;
+  free(p);
+}
+
+void sShowHelp(){
+  cout << "PDB Load Benchmark\n"
+       << " Options: \n"
+       << "\t-i <filename> [<filename> ...] \t Input PDB files\n"
+       << "\t[-n <num>] \t\t Repetitions per file (def = 5)\n"
+       << "\t[--all] \t\t Load all chains (def = first chain)\n"
+       << "\t[--hydrogens] \t\t Load and add H atoms (def = heavy atoms only)\n"
+       << "\t[--coordinates] \t Load coordinates only (no connection, H atoms, secondary)\n"
+       << "\t[--memory] \t\t Report heap bytes and allocations per atom\n"
+       << "\t[--parse] \t\t Time the atom record parser only (lines/s)\n"
+       << "\n";
+}
+
+/// loads fileName into prot
+void sLoad(const string& fileName, bool all, bool hyd, bool coordsOnly,
+Protein& prot){
+  ifstream inFile(fileName.c_str());
+  if (!inFile)
+    ERROR("File not found.", exception);
+  PdbLoader pl(inFile);
+  pl.setNoVerbose();
+  pl.setPermissive();
+  if (!hyd)
+    pl.setNoHAtoms();
+  if (all)
+    pl.setAllChains();
+  if (coordsOnly)
+    pl.setCoordinatesOnly();
+  prot.load(pl);
+}
+
+/// number of atoms in the residues and ligands of prot
+unsigned long sCountAtoms(Protein& prot){
+  unsigned long atoms = 0;
+  for (unsigned int c = 0; c < prot.sizeProtein(); c++) {
+      Spacer* sp = prot.getSpacer(c);
+      for (unsigned int i = 0; i < sp->sizeAmino(); i++)
+	atoms += sp->getAmino(i).size() + sp->getAmino(i).getSideChain().size();
+      LigandSet* ls = prot.getLigandSet(c);
+      if (ls != NULL)
+	for (unsigned int i = 0; i < ls->sizeLigand(); i++)
+	  atoms += ls->getLigand(i).size();
+    }
+  return atoms;
+}
+
+/// average seconds per load of fileName; sets the number of chains and residues
+double sTime(const string& fileName, unsigned int num, bool all, bool hyd,
+bool coordsOnly, unsigned int& chains, unsigned int& residues){
+  clock_t start = clock();
+  for (unsigned int i = 0; i < num; i++) {
+      Protein prot;
+      sLoad(fileName, all, hyd, coordsOnly, prot);
+
+      chains = prot.sizeProtein();
+      residues = 0;
+      for (unsigned int c = 0; c < chains; c++)
+	residues += prot.getSpacer(c)->sizeAmino();
+    }
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC / num;
+}
+
+/// heap bytes kept and allocations made per atom when loading fileName
+void sMemory(const string& fileName, bool all, bool hyd, bool coordsOnly,
+unsigned long& atoms, double& bytes, double& allocs){
+  Protein* prot = new Protein();
+  size_t startBytes = heapBytes;
+  size_t startAllocs = heapAllocs;
+  sLoad(fileName, all, hyd, coordsOnly, *prot);
+  atoms = sCountAtoms(*prot);
+  bytes = (atoms > 0) ? static_cast<double>(heapBytes - startBytes) / atoms : 0.0;
+  allocs = (atoms > 0) ? static_cast<double>(heapAllocs - startAllocs) / atoms : 0.0;
+  delete prot;
+}
+
+/// ATOM/HETATM lines of fileName
+vector<string> sReadAtomLines(const string& fileName){
+  ifstream inFile(fileName.c_str());
+  if (!inFile)
+    ERROR("File not found.", exception);
+  vector<string> lines;
+  string line;
+  while (getline(inFile, line))
+    if ((line.compare(0, 6, "ATOM  ") == 0) 
+	|| (line.compare(0, 6, "HETATM") == 0))
+      lines.push_back(line);
+  return lines;
+}
+
+/// substring based parse of an atom line, as PdbLoader used to do it
+double sParseSubstr(const string& atomLine){
+  int atNum = stoiDEF(atomLine.substr(6, 5));
+  int aaNum = stoiDEF(atomLine.substr(22, 4));
+  char altAaID = atomLine.substr(26, 1)[0];
+  vgVector3<double> coord;
+  coord.x = stodDEF(atomLine.substr(30, 8));
+  coord.y = stodDEF(atomLine.substr(38, 8));
+  coord.z = stodDEF(atomLine.substr(46, 8));
+  double bfac = 0.0;
+  if ((atomLine.length() >= 66) && (atomLine.substr(60, 6) != "      "))
+    bfac = stodDEF(atomLine.substr(60, 6));
+  string atType = "";
+  for (int i = 11; i < 17; i++)
+    if (atomLine[i] != ' ')
+      atType.append(atomLine.substr(i, 1));
+  string aaType = "";
+  for (int i = 17; i < 20; i++)
+    if (atomLine[i] != ' ')
+      aaType.append(atomLine.substr(i, 1));
+  return atNum + aaNum + altAaID + coord.x + coord.y + coord.z + bfac 
+    + atType.size() + aaType.size();
+}
+
+/// average seconds per pass over lines; recordParser selects PdbAtomRecord
+double sTimeParse(const vector<string>& lines, unsigned int num, 
+bool recordParser, double& checksum){
+  PdbAtomRecord record;
+  checksum = 0.0;
+  clock_t start = clock();
+  for (unsigned int i = 0; i < num; i++)
+    for (unsigned int l = 0; l < lines.size(); l++)
+      if (recordParser) {
+	  record.parse(lines[l].c_str(), lines[l].size());
+	  checksum += record.serial + record.resSeq + record.iCode 
+	    + record.coords.x + record.coords.y + record.coords.z + record.bFac
+	    + strlen(record.atomName) + strlen(record.resName);
+	}
+      else
+	checksum += sParseSubstr(lines[l]);
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC / num;
+}
+
+
+int main(int nArgs, char* argv[]){ 
+  if (getArg( "h", nArgs, argv))  {
+      sShowHelp();
+      return 1;
+    };
+  vector<string> inputFiles;
+  unsigned int num;
+  getArg( "i", inputFiles, nArgs, argv);
+  getArg( "n", num, nArgs, argv, 5);
+  bool all = getArg( "-all", nArgs, argv);
+  bool hyd = getArg( "-hydrogens", nArgs, argv);
+  bool parse = getArg( "-parse", nArgs, argv);
+  bool coordsOnly = getArg( "-coordinates", nArgs, argv);
+  bool memory = getArg( "-memory", nArgs, argv);
+  if (inputFiles.size() == 0)  {
+      cout << "Missing file specification. Aborting. (-h for help)" << endl;
+      return -1;
+    }
+  if (num == 0)
+    num = 1;
+
+  if (parse) {
+      cout << "file\tlines\tsubstr (lines/s)\trecord (lines/s)\tspeedup\n";
+      for (unsigned int f = 0; f < inputFiles.size(); f++) {
+	  vector<string> lines = sReadAtomLines(inputFiles[f]);
+	  double sumOld, sumNew;
+	  double tOld = sTimeParse(lines, num, false, sumOld);
+	  double tNew = sTimeParse(lines, num, true, sumNew);
+	  if (fabs(sumOld - sumNew) > 1e-6 * fabs(sumOld))
+	    cerr << "Warning: parsers disagree on " << inputFiles[f] << "\n";
+	  cout << inputFiles[f] << "\t" << lines.size() << "\t" 
+	       << setprecision(4) << (tOld > 0 ? lines.size() / tOld : 0.0) 
+	       << "\t" << (tNew > 0 ? lines.size() / tNew : 0.0) << "\t" 
+	       << (tNew > 0 ? tOld / tNew : 0.0) << "\n";
+	}
+      return 0;
+    }
+
+  if (memory) {
+      cout << "file\tatoms\tbytes/atom\tallocations/atom\n";
+      for (unsigned int f = 0; f < inputFiles.size(); f++) {
+	  unsigned long atoms;
+	  double bytes, allocs;
+	  sMemory(inputFiles[f], all, hyd, coordsOnly, atoms, bytes, allocs);
+	  cout << inputFiles[f] << "\t" << atoms << "\t" << setprecision(4) 
+	       << bytes << "\t" << allocs << "\n";
+	}
+      return 0;
+    }
+
+  cout << "file\tsize (kB)\tchains\tresidues\tload (s)\tMB/s\n";
+  for (unsigned int f = 0; f < inputFiles.size(); f++) {
+      ifstream inFile(inputFiles[f].c_str(), ios::binary | ios::ate);
+      double kB = static_cast<double>(inFile.tellg()) / 1024;
+      unsigned int chains = 0, residues = 0;
+      double t = sTime(inputFiles[f], num, all, hyd, coordsOnly, chains, 
+		       residues);
+      cout << inputFiles[f] << "\t" << setprecision(6) << kB << "\t" 
+	   << chains << "\t" << residues << "\t" << setprecision(4) << t 
+	   << "\t" << (t > 0 ? kB / 1024 / t : 0.0) << "\n";
+    }
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**  
+@Description Measures the cost of Spacer::getAmino() on a long chain built
+ by repeating the residues of a PDB file. */
+#include <string>
+#include <ctime>
+#include <cstdlib>
+#include <GetArg.h>
+#include <PdbLoader.h>
+#include <Protein.h>
+
+using namespace Victor;
+using namespace Victor::Biopool;
+
+void sShowHelp(){
+  cout << "Spacer Benchmark\n"
+       << " Options: \n"
+       << "\t-i <filename> \t\t Input PDB file\n"
+       << "\t[-l <num>] \t\t Residues in the chain (def = 1000)\n"
+       << "\t[-n <num>] \t\t Sweeps over the chain (def = 100)\n"
+       << "\t[-s <num>] \t\t Split the chain in sub-spacers of <num> residues\n"
+       << "\n";
+}
+
+/// average nanoseconds per getAmino() call over num sweeps of sp
+double sTimeSweep(Spacer& sp, unsigned int num, unsigned long& check){
+  clock_t start = clock();
+  for (unsigned int i = 0; i < num; i++)
+    for (unsigned int j = 0; j < sp.sizeAmino(); j++)
+      check += sp.getAmino(j).size();
+  return 1e9 * static_cast<double>(clock() - start) / CLOCKS_PER_SEC 
+    / (static_cast<double>(num) * sp.sizeAmino());
+}
+
+/// same as sTimeSweep, in random order
+double sTimeRandom(Spacer& sp, unsigned int num, unsigned long& check){
+  vector<unsigned int> order(sp.sizeAmino());
+  srand(1);
+  for (unsigned int j = 0; j < order.size(); j++)
+    order[j] = rand() % order.size();
+  clock_t start = clock();
+  for (unsigned int i = 0; i < num; i++)
+    for (unsigned int j = 0; j < order.size(); j++)
+      check += sp.getAmino(order[j]).size();
+  return 1e9 * static_cast<double>(clock() - start) / CLOCKS_PER_SEC 
+    / (static_cast<double>(num) * sp.sizeAmino());
+}
+
+
+int main(int nArgs, char* argv[]){ 
+  if (getArg( "h", nArgs, argv))  {
+      sShowHelp();
+      return 1;
+    };
+  string inputFile;
+  unsigned int len, num, split;
+  getArg( "i", inputFile, nArgs, argv, "!");
+  getArg( "l", len, nArgs, argv, 1000);
+  getArg( "n", num, nArgs, argv, 100);
+  getArg( "s", split, nArgs, argv, 0);
+  if (inputFile == "!")  {
+      cout << "Missing file specification. Aborting. (-h for help)" << endl;
+      return -1;
+    }
+  if (num == 0)
+    num = 1;
+
+  ifstream inFile(inputFile.c_str());
+  if (!inFile)
+    ERROR("File not found.", exception);
+  PdbLoader pl(inFile);
+  pl.setNoHAtoms();
+  pl.setNoVerbose();
+  pl.setPermissive();
+  Protein prot;
+  prot.load(pl);
+  Spacer& orig = *prot.getSpacer(static_cast<unsigned int>(0));
+  if (orig.sizeAmino() == 0)
+    ERROR("No residues found.", exception);
+
+  Spacer sp;
+  for (unsigned int i = 0; i < len; i++)
+    sp.insertComponent(orig.getAmino(i % orig.sizeAmino()).clone());
+  if (split > 0)
+    for (unsigned int c = 0; c < sp.size(); c++) {
+	unsigned int end = c + split - 1;
+	if (end >= sp.size())
+	  end = sp.size() - 1;
+	sp.splitSpacer(c, end);
+      }
+
+  unsigned long check = 0;
+  double tSweep = sTimeSweep(sp, num, check);
+  double tRandom = sTimeRandom(sp, num, check);
+  cout << "residues\tsub-spacers\tsweep (ns/call)\trandom (ns/call)\n"
+       << sp.sizeAmino() << "\t" << sp.sizeSpacer() << "\t" 
+       << setprecision(4) << tSweep << "\t" << tRandom << "\n";
+  if (check == 0)
+    cout << "No residues were read.\n";
+
+  return 0;
+}
@@ -17,8 +17,10 @@
 // Includes:
 
 #include <AminoAcidHydrogen.h>
+#include <ThreadTools.h>
 #include <IntCoordConverter.h>
 #include <IoTools.h>
+#include <EmbeddedData.h>
 #include <vector>
 
 
@@ -28,14 +30,51 @@ using namespace Victor; using namespace Victor::Biopool;
 using namespace Victor::Biopool;
 double BOND_LENGTH_H_TO_ALL = 1.00;
 map<AminoAcidCode, vector<vector<string> > > AminoAcidHydrogen::paramH;
+string AminoAcidHydrogen::paramFile;
+bool AminoAcidHydrogen::paramLoaded = false;
+static Mutex paramMutex; // loaders may run in parallel threads
+
+namespace Victor {
+    extern const EmbeddedData EMBEDDED_AMINOACIDHYDROGEN; // data/AminoAcidHydrogenData.txt
+}
+
+/**
+ *    Loads the AminoAcidHydrogenData.txt table compiled into the library,
+ *    unless a table was already loaded (eg. a custom file, see below).
+ *@param   none
+ *@return  void
+ */
+void
+AminoAcidHydrogen::loadParam() {
+    MutexLock lock(paramMutex);
+    if (paramLoaded)
+        return;
+
+    for (unsigned int i = 0; i < EMBEDDED_AMINOACIDHYDROGEN.sizeLines; i++) {
+        string line = EMBEDDED_AMINOACIDHYDROGEN.lines[i];
+        // as readLine(): no leading white space, no comments or empty lines
+        string::size_type first = line.find_first_not_of(" \t");
+        if ((first == string::npos) || (line[first] == '#'))
+            continue;
+        pAddParamLine(line.substr(first));
+    }
+    paramFile = "";
+    paramLoaded = true;
+}
 
 /**
  *    Load a file "AminoAcidHydrogenData.txt", containing angles and reference atoms to build hydrogens. 
+ *    Nothing is done if the same file was already loaded.
  *@param   string inputFile name
  *@return  void
  */
 void
 AminoAcidHydrogen::loadParam(string inputFile) {
+    MutexLock lock(paramMutex);
+    if (paramLoaded && (inputFile == paramFile))
+        return;
+    paramH.clear();
+
     ifstream input(inputFile.c_str());
     if (!input)
         ERROR("File not found.", exception);
@@ -43,39 +82,18 @@ AminoAcidHydrogen::loadParam(string inputFile) {
     input.clear(); // reset file to previous content 
     input.seekg(0, ios::beg);
 
-    string tok = "";
-    vector<string> tokens; // One parsed line splitted by white spaces
-    AminoAcidCode aaCode;
-
     string line;
     line = readLine(input); // header
     //line = readLine(input);
     // read all lines
     do {
-        if (line[0] != '#') {
-            for (unsigned int i = 0; i < line.size(); i++) {
-                if (line[i] == ' ') {
-                    tokens.push_back(tok);
-                    tok.clear();
-                } else {
-                    tok += line[i];
-                }
-            }
-            // last tok
-            tokens.push_back(tok);
-            tok.clear();
-
-            aaCode = aminoAcidThreeLetterTranslator(tokens.front());
-
-            if (paramH.find(aaCode) == paramH.end()) {
-                paramH[aaCode] = vector<vector<string > >();
-            }
-            paramH[aaCode].push_back(tokens);
-            tokens.clear();
-        }
+        if (line[0] != '#')
+            pAddParamLine(line);
 
         line = readLine(input);
     } while (input);
+    paramFile = inputFile;
+    paramLoaded = true;
 
     /*
     for (unsigned int i=0; i<paramH[aaCode].size();i++){
@@ -86,6 +104,34 @@ AminoAcidHydrogen::loadParam(string inputFile) {
 
 }
 
+/**
+ *    Adds a line of the table, split by white spaces, to the parameters.
+ *@param   line (string)
+ *@return  void
+ */
+void
+AminoAcidHydrogen::pAddParamLine(const string& line) {
+    string tok = "";
+    vector<string> tokens; // One parsed line splitted by white spaces
+    for (unsigned int i = 0; i < line.size(); i++) {
+        if (line[i] == ' ') {
+            tokens.push_back(tok);
+            tok.clear();
+        } else {
+            tok += line[i];
+        }
+    }
+    // last tok
+    tokens.push_back(tok);
+
+    AminoAcidCode aaCode = aminoAcidThreeLetterTranslator(tokens.front());
+
+    if (paramH.find(aaCode) == paramH.end()) {
+        paramH[aaCode] = vector<vector<string > >();
+    }
+    paramH[aaCode].push_back(tokens);
+}
+
 /**
  *    Add Hydrogen to an AminoAcid
  *@param   One AminoAcid pointer
@@ -108,7 +154,11 @@ AminoAcidHydrogen::setHydrogen(AminoAcid* aa, bool verbose) {
 
     }
 
-    vector<vector<string > > paramList = paramH[aaCode];
+    vector<vector<string > > paramList;
+    map<AminoAcidCode, vector<vector<string> > >::const_iterator it =
+            paramH.find(aaCode);
+    if (it != paramH.end())
+        paramList = it->second;
     vector<string> args;
 
 
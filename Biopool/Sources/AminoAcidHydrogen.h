@@ -35,12 +35,17 @@ namespace Victor { namespace Biopool {
     class AminoAcidHydrogen {
     public:
 
+        static void loadParam();
         static void loadParam(string inputFile);
         static void setHydrogen(AminoAcid* aa, bool verbose);
 
     private:
 
+        static void pAddParamLine(const string& line);
+
         static map<AminoAcidCode, vector<vector<string> > > paramH;
+        static string paramFile; // file paramH was loaded from, "" = built-in
+        static bool paramLoaded;
 
     };
 
@@ -25,6 +25,7 @@
 
 using namespace Victor; using namespace Victor::Biopool;
 
+unsigned long Atom::modificationCount = 0;
 
 // CONSTRUCTORS/DESTRUCTOR:
 
@@ -33,8 +34,8 @@ using namespace Victor; using namespace Victor::Biopool;
  * @param Number of in Bonds (unsigned int), number of out Bonds (unsigned Int)
  */
 Atom::Atom(unsigned int mI, unsigned int mO) : SimpleBond(mI, mO),
-superior(NULL), type(X), coords(0, 0, 0), Bfac(0.0), trans(0, 0, 0), rot(1),
-modified(false), asymId('X'), entityId("0"), occupancy(0.0), model(0) {
+superior(NULL), coords(0, 0, 0), Bfac(0.0), entityId("0"), occupancy(0.0),
+trans(0, 0, 0), rot(1), type(X), model(0), asymId('X'), modified(false) {
     PRINT_NAME;
 }
 
@@ -126,22 +127,7 @@ void
 Atom::copy(const Atom& orig) {
     PRINT_NAME;
     SimpleBond::copy(orig);
-
-    setNumber(orig.getNumber());
-
-    superior = orig.superior;
-    type = orig.type;
-    coords = orig.coords;
-    Bfac = orig.Bfac;
-    
-    asymId = orig.asymId;
-    entityId = orig.entityId;
-    occupancy = orig.occupancy;
-    model = orig.model;
-
-    trans = orig.trans;
-    rot = orig.rot;
-    modified = orig.modified;
+    pCopyAttributes(orig);
 }
 
 /**
@@ -187,6 +173,7 @@ Atom::setModified() {
     if (modified)
         return;
     modified = true;
+    __sync_add_and_fetch(&modificationCount, 1);
 
     for (unsigned int i = 0; i < sizeOutBonds(); i++)
         getOutBond(i).setModified();
@@ -202,6 +189,16 @@ Atom::setUnModified() {
     modified = false;
 }
 
+/**
+ *   Counts a modification without changing any atom, eg. when atoms are 
+ *   moved to another structure. Data cached against 
+ *   getModificationCount() becomes invalid.
+ */
+void
+Atom::addModification() {
+    __sync_add_and_fetch(&modificationCount, 1);
+}
+
 
 // OPERATORS:
 
@@ -209,14 +206,55 @@ Atom&
         Atom::operator=(const Atom& orig) {
     PRINT_NAME;
 
-    if (&orig != this)
+    if (&orig != this) {
+        Group* old = ((superior != NULL) && (type != orig.type)) ? superior : NULL;
         copy(orig);
+        if (old != NULL) // an atom of old was overwritten with another code
+            old->pIndexAtoms();
+    }
     return *this;
 }
 
 
 // HELPERS:
 
+/**
+ *   Called when the code of an atom belonging to a Group changed, so
+ *   that the Group can update its atom index.
+ */
+void
+Atom::pCodeChanged() {
+    superior->pIndexAtoms();
+}
+
+/**
+ *   Copies all attributes of orig except its bonds, which are left 
+ *   unchanged in both atoms.
+ * @param orig (const Atom&)
+ */
+void
+Atom::pCopyAttributes(const Atom& orig) {
+    maxIn = orig.maxIn;
+    maxOut = orig.maxOut;
+    id = orig.id;
+    setNumber(orig.getNumber()); // not copied by Identity::operator=
+
+    superior = orig.superior;
+    type = orig.type;
+    coords = orig.coords;
+    Bfac = orig.Bfac;
+    
+    asymId = orig.asymId;
+    entityId = orig.entityId;
+    occupancy = orig.occupancy;
+    model = orig.model;
+
+    trans = orig.trans;
+    rot = orig.rot;
+    modified = orig.modified;
+    __sync_add_and_fetch(&modificationCount, 1);
+}
+
 /**
  *   Propagate the "rot" matrix to all the outbonds. 
  * The "rot" of this atom is multiplied with the "rot" of the out atom.
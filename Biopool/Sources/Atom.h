@@ -37,6 +37,7 @@ namespace Victor { namespace Biopool {
      * NB: Angles are in degrees.
      **/
     class Atom : public SimpleBond {
+        friend class Group;
     public:
 
         // CONSTRUCTORS/DESTRUCTOR:
@@ -68,6 +69,7 @@ namespace Victor { namespace Biopool {
         vgVector3<double> getTrans() const;
         vgMatrix3<double> getRot() const;
         virtual bool inSync(); // coords in-sync with changes?
+        static unsigned long getModificationCount();
 
         // MODIFIERS:
         void clear();
@@ -107,6 +109,7 @@ namespace Victor { namespace Biopool {
         void setSuperior(Group* gr);
         void setModified();
         void setUnModified(); //used in Qmean: this flag cause problem there.
+        static void addModification(); // invalidates data cached for atoms
 
         // OPERATORS:
         Atom& operator=(const Atom& orig);
@@ -118,23 +121,29 @@ namespace Victor { namespace Biopool {
         // HELPERS: 
         bool isNotFirstAtomInStructure();
         void propagateRotation(); // pass on rotation matrix to following atoms
+        void pCodeChanged(); // lets the superior update its atom index
+        void pCopyAttributes(const Atom& orig); // copy() without the bonds
 
 
         // ATTRIBUTES:
+        // (small members are grouped at the end to avoid padding)
         Group* superior; // structure to which atom belongs,
-        AtomCode type; // Atom type
         vgVector3<double> coords; // xyz-Coords
 
         double Bfac; // B-factor
 	
-	char asymId;
 	string entityId;
 	double occupancy;
-	int model;
 
         vgVector3<double> trans; // relative translation
         vgMatrix3<double> rot; // relative rotation
+
+        AtomCode type; // Atom type
+	int model;
+	char asymId;
         bool modified; // --""--  modified?  
+
+        static unsigned long modificationCount; // atoms marked as modified so far
     };
 
 
@@ -193,6 +202,17 @@ namespace Victor { namespace Biopool {
     Atom::inSync() {
         return (!modified);
     }
+
+    /**
+     *   Number of times an atom, in any structure, was marked as modified or
+     *   overwritten. Data derived from coordinates can store it and is out
+     *   of date once it changed.
+     * @return the counter (unsigned long)
+     */
+    inline unsigned long
+    Atom::getModificationCount() {
+        return modificationCount;
+    }
     
     inline char Atom::getAsymId() {
 	return asymId;
@@ -245,14 +265,20 @@ namespace Victor { namespace Biopool {
 
     inline void
     Atom::setType(string _name) {
+        AtomCode old = type;
         id.setName(_name);
         type = AtomTranslator(_name);
+        if ((type != old) && (superior != NULL))
+            pCodeChanged();
     }
 
     inline void
     Atom::setCode(AtomCode ac) {
+        AtomCode old = type;
         type = ac;
         id.setName(AtomTranslator(ac));
+        if ((type != old) && (superior != NULL))
+            pCodeChanged();
     }
 
     inline void
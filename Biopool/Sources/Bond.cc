@@ -23,8 +23,6 @@ using namespace Victor; using namespace Victor::Biopool;
 Bond::Bond(unsigned int mI, unsigned int mO) : SimpleBond(mI, mO),
 inRef(), outRef() {
     PRINT_NAME;
-    inRef.reserve(mI);
-    outRef.reserve(mO);
 }
 
 Bond::Bond(const Bond& orig) {
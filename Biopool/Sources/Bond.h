@@ -76,7 +76,7 @@ namespace Victor { namespace Biopool {
         virtual void pUnbindOut(Bond& c, bool unbind = false);
 
         // ATTRIBUTES:
-        vector<Atom*> inRef, outRef;
+        BondList<Atom, 2> inRef, outRef;
         // reference to the atom containg the in- and out-bonds
 
     };
@@ -0,0 +1,155 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _BONDLIST_H_
+#define _BONDLIST_H_
+
+// Includes:
+#include <algorithm>
+
+namespace Victor { namespace Biopool {
+
+    /**
+     * @brief List of bond partners with room for N pointers inside the
+     * object.
+     *
+     *  Used by SimpleBond and Bond instead of vector, which needed two heap
+     * blocks for every atom (and every temporary atom) created. Lists with
+     * more than N entries move to the heap. Supports the subset of the
+     * vector interface used by the bond classes; erase() keeps the order
+     * and does not invalidate iterators before the erased position.
+     * */
+    template <class T, unsigned int N>
+    class BondList {
+    public:
+        typedef T** iterator;
+        typedef T* const* const_iterator;
+
+        // CONSTRUCTORS/DESTRUCTOR:
+
+        BondList() : count(0), capacity(N) {
+        }
+
+        BondList(const BondList& orig) : count(0), capacity(N) {
+            pAssign(orig);
+        }
+
+        ~BondList() {
+            if (capacity > N)
+                delete [] heap;
+        }
+
+        // PREDICATES:
+
+        unsigned int size() const {
+            return count;
+        }
+
+        bool empty() const {
+            return (count == 0);
+        }
+
+        T*& operator[](unsigned int n) {
+            return begin()[n];
+        }
+
+        T* const& operator[](unsigned int n) const {
+            return begin()[n];
+        }
+
+        T*& front() {
+            return begin()[0];
+        }
+
+        iterator begin() {
+            return (capacity > N) ? heap : local;
+        }
+
+        iterator end() {
+            return begin() + count;
+        }
+
+        const_iterator begin() const {
+            return (capacity > N) ? heap : local;
+        }
+
+        const_iterator end() const {
+            return begin() + count;
+        }
+
+        // MODIFIERS:
+
+        void push_back(T* p) {
+            if (count == capacity)
+                pGrow();
+            begin()[count++] = p;
+        }
+
+        void pop_back() {
+            count--;
+        }
+
+        iterator erase(iterator pos) {
+            std::copy(pos + 1, end(), pos);
+            count--;
+            return pos;
+        }
+
+        void clear() {
+            count = 0;
+        }
+
+        // OPERATORS:
+
+        BondList& operator=(const BondList& orig) {
+            if (&orig != this) {
+                count = 0;
+                pAssign(orig);
+            }
+            return *this;
+        }
+
+    private:
+
+        // HELPERS:
+
+        void pAssign(const BondList& orig) {
+            for (unsigned int i = 0; i < orig.count; i++)
+                push_back(orig[i]);
+        }
+
+        void pGrow() {
+            T** tmp = new T*[2 * capacity];
+            std::copy(begin(), end(), tmp);
+            if (capacity > N)
+                delete [] heap;
+            heap = tmp;
+            capacity *= 2;
+        }
+
+        // ATTRIBUTES:
+        union {
+            T* local[N]; // storage for up to N entries
+            T** heap; // used once capacity exceeds N
+        };
+        unsigned int count;
+        unsigned int capacity;
+    };
+
+}} //namespace
+#endif //_BONDLIST_H_
@@ -395,12 +395,7 @@ void CifLoader::loadProtein(Protein& prot) {
     helixCode = "";
     sheetCode = "";
 
-    string path = "data/AminoAcidHydrogenData.txt";
-    const char* inputFile = getenv("VICTOR_ROOT");
-    if (inputFile == NULL)
-        ERROR("Environment variable VICTOR_ROOT was not found.", exception);
-
-    AminoAcidHydrogen::loadParam(((string) inputFile + path).c_str());
+    AminoAcidHydrogen::loadParam(); // built-in table, unless one was loaded
 
     for (unsigned int i = 0; i < chainList.size(); i++) {
         loadChain = false;
@@ -634,16 +629,17 @@ void CifLoader::loadProtein(Protein& prot) {
                     if (verbose) {
                         cout << "Connected residues\n";
                     }
-                }
 
-                // correct position of leading N atom
-                sp->setTrans(sp->getAmino(0)[N].getTrans());
-                vgVector3<double> tmp(0.0, 0.0, 0.0);
-                sp->getAmino(0)[N].setTrans(tmp);
-                sp->getAmino(0).adjustLeadingN();
-                if (verbose) {
-                    cout << "Fixed leading N atom\n";
-		}
+                    // correct position of leading N atom
+                    // (unconnected atoms keep their absolute coordinates)
+                    sp->setTrans(sp->getAmino(0)[N].getTrans());
+                    vgVector3<double> tmp(0.0, 0.0, 0.0);
+                    sp->getAmino(0)[N].setTrans(tmp);
+                    sp->getAmino(0).adjustLeadingN();
+                    if (verbose) {
+                        cout << "Fixed leading N atom\n";
+                    }
+                }
                 // Add H atoms
                 if (!noHAtoms) {
                     for (unsigned int j = 0; j < sp->sizeAmino(); j++) {
@@ -92,6 +92,7 @@ namespace Victor {
             void setWithSecondary();
             void setNoConnection();
             void setWithConnection();
+            void setCoordinatesOnly(); // no connection, H atoms or secondary
             void setWater();
             void setAllChains();
 
@@ -193,6 +194,18 @@ namespace Victor {
             noConnection = false;
         }
 
+        /**
+         * Loads the atoms with their absolute coordinates only: residues
+         * are not connected and no H atoms or secondary structure are
+         * added. Torsion angles and internal coordinate editing need a
+         * connected chain.
+         */
+        inline void CifLoader::setCoordinatesOnly() {
+            noConnection = true;
+            noHAtoms = true;
+            noSecondary = true;
+        }
+
         inline void CifLoader::setAllChains() {
             allChains = true;
         }
@@ -19,15 +19,19 @@
 #include <IoTools.h>
 #include <limits.h>
 #include <float.h>
+#include <cstring>
 
 // Global constants, typedefs, etc. (to avoid):
 
 using namespace Victor; using namespace Victor::Biopool;
 
+bool Group::useAtomIndex = true;
+
 // CONSTRUCTORS/DESTRUCTOR:
 
 Group::Group(unsigned int mI, unsigned int mO) : Monomer(mI, mO),
 atoms(), trans(0, 0, 0), rot(1) {
+    pIndexAtoms();
 }
 
 Group::Group(const Group& orig) {
@@ -97,6 +101,7 @@ Group::removeAtom(Atom& a) {
         else
             atoms.erase(iter);
     }
+    pIndexAtoms();
 }
 
 
@@ -113,23 +118,26 @@ Group::copy(const Group& orig) {
 
     while (atoms.size() > 0)
         atoms.pop_back();
-    // this solution is not perfectly clean, 
-    // but avoids orig getting stripped of its bonds
-    // unfortunately there's no (obvious) better solution.
-    // this has no bonds after this operation (they will be added below)
+    // the atoms are copied without their bonds, so that orig keeps its 
+    // bonds unchanged (Atom::copy() would move them to the copy)
+    atoms.reserve(orig.atoms.size());
     for (unsigned int i = 0; i < orig.atoms.size(); i++) {
-        atoms.push_back(orig.atoms[i]);
-        const_cast<Atom&> (orig.atoms[i]) = atoms[atoms.size() - 1];
+        atoms.push_back(Atom());
+        atoms.back().pCopyAttributes(orig.atoms[i]);
     }
 
-    // copy all bonds
-    for (unsigned int i = 0; i < size(); i++)
-        for (unsigned int j = 0; j < orig[i].sizeOutBonds(); j++) {
-            unsigned int tmp = orig.pGetIndex(orig[i].getOutBond(j).getNumber());
-            // in order to copy all bonds from orig the index has to be computed 
-            if (tmp < atoms.size())
-                (*this)[i].bindOut((*this)[tmp]);
-        }
+    // copy the bonds between atoms of the group: the position of the 
+    // partner in orig.atoms is the position of the new partner
+    if (orig.atoms.size() > 0) {
+        const Atom* first = &orig.atoms[0];
+        const Atom* last = first + orig.atoms.size();
+        for (unsigned int i = 0; i < size(); i++)
+            for (unsigned int j = 0; j < orig[i].sizeOutBonds(); j++) {
+                const Atom* partner = &orig[i].getOutBond(j);
+                if ((partner >= first) && (partner < last))
+                    (*this)[i].bindOut((*this)[partner - first]);
+            }
+    }
 
     trans = orig.trans;
     rot = orig.rot;
@@ -142,6 +150,7 @@ Group::copy(const Group& orig) {
     // let superior reference new group:
     for (unsigned int i = 0; i < atoms.size(); i++)
         atoms[i].Atom::setSuperior(this);
+    pIndexAtoms();
 }
 /**
  *   Synchronizes coords with structure
@@ -170,6 +179,12 @@ Group::addAtom(Atom& a) {
     PRINT_NAME;
     atoms.push_back(a);
     atoms[atoms.size() - 1].Atom::setSuperior(this);
+    AtomCode ac = a.getCode();
+    if (indexed && (atoms.size() <= MAX_INDEXED_ATOMS) && (ac < ATOM_CODE_SIZE)) {
+        if (atomIndex[ac] == 0)
+            atomIndex[ac] = atoms.size();
+    } else
+        pIndexAtoms();
 
     for (unsigned int j = 0; j < 3; j++)
         if (a.getCoords()[j] < lowerBound[j])
@@ -198,6 +213,10 @@ Group&
  */
 Atom*
 Group::pGetAtom(const AtomCode& ac) const {
+    if (indexed && useAtomIndex && (ac < ATOM_CODE_SIZE)) {
+        unsigned int n = atomIndex[ac];
+        return (n > 0) ? &(const_cast<Atom&> (atoms[n - 1])) : NULL;
+    }
     for (unsigned int i = 0; i < atoms.size(); i++)
         if (getAtom(i).getCode() == ac)
             return &(const_cast<Atom&> (getAtom(i)));
@@ -205,17 +224,17 @@ Group::pGetAtom(const AtomCode& ac) const {
 }
 
 /**
- *   Returns the position of the Atom in the atoms vector searching by its identification number.
- * @param cmp (const unsigned long)
- * @return  Position in the atoms vector if the atom is found, otherwise the size of the atoms vector plus 1 (unsigned int)
+ *   Rebuilds the table of the position of the first atom of each code.
  */
-unsigned int
-Group::pGetIndex(const unsigned long cmp) const {
-    for (unsigned int i = 0; i < atoms.size(); i++) {
-        if ((*this)[i].getNumber() == cmp)
-            return i;
+void
+Group::pIndexAtoms() {
+    memset(atomIndex, 0, sizeof (atomIndex));
+    indexed = (atoms.size() <= MAX_INDEXED_ATOMS);
+    if (!indexed)
+        return;
+    for (unsigned int i = atoms.size(); i > 0; i--) {
+        AtomCode ac = atoms[i - 1].getCode();
+        if (ac < ATOM_CODE_SIZE)
+            atomIndex[ac] = i;
     }
-    return size() + 1;
 }
-
-
@@ -28,12 +28,18 @@ namespace Victor { namespace Biopool {
     
     /**@brief This class implements a simple chemical group
      * 
+     *  Atoms are looked up by code through a small table holding the
+     * position of the first atom of each code, kept up to date by the
+     * modifiers and by Atom::setType()/setCode(). Groups of more than
+     * MAX_INDEXED_ATOMS atoms fall back to a linear search, which
+     * setUseAtomIndex(false) selects for all groups, eg. for benchmarking.
      * */
     
     // Global constants, typedefs, etc. (to avoid):
 
     class Group : public Monomer {
     public:
+        friend class Atom;
 
         // CONSTRUCTORS/DESTRUCTOR:
         Group(unsigned int mI = 1, unsigned int mO = 4);
@@ -58,12 +64,14 @@ namespace Victor { namespace Biopool {
         vgMatrix3<double> getRot() const;
 
         virtual bool isMember(const AtomCode& ac) const;
+        static bool getUseAtomIndex();
 
         // MODIFIERS:
         void copy(const Group& orig);
         void setAtom(unsigned int n, Atom& at);
         void addAtom(Atom& a);
         void removeAtom(Atom& a);
+        static void setUseAtomIndex(bool use);
 
         virtual void load(Loader& l); // data loader
 
@@ -99,10 +107,14 @@ namespace Victor { namespace Biopool {
     private:
 
         // HELPERS:
-        unsigned int pGetIndex(const unsigned long cmp) const;
+        void pIndexAtoms();
 
         // ATTRIBUTES:
+        static const unsigned int MAX_INDEXED_ATOMS = 254;
+        static bool useAtomIndex; // false to look up atoms by linear search
         vector<Atom> atoms;
+        unsigned char atomIndex[ATOM_CODE_SIZE]; // 1 + position of the first atom of each code, 0 if none
+        bool indexed; // false if atomIndex is not used
         vgVector3<double> trans; // group translation
         vgMatrix3<double> rot; // group rotation
 
@@ -162,13 +174,29 @@ namespace Victor { namespace Biopool {
         return (pGetAtom(ac) != NULL);
     }
 
+    inline bool
+    Group::getUseAtomIndex() {
+        return useAtomIndex;
+    }
+
     // MODIFIERS:
 
+    /**
+     * Selects the atom lookup of all groups, by index table (default) or
+     * by linear search. Not to be changed while other threads use groups.
+     * @param use true to use the index table
+     */
+    inline void
+    Group::setUseAtomIndex(bool use) {
+        useAtomIndex = use;
+    }
+
     inline void
     Group::setAtom(unsigned int n, Atom& at) {
         PRECOND(n < atoms.size(), exception);
         atoms[n] = at;
         atoms[n].setSuperior(this);
+        pIndexAtoms();
         Group::setModified();
     }
 
@@ -91,14 +91,14 @@ namespace Victor { namespace Biopool {
         if (n != 0) {
             number = n;
         } else {
-            number = ++counter;
+            number = __sync_add_and_fetch(&counter, 1); // thread-safe ++counter
         }
     }
 
     inline
     Identity::Identity(const Identity& orig)
     : name(orig.name) {
-        number = ++counter;
+        number = __sync_add_and_fetch(&counter, 1); // thread-safe ++counter
     }
 
     inline
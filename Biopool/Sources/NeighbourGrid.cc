@@ -0,0 +1,190 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Includes:
+#include <NeighbourGrid.h>
+#include <algorithm>
+#include <cmath>
+
+// Global constants, typedefs, etc. (to avoid):
+using namespace Victor; using namespace Victor::Biopool;
+
+/// upper limit to the number of cells along each axis
+static const int MAX_CELLS_PER_DIM = 64;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Builds an empty grid.
+ *@param cutoff distance (double)
+ */
+NeighbourGrid::NeighbourGrid(double _cutoff) : cutoff(_cutoff),
+cellSize(_cutoff), origin(0, 0, 0) {
+    PRECOND(_cutoff > 0.0, exception);
+    dims[0] = dims[1] = dims[2] = 0;
+}
+
+/**
+ *  Builds the grid for a set of points.
+ *@param points (vector<vgVector3<double> >), cutoff distance (double)
+ */
+NeighbourGrid::NeighbourGrid(const vector<vgVector3<double> >& points,
+        double _cutoff) : cutoff(_cutoff), cellSize(_cutoff), origin(0, 0, 0) {
+    PRECOND(_cutoff > 0.0, exception);
+    dims[0] = dims[1] = dims[2] = 0;
+    build(points);
+}
+
+// PREDICATES:
+
+/**
+ *  Returns the indices of all points in the cells around pos, ie. a
+ * superset of the points within the cutoff, in ascending order.
+ *@param position (vgVector3<double>), result (vector<unsigned int>&)
+ */
+void
+NeighbourGrid::getCandidates(const vgVector3<double>& pos,
+        vector<unsigned int>& res) const {
+    res.clear();
+    if (points.empty())
+        return;
+
+    int c[3];
+    for (unsigned int d = 0; d < 3; d++)
+        c[d] = pGetCell(pos[d], d);
+
+    for (int z = max(c[2] - 1, 0); z <= min(c[2] + 1, dims[2] - 1); z++)
+        for (int y = max(c[1] - 1, 0); y <= min(c[1] + 1, dims[1] - 1); y++)
+            for (int x = max(c[0] - 1, 0); x <= min(c[0] + 1, dims[0] - 1); x++) {
+                unsigned int cell = pGetCellIndex(x, y, z);
+                res.insert(res.end(), cellPoints.begin() + cellStart[cell],
+                        cellPoints.begin() + cellStart[cell + 1]);
+            }
+    sort(res.begin(), res.end());
+}
+
+/**
+ *  Returns the indices of all points closer than the cutoff to pos, in
+ * ascending order.
+ *@param position (vgVector3<double>), result (vector<unsigned int>&)
+ */
+void
+NeighbourGrid::getNeighbours(const vgVector3<double>& pos,
+        vector<unsigned int>& res) const {
+    getCandidates(pos, res);
+    double sqrCutoff = cutoff * cutoff;
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < res.size(); i++)
+        if ((points[res[i]] - pos).square() < sqrCutoff)
+            res[n++] = res[i];
+    res.resize(n);
+}
+
+/**
+ *  Returns the number of points closer than the cutoff to pos.
+ *@param position (vgVector3<double>)
+ *@return number of points (unsigned int)
+ */
+unsigned int
+NeighbourGrid::countNeighbours(const vgVector3<double>& pos) const {
+    if (points.empty())
+        return 0;
+
+    int c[3];
+    for (unsigned int d = 0; d < 3; d++)
+        c[d] = pGetCell(pos[d], d);
+
+    double sqrCutoff = cutoff * cutoff;
+    unsigned int count = 0;
+    for (int z = max(c[2] - 1, 0); z <= min(c[2] + 1, dims[2] - 1); z++)
+        for (int y = max(c[1] - 1, 0); y <= min(c[1] + 1, dims[1] - 1); y++)
+            for (int x = max(c[0] - 1, 0); x <= min(c[0] + 1, dims[0] - 1); x++) {
+                unsigned int cell = pGetCellIndex(x, y, z);
+                for (unsigned int i = cellStart[cell]; i < cellStart[cell + 1]; i++)
+                    if ((points[cellPoints[i]] - pos).square() < sqrCutoff)
+                        count++;
+            }
+    return count;
+}
+
+// MODIFIERS:
+
+/**
+ *  Sets the cutoff distance. The grid has to be built again.
+ *@param cutoff distance (double)
+ */
+void
+NeighbourGrid::setCutoff(double _cutoff) {
+    PRECOND(_cutoff > 0.0, exception);
+    cutoff = _cutoff;
+    clear();
+}
+
+/**
+ *  Bins a set of points into the grid, replacing the previous ones.
+ *@param points (vector<vgVector3<double> >)
+ */
+void
+NeighbourGrid::build(const vector<vgVector3<double> >& _points) {
+    clear();
+    points = _points;
+    if (points.empty())
+        return;
+
+    vgVector3<double> upper = points[0];
+    origin = points[0];
+    for (unsigned int i = 1; i < points.size(); i++)
+        for (unsigned int d = 0; d < 3; d++) {
+            origin[d] = min(origin[d], points[i][d]);
+            upper[d] = max(upper[d], points[i][d]);
+        }
+
+    // use larger cells rather than too many of them for sparse sets
+    cellSize = cutoff;
+    for (unsigned int d = 0; d < 3; d++)
+        cellSize = max(cellSize, (upper[d] - origin[d]) / (MAX_CELLS_PER_DIM - 1));
+    for (unsigned int d = 0; d < 3; d++)
+        dims[d] = static_cast<int> (floor((upper[d] - origin[d]) / cellSize)) + 1;
+
+    // counting sort of the points by cell, stable in point index
+    unsigned int nCells = dims[0] * dims[1] * dims[2];
+    vector<unsigned int> pointCell(points.size());
+    cellStart.assign(nCells + 1, 0);
+    for (unsigned int i = 0; i < points.size(); i++) {
+        pointCell[i] = pGetCellIndex(pGetCell(points[i][0], 0),
+                pGetCell(points[i][1], 1), pGetCell(points[i][2], 2));
+        cellStart[pointCell[i] + 1]++;
+    }
+    for (unsigned int c = 0; c < nCells; c++)
+        cellStart[c + 1] += cellStart[c];
+
+    vector<unsigned int> fill(cellStart.begin(), cellStart.end() - 1);
+    cellPoints.resize(points.size());
+    for (unsigned int i = 0; i < points.size(); i++)
+        cellPoints[fill[pointCell[i]]++] = i;
+}
+
+/**
+ *  Removes all points.
+ */
+void
+NeighbourGrid::clear() {
+    points.clear();
+    cellStart.clear();
+    cellPoints.clear();
+    dims[0] = dims[1] = dims[2] = 0;
+    cellSize = cutoff;
+}
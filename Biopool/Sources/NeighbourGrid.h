@@ -0,0 +1,131 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NEIGHBOURGRID_H_
+#define _NEIGHBOURGRID_H_
+
+// Includes:
+#include <vector>
+#include <vector3.h>
+#include <Debug.h>
+
+namespace Victor { namespace Biopool { 
+
+    /**
+     * @brief Cell list for fixed-radius neighbour searches.
+     * 
+     *  Points are binned into cubic cells whose side is (at least) the
+     * cutoff, so all points closer than the cutoff to a given position lie
+     * in the 27 cells around it. Point indices are returned in ascending order, so that
+     * callers summing over neighbours visit them in the same order as a
+     * plain loop over all points.
+     * The grid keeps a copy of the coordinates: it has to be rebuilt when
+     * they change.
+     * */
+    class NeighbourGrid {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        NeighbourGrid(double _cutoff = 10.0);
+        NeighbourGrid(const vector<vgVector3<double> >& points,
+                double _cutoff);
+
+        virtual ~NeighbourGrid() {
+            PRINT_NAME;
+        }
+
+        // PREDICATES:
+        double getCutoff() const;
+        unsigned int size() const;
+        const vgVector3<double>& getPoint(unsigned int n) const;
+
+        void getCandidates(const vgVector3<double>& pos,
+                vector<unsigned int>& res) const;
+        void getNeighbours(const vgVector3<double>& pos,
+                vector<unsigned int>& res) const;
+        unsigned int countNeighbours(const vgVector3<double>& pos) const;
+
+        // MODIFIERS:
+        void setCutoff(double _cutoff);
+        void build(const vector<vgVector3<double> >& points);
+        void clear();
+
+        // OPERATORS:
+
+    protected:
+
+        // HELPERS:
+        int pGetCell(double coord, unsigned int dim) const;
+        unsigned int pGetCellIndex(int cx, int cy, int cz) const;
+
+        // ATTRIBUTES:
+        double cutoff;
+        double cellSize; // at least the cutoff
+        vector<vgVector3<double> > points;
+        vgVector3<double> origin; // lower corner of the grid
+        int dims[3]; // number of cells along x, y, z
+        vector<unsigned int> cellStart; // points of cell c: [cellStart[c], cellStart[c+1])
+        vector<unsigned int> cellPoints; // point indices sorted by cell
+
+    private:
+
+    };
+
+    // ---------------------------------------------------------------------------
+    //                               NeighbourGrid
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline double
+    NeighbourGrid::getCutoff() const {
+        return cutoff;
+    }
+
+    inline unsigned int
+    NeighbourGrid::size() const {
+        return points.size();
+    }
+
+    inline const vgVector3<double>&
+    NeighbourGrid::getPoint(unsigned int n) const {
+        PRECOND(n < points.size(), exception);
+        return points[n];
+    }
+
+    // HELPERS:
+
+    /**
+     *  Cell coordinate along one dimension, clamped to the grid. Clamping
+     * positions outside the grid still yields all points within the cutoff.
+     */
+    inline int
+    NeighbourGrid::pGetCell(double coord, unsigned int dim) const {
+        int c = static_cast<int> (floor((coord - origin[dim]) / cellSize));
+        if (c < 0)
+            return 0;
+        if (c >= dims[dim])
+            return dims[dim] - 1;
+        return c;
+    }
+
+    inline unsigned int
+    NeighbourGrid::pGetCellIndex(int cx, int cy, int cz) const {
+        return (cz * dims[1] + cy) * dims[0] + cx;
+    }
+
+}} //namespace
+#endif //_NEIGHBOURGRID_H_
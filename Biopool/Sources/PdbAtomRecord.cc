@@ -0,0 +1,178 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <PdbAtomRecord.h>
+#include <cstdlib>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor;
+using namespace Victor::Biopool;
+
+static const unsigned int MAX_RECORD_LENGTH = 80;
+
+// exact powers of ten: p / 10^k is correctly rounded for these
+static const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+    1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+PdbAtomRecord::PdbAtomRecord() : hetAtom(false), serial(0), chainID(' '),
+resSeq(0), iCode(' '), coords(0, 0, 0), bFac(0.0) {
+    atomName[0] = '\0';
+    resName[0] = '\0';
+}
+
+// PREDICATES:
+
+/**
+ *  Parses an ATOM or HETATM line. Columns past the end of the line are
+ *  read as blanks.
+ *@param   line buffer (const char*), line length (unsigned int)
+ *@return  false if the record type or a number is not valid (bool)
+ */
+bool PdbAtomRecord::parse(const char* line, unsigned int len) {
+    char buf[MAX_RECORD_LENGTH];
+    if (len > MAX_RECORD_LENGTH)
+        len = MAX_RECORD_LENGTH;
+    for (unsigned int i = 0; i < MAX_RECORD_LENGTH; i++)
+        buf[i] = (i < len) ? line[i] : ' ';
+
+    if ((buf[0] == 'A') && (buf[1] == 'T') && (buf[2] == 'O')
+            && (buf[3] == 'M') && (buf[4] == ' ') && (buf[5] == ' '))
+        hetAtom = false;
+    else if ((buf[0] == 'H') && (buf[1] == 'E') && (buf[2] == 'T')
+            && (buf[3] == 'A') && (buf[4] == 'T') && (buf[5] == 'M'))
+        hetAtom = true;
+    else
+        return false;
+
+    unsigned int n = 0;
+    for (unsigned int i = 11; i < 17; i++)
+        if (buf[i] != ' ')
+            atomName[n++] = buf[i];
+    atomName[n] = '\0';
+    n = 0;
+    for (unsigned int i = 17; i < 20; i++)
+        if (buf[i] != ' ')
+            resName[n++] = buf[i];
+    resName[n] = '\0';
+
+    chainID = buf[21];
+    iCode = buf[26];
+
+    bFac = 0.0;
+    if ((len >= 66) && (!isBlank(buf + 60, 6)))
+        if (!parseDouble(buf + 60, 6, bFac))
+            return false;
+
+    return parseInt(buf + 6, 5, serial) && parseInt(buf + 22, 4, resSeq)
+            && parseDouble(buf + 30, 8, coords.x)
+            && parseDouble(buf + 38, 8, coords.y)
+            && parseDouble(buf + 46, 8, coords.z);
+}
+
+/**
+ *  Reads an integer from a fixed width field. Leading blanks are skipped,
+ *  the number ends at the first character which is not a digit.
+ *@param   field start (const char*), width (unsigned int), result (int&)
+ *@return  false if the field does not start with a number (bool)
+ */
+bool PdbAtomRecord::parseInt(const char* field, unsigned int width, int& res) {
+    unsigned int i = 0;
+    while ((i < width) && (field[i] == ' '))
+        i++;
+    bool negative = false;
+    if ((i < width) && ((field[i] == '-') || (field[i] == '+'))) {
+        negative = (field[i] == '-');
+        i++;
+    }
+    if ((i >= width) || (field[i] < '0') || (field[i] > '9'))
+        return false;
+    int val = 0;
+    while ((i < width) && (field[i] >= '0') && (field[i] <= '9'))
+        val = 10 * val + (field[i++] - '0');
+    res = negative ? -val : val;
+    return true;
+}
+
+/**
+ *  Reads a decimal number from a fixed width field. Plain fixed point
+ *  numbers are converted directly (with the same, correctly rounded,
+ *  result as strtod); numbers with an exponent are handed to strtod.
+ *@param   field start (const char*), width (unsigned int), result (double&)
+ *@return  false if the field does not start with a number (bool)
+ */
+bool PdbAtomRecord::parseDouble(const char* field, unsigned int width,
+        double& res) {
+    unsigned int i = 0;
+    while ((i < width) && (field[i] == ' '))
+        i++;
+    unsigned int start = i;
+    bool negative = false;
+    if ((i < width) && ((field[i] == '-') || (field[i] == '+'))) {
+        negative = (field[i] == '-');
+        i++;
+    }
+    double mantissa = 0.0; // exact up to 15 digits
+    unsigned int digits = 0;
+    unsigned int decimals = 0;
+    bool point = false;
+    for (; i < width; i++) {
+        char c = field[i];
+        if ((c >= '0') && (c <= '9')) {
+            mantissa = 10 * mantissa + (c - '0');
+            digits++;
+            if (point)
+                decimals++;
+        } else if ((c == '.') && (!point))
+            point = true;
+        else
+            break;
+    }
+    if (digits == 0)
+        return false;
+
+    if (((i < width) && ((field[i] == 'e') || (field[i] == 'E')))
+            || (digits > 15)) {
+        char buf[MAX_RECORD_LENGTH + 1];
+        unsigned int n = 0;
+        for (unsigned int j = start; j < width; j++)
+            buf[n++] = field[j];
+        buf[n] = '\0';
+        res = strtod(buf, NULL);
+        return true;
+    }
+
+    res = mantissa / POW10[decimals];
+    if (negative)
+        res = -res;
+    return true;
+}
+
+/**
+ *  Checks if a field contains only blanks.
+ *@param   field start (const char*), width (unsigned int)
+ *@return  bool
+ */
+bool PdbAtomRecord::isBlank(const char* field, unsigned int width) {
+    for (unsigned int i = 0; i < width; i++)
+        if (field[i] != ' ')
+            return false;
+    return true;
+}
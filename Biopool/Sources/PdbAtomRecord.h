@@ -0,0 +1,57 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _PDBATOMRECORD_H_
+#define _PDBATOMRECORD_H_
+
+// Includes:
+#include <vector3.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Biopool { 
+
+    /**
+     * @brief Fields of a PDB ATOM/HETATM record.
+     * 
+     *  parse() reads the fixed columns straight from the line buffer,
+     * without building substrings and without heap allocations. Names are
+     * stored without blanks, as PdbLoader expects them.
+     * */
+    struct PdbAtomRecord {
+        bool hetAtom; // HETATM rather than ATOM
+        int serial; // atom serial number, columns 7-11
+        char atomName[7]; // columns 13-17 (incl. altLoc), without blanks
+        char resName[4]; // columns 18-20, without blanks
+        char chainID; // column 22
+        int resSeq; // residue sequence number, columns 23-26
+        char iCode; // code for insertion of residues, column 27
+        vgVector3<double> coords; // columns 31-54
+        double bFac; // columns 61-66, 0 if blank
+
+        PdbAtomRecord();
+
+        bool parse(const char* line, unsigned int len);
+
+        static bool parseInt(const char* field, unsigned int width, int& res);
+        static bool parseDouble(const char* field, unsigned int width,
+                double& res);
+        static bool isBlank(const char* field, unsigned int width);
+    };
+
+}} // namespace
+#endif //_PDBATOMRECORD_H_
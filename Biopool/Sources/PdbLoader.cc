@@ -25,6 +25,8 @@
 #include <Ligand.h>
 #include <Nucleotide.h>
 #include <AminoAcidHydrogen.h>
+#include <algorithm>
+#include <PdbAtomRecord.h>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -41,19 +43,8 @@ using namespace Victor; using namespace Victor::Biopool;
 
 unsigned int
 PdbLoader::getMaxModels() {
-    input.clear(); // reset file to previous content 
-    input.seekg(0);
-
-    unsigned int max = 0;
-
-    while (input) {
-        string atomLine = readLine(input);
-        string tag = atomLine.substr(0, 6);
-
-        if (tag == "MODEL ")
-            max++;
-    }
-    return max;
+    scanInput();
+    return scanModels;
 }
 
 /**
@@ -118,38 +109,63 @@ PdbLoader::getMaxModelsFast() {
 }
 
 /**
- *    Returns all available chain IDs for a PDB file.
+ *    Returns all available chain IDs for a PDB file, ie. the chains with
+ *    amino acids in the first model, in order of appearance.
  *    
  *@param   void
  *@return  vector of chars
  */
 vector<char>
 PdbLoader::getAllChains() {
-    vector<char> res;
+    scanInput();
+    return scanChains;
+}
+
+/**
+ *    Private helper function: reads the whole input once to find the chains
+ *    and the number of models, then rewinds it. Later calls reuse the result.
+ *@param   void
+ *@return  void
+ */
+void PdbLoader::scanInput() {
+    if (scanned)
+        return;
+    rewindInput();
     char lastChain = ' ';
-    input.clear(); // reset file to previous content 
-    input.seekg(0);
     unsigned int max = 0;
 
     while (input) {
         string atomLine = readLine(input);
+        string tag = atomLine.substr(0, 6);
 
-        if (atomLine.substr(0, 5) == "MODEL")
+        if (tag == "MODEL ")
             max++;
-        if (max > 1) // only consider first model: others duplicate chainIDs
-            break;
-
-        // check for new chains containing amino acids
-        if ((atomLine.substr(0, 4) == "ATOM")
-                && (atomLine.substr(21, 1)[0] != lastChain))
-            //&& (aminoAcidThreeLetterTranslator(atomLine.substr(17,3)) != XXX))
-        {
-            lastChain = atomLine.substr(21, 1)[0];
-            res.push_back(lastChain);
+
+        // check for new chains containing amino acids, first model only:
+        // others duplicate chainIDs
+        if ((max <= 1) && (tag == "ATOM  ") && (atomLine.size() > 21)
+                && (atomLine[21] != lastChain)) {
+            lastChain = atomLine[21];
+            if (find(scanChains.begin(), scanChains.end(), lastChain)
+                    == scanChains.end())
+                scanChains.push_back(lastChain);
         }
     }
+    scanModels = max;
+    scanned = true;
+    rewindInput();
+}
 
-    return res;
+/**
+ *    Private helper function: moves a seekable input back to its start.
+ *    Pipes and other streams without positioning are left alone.
+ *@param   void
+ *@return  void
+ */
+void PdbLoader::rewindInput() {
+    input.clear(); // reset file to previous content 
+    if (input.tellg() != streampos(-1))
+        input.seekg(0, ios::beg);
 }
 
 /**
@@ -250,7 +266,9 @@ PdbLoader::loadSpacer(Spacer& sp){
  */
 
 /**
- *   Core function for PDB file parsing. 
+ *   Core function for PDB file parsing. The input is read once, from the
+ *   start if it is seekable and from the current position otherwise (eg. a
+ *   pipe); each ATOM/HETATM record is handed to the builder of its chain.
  * @param prot (Protein&)
  */
 
@@ -259,372 +277,364 @@ PdbLoader::loadProtein(Protein& prot) {
 
     PRINT_NAME;
 
-    vector<char> chainList = getAllChains();
-
-    if (chainList.size() == 0) {
-        if (verbose)
-            cout << "Warning: Missing chain ID in the PDB, assuming the same chain for the entire file.\n";
-        chainList.push_back(char(' '));
-    }
-
+    rewindInput();
 
     unsigned int readingModel = model;
-    bool loadChain = false;
+    unsigned int maxModel = 0;
 
     helixCode = "";
     sheetCode = "";
+    helixData.clear();
+    sheetData.clear();
 
 
-    string path = "data/AminoAcidHydrogenData.txt";
-    const char* inputFile = getenv("VICTOR_ROOT");
-    if (inputFile == NULL)
-        ERROR("Environment variable VICTOR_ROOT was not found.", exception);
-
-    AminoAcidHydrogen::loadParam(((string) inputFile + path).c_str());
+    AminoAcidHydrogen::loadParam(); // built-in table, unless one was loaded
 
-    for (unsigned int i = 0; i < chainList.size(); i++) {
-        loadChain = false;
-        // Load all chains
-        if (allChains) {
-            loadChain = true;
-        } else {
-            // Load only first chain
-            if (chain == ' ') {
-                loadChain = true;
-                chain = '#';
-            }                // Load only selected chain
-            else if (chainList[i] == chain) {
-                loadChain = true;
-                chain = '#';
-            }
-        }
+    // chains containing amino acids in the first model, in order
+    vector<char> chainList;
+    char lastChain = ' ';
+    map<char, ChainBuilder> builders;
 
-        if (loadChain) {
+    int start, end;
 
-            if (verbose) {
-                cout << "\nLoading chain: ->" << chainList[i] << "<-\n";
-            }
-            setChain(chainList[i]);
+    string name = "";
+    string tag = "";
 
-            input.clear(); // reset file to previous content 
-            input.seekg(0, ios::beg);
+    PdbAtomRecord record;
+    Atom atom; // reused for every record
+    string atomLine;
+    readLine(input, atomLine);
 
-            Spacer* sp = new Spacer();
-            LigandSet* ls = new LigandSet();
+    // read all lines
+    do {
 
-            string atomLine;
-            atomLine = readLine(input);
+        tag.assign(atomLine, 0, 6);
 
-            int aaNum = -100000; // infinite negative
-            int oldAaNum = -100000;
-            //int lastAa = -10000;
+        if ((tag == "HEADER") && (name == "")) {
+            name = atomLine;
+        } else if (tag == "MODEL ") {
+            maxModel++;
+            readingModel = stouiDEF(atomLine.substr(6, 10));
+            if (readingModel > model)
+                break;
+            // Get only the first model if not specified
+            if (model == 999) {
+                model = readingModel;
+            }
+        }
 
-            AminoAcid* aa = new AminoAcid();
-            Ligand* lig = new Ligand();
+            // read helix entry
+        else if (tag == "HELIX ") {
+            start = stoiDEF(atomLine.substr(21, 4));
+            end = stoiDEF(atomLine.substr(33, 4));
 
+            helixData.push_back(pair<const int, int>(start, end));
+            helixCode += atomLine.substr(19, 1).c_str()[0];
+        }            // read sheet entry
+        else if (tag == "SHEET ") {
+            start = stoiDEF(atomLine.substr(22, 4));
+            end = stoiDEF(atomLine.substr(33, 4));
 
-            int start, end;
+            sheetData.push_back(pair<const int, int>(start, end));
+            sheetCode += atomLine.substr(21, 1).c_str()[0];
+        }
 
-            string name = "";
-            string tag = "";
+            // Parse one line of the "ATOM" and "HETATM" fields
+        else if (((tag == "ATOM  ") || (tag == "HETATM"))
+                && (atomLine.size() > 21)) {
+
+            char chainID = atomLine[21];
+            bool known = (find(chainList.begin(), chainList.end(), chainID)
+                    != chainList.end());
+            if ((tag == "ATOM  ") && (maxModel <= 1) && (chainID != lastChain)) {
+                lastChain = chainID;
+                if (!known) {
+                    chainList.push_back(chainID);
+                    known = true;
+                }
+            }
 
-            // read all lines
-            do {
+            // skip chains which are known not to be loaded
+            bool skip = false;
+            if (known && !allChains)
+                skip = (chain == ' ') ? (chainID != chainList[0])
+                    : (chainID != chain);
 
-                tag = atomLine.substr(0, 6);
+            if ((!skip) && ((model == 999) || (model == readingModel))) {
+                ChainBuilder& b = builders[chainID];
+                if (b.sp == NULL)
+                    initChain(b);
 
-                if ((tag == "HEADER") && (name == "")) {
-                    name = atomLine;
-                    sp->setType(name);
-                } else if (tag == "MODEL ") {
-                    readingModel = stouiDEF(atomLine.substr(6, 10));
-                    if (readingModel > model)
-                        break;
-                    // Get only the first model if not specified
-                    if (model == 999) {
-                        model = readingModel;
-                    }
+                if (!record.parse(atomLine.c_str(), atomLine.size())) {
+                    cerr << "\"" << atomLine << "\" is no valid ATOM/HETATM record!!" << endl;
+                    ERROR("Wrong format", exception);
                 }
 
-                    // read helix entry
-                else if (tag == "HELIX ") {
-                    start = stoiDEF(atomLine.substr(21, 4));
-                    end = stoiDEF(atomLine.substr(33, 4));
+                // Insert the previous residue and ligand
+                if (record.resSeq != b.oldAaNum)
+                    addResidue(b, false);
 
-                    helixData.push_back(pair<const int, int>(start, end));
-                    helixCode += atomLine.substr(19, 1).c_str()[0];
-                }                    // read sheet entry
-                else if (tag == "SHEET ") {
-                    start = stoiDEF(atomLine.substr(22, 4));
-                    end = stoiDEF(atomLine.substr(33, 4));
+                b.oldAaNum = parsePDBline(record, atom, b.lig, b.aa);
+            } // end chain and model check
+        }
+        readLine(input, atomLine);
 
-                    sheetData.push_back(pair<const int, int>(start, end));
-                    sheetCode += atomLine.substr(21, 1).c_str()[0];
-                }
+    } while (input);
 
-                    // Parse one line of the "ATOM" and "HETATM" fields
-                else if ((tag == "ATOM  ") || (tag == "HETATM")) {
-
-                    char chainID = atomLine.substr(21, 1)[0];
-                    if (chainList[i] == chainID) {
-
-                        if ((model == 999) || (model == readingModel)) {
-                            aaNum = stoiDEF(atomLine.substr(22, 4));
-
-                            // Insert the Ligand object into LigandSet
-                            if (aaNum != oldAaNum) {
-                                // Print some indexes for the debug
-                                /* 
-                                cout << aa->getType1L() << " offset:" << sp->getStartOffset() << " gaps:" 
-                                     << sp->sizeGaps() << " sizeAmino:" <<  sp->sizeAmino() <<  " maxPdbNum:" 
-                                     << sp->maxPdbNumber() << " aaNum:" << aaNum  
-                                     << " oldAaNum:" << oldAaNum << " lastAa:" << lastAa << "\n";
-                                 */
-                                if ((aa->size() > 0) && (aa->getType1L() != 'X')) { // Skip the first empty AminoAcid
-                                    if (sp->sizeAmino() == 0) {
-                                        sp->setStartOffset(oldAaNum - 1);
-                                    } else {
-                                        // Add gaps
-                                        //for (int i = lastAa+1; i < oldAaNum; i++){
-                                        for (int i = sp->maxPdbNumber() + 1; i < oldAaNum; i++) {
-                                            sp->addGap(i);
-                                        }
-
-                                    }
-
-                                    sp->insertComponent(aa);
-
-                                }
-
-                                // Ligand
-                                if (lig->size() > 0) {
-
-                                    if (onlyMetalHetAtoms) {
-                                        if (lig->isSimpleMetalIon()) { // skip not metal ions  
-                                            ls->insertComponent(lig);
-                                        }
-                                    } else {
-                                        ls->insertComponent(lig);
-                                    }
-                                }
-
-                                aa = new AminoAcid();
-                                lig = new Ligand();
-                            }
-
-                            oldAaNum = parsePDBline(atomLine, tag, lig, aa);
-
-                        } // end model check
-                    } // end chain check
-                }
-                atomLine = readLine(input);
-
-            } while (input);
-
-            
-            /*
-            // Print some indexes for the debug
-            cout << aa->getType1L() << " offset:" << sp->getStartOffset() << " gaps:" 
-                << sp->sizeGaps() << " sizeAmino:" <<  sp->sizeAmino() <<  " maxPdbNum:" 
-                << sp->maxPdbNumber() << " aaNum:" << aaNum  
-                << " oldAaNum:" << oldAaNum << " lastAa:" << lastAa << "\n";
-             */
-            
-            // last residue/ligand
-            // AminoAcid
-            if ((aa->size() > 0) && (aa->getType1L() != 'X')) {
-                if (sp->sizeAmino() == 0) {
-                    sp->setStartOffset(oldAaNum - 1);
-                } else {
-                    // Add gaps
-                    //for (int i = lastAa+1; i < oldAaNum; i++){
-                    for (int i = sp->maxPdbNumber() + 1; i < oldAaNum; i++) {
-                        sp->addGap(i);
-                    }
-                }
-                sp->insertComponent(aa);
+    if (verbose)
+        cout << "Parsing done\n";
 
+    if (chainList.size() == 0) {
+        if (verbose)
+            cout << "Warning: Missing chain ID in the PDB, assuming the same chain for the entire file.\n";
+        chainList.push_back(char(' '));
+    }
 
-            }
-            // Ligand
-            if (lig->size() > 0) {
-                if (onlyMetalHetAtoms) {
-                    if (lig->isSimpleMetalIon()) { // skip not metal ions  
-                        ls->insertComponent(lig);
-                    }
-                } else {
-                    ls->insertComponent(lig);
-                }
-            }
+    // Load all chains, only the first chain or only the selected chain
+    char selected = (chain == ' ') ? chainList[0] : chain;
+    for (unsigned int i = 0; i < chainList.size(); i++)
+        if ((allChains) || (chainList[i] == selected)) {
             if (verbose)
-                cout << "Parsing done\n";
+                cout << "\nLoading chain: ->" << chainList[i] << "<-\n";
+            ChainBuilder& b = builders[chainList[i]];
+            if (b.sp == NULL)
+                initChain(b);
+            finishChain(b, chainList[i], name, prot);
+        }
 
-            ////////////////////////////////////////////////////////////////////
-            // Spacer processing
-            if (sp->sizeAmino() > 0) {
+    // chains not loaded, eg. HETATM records of other chains
+    for (map<char, ChainBuilder>::iterator it = builders.begin();
+            it != builders.end(); ++it)
+        deleteChain(it->second);
+}
 
-                // correct ''fuzzy'' (i.e. incomplete) residues
-                for (unsigned int j = 0; j < sp->sizeAmino(); j++) {
-                    if ((!sp->getAmino(j).isMember(O)) ||
-                            (!sp->getAmino(j).isMember(C)) ||
-                            (!sp->getAmino(j).isMember(CA)) ||
-                            (!sp->getAmino(j).isMember(N))) {
+/**
+ *   Private helper function: allocates the objects of a new chain.
+ * @param b (ChainBuilder&)
+ */
+void
+PdbLoader::initChain(ChainBuilder& b) {
+    b.sp = new Spacer();
+    b.ls = new LigandSet();
+    b.aa = new AminoAcid();
+    b.lig = new Ligand();
+    b.oldAaNum = -100000; // infinite negative
+}
 
-                        // remove residue
-                        sp->deleteComponent(&(sp->getAmino(j)));
+/**
+ *   Private helper function: inserts the residue and the ligand being read
+ *   into the chain and, if more records follow, starts new ones.
+ * @param b (ChainBuilder&)
+ * @param last (bool) true after the last record of the chain
+ */
+void
+PdbLoader::addResidue(ChainBuilder& b, bool last) {
+    // AminoAcid
+    if ((b.aa->size() > 0) && (b.aa->getType1L() != 'X')) { // Skip the first empty AminoAcid
+        if (b.sp->sizeAmino() == 0) {
+            b.sp->setStartOffset(b.oldAaNum - 1);
+        } else {
+            // Add gaps
+            for (int i = b.sp->maxPdbNumber() + 1; i < b.oldAaNum; i++) {
+                b.sp->addGap(i);
+            }
+        }
+        b.sp->insertComponent(b.aa);
+    } else
+        delete b.aa;
 
-                        // Add a gap for removed residues
-                        sp->addGap(sp->getStartOffset() + j + 1);
+    // Ligand
+    if ((b.lig->size() > 0)
+            && ((!onlyMetalHetAtoms) || (b.lig->isSimpleMetalIon()))) // skip not metal ions
+        b.ls->insertComponent(b.lig);
+    else
+        delete b.lig;
 
-                        if (verbose) {
-                            cout << "Warning: Residue number " << sp->getPdbNumberFromIndex(j) << " is incomplete and had to be removed.\n";
-                        }
-                    }
-                }
-                if (verbose)
-                    cout << "Removed incomplete residues\n";
+    b.aa = last ? NULL : new AminoAcid();
+    b.lig = last ? NULL : new Ligand();
+}
 
-                // connect aminoacids
-                if (!noConnection) {
+/**
+ *   Private helper function: frees a chain which was not (fully) loaded.
+ * @param b (ChainBuilder&)
+ */
+void
+PdbLoader::deleteChain(ChainBuilder& b) {
+    delete b.sp;
+    delete b.ls;
+    delete b.aa;
+    delete b.lig;
+    b.sp = NULL;
+    b.ls = NULL;
+    b.aa = NULL;
+    b.lig = NULL;
+}
 
-                    if (!setBonds(*sp)) { // connect atoms...
-                        valid = false;
-                        if (verbose)
-                            cout << "Warning: Fail to connect residues in chain: " << chainList[i] << ".\n";
-                    }
-                    if (verbose)
-                        cout << "Connected residues\n";
+/**
+ *   Private helper function: completes a chain (removes incomplete residues,
+ *   connects residues, adds H atoms and secondary structure) and inserts it
+ *   into the protein.
+ * @param b (ChainBuilder&)
+ * @param chainID (char)
+ * @param name (string) HEADER record, used as spacer type
+ * @param prot (Protein&)
+ */
+void
+PdbLoader::finishChain(ChainBuilder& b, char chainID, const string& name,
+        Protein& prot) {
+    setChain(chainID);
+
+    // last residue/ligand
+    addResidue(b, true);
+
+    Spacer* sp = b.sp;
+    LigandSet* ls = b.ls;
+    b.sp = NULL;
+    b.ls = NULL;
+    if (name != "")
+        sp->setType(name);
+
+    ////////////////////////////////////////////////////////////////////
+    // Spacer processing
+    if (sp->sizeAmino() > 0) {
+
+        // correct ''fuzzy'' (i.e. incomplete) residues
+        for (unsigned int j = 0; j < sp->sizeAmino(); j++) {
+            if ((!sp->getAmino(j).isMember(O)) ||
+                    (!sp->getAmino(j).isMember(C)) ||
+                    (!sp->getAmino(j).isMember(CA)) ||
+                    (!sp->getAmino(j).isMember(N))) {
+
+                // remove residue
+                sp->deleteComponent(&(sp->getAmino(j)));
+
+                // Add a gap for removed residues
+                sp->addGap(sp->getStartOffset() + j + 1);
+
+                if (verbose) {
+                    cout << "Warning: Residue number " << sp->getPdbNumberFromIndex(j) << " is incomplete and had to be removed.\n";
                 }
+            }
+        }
+        if (verbose)
+            cout << "Removed incomplete residues\n";
 
+        // connect aminoacids
+        if (!noConnection) {
 
-                // correct position of leading N atom
-                sp->setTrans(sp->getAmino(0)[N].getTrans());
-                vgVector3<double> tmp(0.0, 0.0, 0.0);
-                sp->getAmino(0)[N].setTrans(tmp);
-                sp->getAmino(0).adjustLeadingN();
+            if (!setBonds(*sp)) { // connect atoms...
+                valid = false;
                 if (verbose)
-                    cout << "Fixed leading N atom\n";
-
-
+                    cout << "Warning: Fail to connect residues in chain: " << chainID << ".\n";
+            }
+            if (verbose)
+                cout << "Connected residues\n";
+
+            // correct position of leading N atom
+            // (unconnected atoms keep their absolute coordinates)
+            sp->setTrans(sp->getAmino(0)[N].getTrans());
+            vgVector3<double> tmp(0.0, 0.0, 0.0);
+            sp->getAmino(0)[N].setTrans(tmp);
+            sp->getAmino(0).adjustLeadingN();
+            if (verbose)
+                cout << "Fixed leading N atom\n";
+        }
 
-                // Add H atoms
-                if (!noHAtoms) {
-                    for (unsigned int j = 0; j < sp->sizeAmino(); j++) {
-                        AminoAcidHydrogen::setHydrogen(&(sp->getAmino(j)), false); // second argument is VERBOSE
-                    }
-                    if (verbose)
-                        cout << "H assigned\n";
 
-                    if (!noSecondary) {
-                        sp->setDSSP(false); // argument is VERBOSE
-                        if (verbose)
-                            cout << "DSSP assigned\n";
-                    }
-                }
 
-                // assign secondary structure from torsion angles
-                if (!noSecondary) {
-                    assignSecondary(*sp);
-                    if (verbose)
-                        cout << "Torsional SS assigned\n";
-                }
+        // Add H atoms
+        if (!noHAtoms) {
+            for (unsigned int j = 0; j < sp->sizeAmino(); j++) {
+                AminoAcidHydrogen::setHydrogen(&(sp->getAmino(j)), false); // second argument is VERBOSE
+            }
+            if (verbose)
+                cout << "H assigned\n";
 
-            } else {
+            if (!noSecondary) {
+                sp->setDSSP(false); // argument is VERBOSE
                 if (verbose)
-                    cout << "Warning: No residues in chain: " << chainList[i] << ".\n";
+                    cout << "DSSP assigned\n";
             }
+        }
 
-            ////////////////////////////////////////////////////////////////////
-            // Load data into protein object
-            Polymer* pol = new Polymer();
-            pol->insertComponent(sp);
+        // assign secondary structure from torsion angles
+        if (!noSecondary) {
+            assignSecondary(*sp);
             if (verbose)
-                cout << "Loaded AminoAcids: " << sp->size() << "\n";
-
-            if (!(noHetAtoms)) {
-                if (ls->sizeLigand() > 0) { //insertion only if LigandSet is not empty
-                    pol->insertComponent(ls);
-                    if (verbose)
-                        cout << "Loaded Ligands: " << ls->size() << "\n";
-                } else {
-                    if (verbose)
-                        cout << "Warning: No ligands in chain: " << chainList[i] << ".\n";
-                }
-            }
-
-            prot.addChain(chainList[i]);
-            prot.insertComponent(pol);
+                cout << "Torsional SS assigned\n";
+        }
 
+    } else {
+        if (verbose)
+            cout << "Warning: No residues in chain: " << chainID << ".\n";
+    }
 
+    ////////////////////////////////////////////////////////////////////
+    // Load data into protein object
+    Polymer* pol = new Polymer();
+    pol->insertComponent(sp);
+    if (verbose)
+        cout << "Loaded AminoAcids: " << sp->size() << "\n";
 
-        } // end loadChain
-    } // chains iteration
+    if (!(noHetAtoms)) {
+        if (ls->sizeLigand() > 0) { //insertion only if LigandSet is not empty
+            pol->insertComponent(ls);
+            if (verbose)
+                cout << "Loaded Ligands: " << ls->size() << "\n";
+        } else {
+            delete ls;
+            if (verbose)
+                cout << "Warning: No ligands in chain: " << chainID << ".\n";
+        }
+    } else
+        delete ls;
 
+    prot.addChain(chainID);
+    prot.insertComponent(pol);
 }
 
 /**
- *   Parse a single line of a PDB file.
- * @param atomLine (string) the whole PDB line as it is
- * @param tag (string) = the first field (keyword) in a PDB line
+ *   Adds the atom of a parsed ATOM/HETATM record to its residue or ligand.
+ * @param record (PdbAtomRecord) the fields of the PDB line
+ * @param at (Atom) scratch atom, overwritten and copied into the residue
  * @param lig (Ligand) pointer
  * @param aa (AminoAcid) pointer
  * @return Residue number read from the PDB line (int)
  */
 int
-PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa) {
-
-    int atNum = stoiDEF(atomLine.substr(6, 5)); // stoi convert from string to int
-    //char altAtID = atomLine.substr(16,1)[0];    // "Alternate location indicator"               
-    int aaNum = stoiDEF(atomLine.substr(22, 4));
-    char altAaID = atomLine.substr(26, 1)[0]; // "Code for insertion of residues"
-    vgVector3<double> coord;
-    coord.x = stodDEF(atomLine.substr(30, 8));
-    coord.y = stodDEF(atomLine.substr(38, 8));
-    coord.z = stodDEF(atomLine.substr(46, 8));
-    double bfac = 0.0;
-    if (atomLine.length() >= 66) {
-        if (atomLine.substr(60, 6) != "      ") { // empty bfac
-            bfac = stodDEF(atomLine.substr(60, 6));
-        }
-    }
-    string atType = "";
-    for (int i = 11; i < 17; i++) {
-        if (atomLine[i] != ' ')
-            atType.append(atomLine.substr(i, 1));
-    }
-    string aaType = "";
-    for (int i = 17; i < 20; i++) {
-        if (atomLine[i] != ' ')
-            aaType.append(atomLine.substr(i, 1));
-    }
-    // take care of deuterium atoms
-    if (atType == "D") {
-        cerr << "--> " << atType << "\n";
-        atType = "H";
-    }
+PdbLoader::parsePDBline(const PdbAtomRecord& record, Atom& at, Ligand* lig,
+        AminoAcid* aa) {
+
+    int atNum = record.serial;
+    int aaNum = record.resSeq;
+    char altAaID = record.iCode; // "Code for insertion of residues"
+    string aaType = record.resName;
 
     // Initialize the Atom object
-    Atom* at = new Atom();
-    at->setNumber(atNum);
-    at->setType(atType);
-    at->setCoords(coord);
-    //at->setCoords(stod(atomLine.substr(30,8)),stod(atomLine.substr(38,8)),stod(atomLine.substr(46,8)));
-    at->setBFac(bfac);
+    at.setNumber(atNum);
+    // take care of deuterium atoms
+    if ((record.atomName[0] == 'D') && (record.atomName[1] == '\0')) {
+        cerr << "--> " << record.atomName << "\n";
+        at.setType("H");
+    } else
+        at.setType(record.atomName);
+    at.setCoords(record.coords);
+    at.setBFac(record.bFac);
 
     // Ligand object (includes DNA/RNA in "ATOM" field)
-    if ((tag == "HETATM") || isKnownNucleotide(nucleotideThreeLetterTranslator(aaType))) {
+    if ((record.hetAtom) || isKnownNucleotide(nucleotideThreeLetterTranslator(aaType))) {
 
         if (noWater) {
             if (!(aaType == "HOH")) {
-                lig->addAtom(*at);
+                lig->addAtom(at);
                 lig->setType(aaType);
             }
         } else {
-            lig->addAtom(*at);
+            lig->addAtom(at);
             lig->setType(aaType);
         }
     }        // AminoAcid
-    else if ((tag == "ATOM  ")) {
+    else {
 
         // skip N-terminal ACE groups
         if (aaType != "ACE") {
@@ -638,12 +648,12 @@ PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa)
                 aa->setType(aaType);
                 aa->getSideChain().setType(aaType);
 
-                if (!noHAtoms || isHeavyAtom(at->getCode())) {
+                if (!noHAtoms || isHeavyAtom(at.getCode())) {
 
-                    if (!inSideChain(*aa, *at))
-                        aa->addAtom(*at);
+                    if (!inSideChain(*aa, at))
+                        aa->addAtom(at);
                     else {
-                        aa->getSideChain().addAtom(*at);
+                        aa->getSideChain().addAtom(at);
                     }
                 }
             }
@@ -653,6 +663,5 @@ PdbLoader::parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa)
                 cout << "Warning: Skipping N-terminal ACE group " << aaNum << " " << atNum << ".\n";
         }
     }
-    delete at;
     return aaNum;
 }
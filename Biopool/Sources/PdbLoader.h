@@ -20,11 +20,13 @@
 // Includes:
 #include <string.h>
 #include <utility>
+#include <map>
 #include <Loader.h>
 #include <AminoAcid.h>
 #include <Spacer.h>
 #include <LigandSet.h>
 #include <Protein.h>
+#include <PdbAtomRecord.h>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -63,7 +65,8 @@ namespace Victor { namespace Biopool {
         allChains(_allChains), chain(' '), model(999), altAtom('A'), helixCode(_NULL),
         //sheetCode(_NULL), helixData(), sheetData(), onlyMetalHetAtoms(_onlyMetal), 
         sheetCode(_NULL), onlyMetalHetAtoms(_onlyMetal),
-        noNucleotideChains(_noNucleotideChains) {
+        noNucleotideChains(_noNucleotideChains), scanned(false),
+        scanChains(), scanModels(0) {
         }
 
         // this class uses the implicit copy operator.
@@ -138,6 +141,19 @@ namespace Victor { namespace Biopool {
             noConnection = false;
         }
 
+        /**
+         * Loads the atoms with their absolute coordinates only: residues
+         * are not connected and no H atoms or secondary structure are
+         * added. Faster and lighter for scoring or comparing structures,
+         * but torsion angles and internal coordinate editing (eg. Lobo)
+         * need a connected chain.
+         */
+        void setCoordinatesOnly() {
+            noConnection = true;
+            noHAtoms = true;
+            noSecondary = true;
+        }
+
         void setWater();
 
         void setAllChains() {
@@ -155,12 +171,37 @@ namespace Victor { namespace Biopool {
         //virtual void loadNucleotideChainSet(NucleotideChainSet& ns); //new class, new code by Damiano
 
     protected:
+
+        /**
+         * Residues and ligands of one chain collected while the file is
+         * read; aa and lig are the residue being filled.
+         */
+        struct ChainBuilder {
+            Spacer* sp;
+            LigandSet* ls;
+            AminoAcid* aa;
+            Ligand* lig;
+            int oldAaNum;
+
+            ChainBuilder() : sp(NULL), ls(NULL), aa(NULL), lig(NULL),
+            oldAaNum(-100000) {
+            }
+        };
+
         // HELPERS:
         bool setBonds(Spacer& sp);
         bool inSideChain(const AminoAcid& aa, const Atom& at);
         void loadSecondary();
         void assignSecondary(Spacer& sp);
-        int parsePDBline(string atomLine, string tag, Ligand* lig, AminoAcid* aa);
+        int parsePDBline(const PdbAtomRecord& record, Atom& at, Ligand* lig,
+                AminoAcid* aa);
+        void scanInput();
+        void rewindInput();
+        void initChain(ChainBuilder& b);
+        void addResidue(ChainBuilder& b, bool last);
+        void deleteChain(ChainBuilder& b);
+        void finishChain(ChainBuilder& b, char chainID, const string& name,
+                Protein& prot);
 
 
 
@@ -189,6 +230,10 @@ namespace Victor { namespace Biopool {
         vector<pair<int, int> > helixData; //inizio e fine dell'elica
         vector<pair<int, int> > sheetData;
 
+        bool scanned; // scanChains and scanModels are set
+        vector<char> scanChains; // chains with amino acids in the first model
+        unsigned int scanModels; // number of MODEL records
+
     };
 
 }} //namespace
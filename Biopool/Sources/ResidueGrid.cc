@@ -0,0 +1,86 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <ResidueGrid.h>
+
+// Global constants, typedefs, etc. (to avoid):
+using namespace Victor; using namespace Victor::Biopool;
+
+/// widening of the cells, so that rounding never drops a point at the cutoff
+static const double GRID_MARGIN = 0.1;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Builds an empty grid.
+ *@param cutoff distance (double)
+ */
+ResidueGrid::ResidueGrid(double _cutoff) : cutoff(_cutoff),
+grid(_cutoff + GRID_MARGIN), atoms(), residue(), spacer(NULL), version(0) {
+}
+
+// PREDICATES:
+
+/**
+ *  Returns the residues whose representative atom lies in the cells
+ * around pos, ie. a superset of those within the cutoff, in ascending order.
+ *@param position (vgVector3<double>), result (vector<unsigned int>&)
+ */
+void
+ResidueGrid::getCandidates(const vgVector3<double>& pos,
+        vector<unsigned int>& res) const {
+    grid.getCandidates(pos, res);
+    for (unsigned int i = 0; i < res.size(); i++)
+        res[i] = residue[res[i]];
+}
+
+// MODIFIERS:
+
+/**
+ *  Bins the representative atoms of the residues of a Spacer.
+ *@param spacer (Spacer&), atom of each residue, NULL to leave the residue
+ *       out (vector<Atom*>)
+ */
+void
+ResidueGrid::build(const Spacer& sp, const vector<Atom*>& _atoms) {
+    PRECOND(_atoms.size() == sp.sizeAmino(), exception);
+    version = Atom::getModificationCount();
+    spacer = &sp;
+    atoms = _atoms;
+
+    vector<vgVector3<double> > points;
+    residue.clear();
+    for (unsigned int r = 0; r < atoms.size(); r++)
+        if (atoms[r] != NULL) {
+            points.push_back(atoms[r]->getCoords());
+            residue.push_back(r);
+        }
+    grid.build(points);
+}
+
+/**
+ *  Removes all residues.
+ */
+void
+ResidueGrid::clear() {
+    grid.clear();
+    atoms.clear();
+    residue.clear();
+    spacer = NULL;
+    version = 0;
+}
@@ -0,0 +1,109 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _RESIDUEGRID_H_
+#define _RESIDUEGRID_H_
+
+// Includes:
+#include <vector>
+#include <Spacer.h>
+#include <NeighbourGrid.h>
+
+namespace Victor { namespace Biopool { 
+
+    /**
+     * @brief Cell list of one representative atom per residue of a Spacer.
+     * 
+     *  Used to count the residues around a position (eg. CB atoms within
+     * 10 A) without looping over the whole chain. getCandidates() returns
+     * the residues whose atom may be within the cutoff, in ascending order;
+     * callers apply their own distance test to them, so counts are the
+     * same as with a loop over all residues.
+     * 
+     *  The grid remembers the Spacer and Atom::getModificationCount() it
+     * was built for; isValid() tells whether it still matches.
+     * */
+    class ResidueGrid {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        ResidueGrid(double _cutoff = 10.0);
+
+        virtual ~ResidueGrid() {
+            PRINT_NAME;
+        }
+
+        // PREDICATES:
+        bool isValid(const Spacer& sp) const;
+        double getCutoff() const;
+        unsigned int sizeAmino() const;
+        Atom* getAtom(unsigned int r) const;
+
+        void getCandidates(const vgVector3<double>& pos,
+                vector<unsigned int>& res) const;
+
+        // MODIFIERS:
+        void build(const Spacer& sp, const vector<Atom*>& atoms);
+        void clear();
+
+        // OPERATORS:
+
+    protected:
+
+        // ATTRIBUTES:
+        double cutoff;
+        NeighbourGrid grid; // cells at least cutoff + margin wide
+        vector<Atom*> atoms; // representative atom of each residue, or NULL
+        vector<unsigned int> residue; // residue of each grid point
+        const Spacer* spacer; // Spacer the grid was built for
+        unsigned long version; // Atom::getModificationCount() when built
+
+    private:
+
+    };
+
+    // ---------------------------------------------------------------------------
+    //                               ResidueGrid
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline bool
+    ResidueGrid::isValid(const Spacer& sp) const {
+        return (spacer == &sp) && (version == Atom::getModificationCount())
+                && (atoms.size() == sp.sizeAmino());
+    }
+
+    inline double
+    ResidueGrid::getCutoff() const {
+        return cutoff;
+    }
+
+    inline unsigned int
+    ResidueGrid::sizeAmino() const {
+        return atoms.size();
+    }
+
+    inline Atom*
+    ResidueGrid::getAtom(unsigned int r) const {
+        PRECOND(r < atoms.size(), exception);
+        return atoms[r];
+    }
+
+}} //namespace
+#endif //_RESIDUEGRID_H_
@@ -30,8 +30,6 @@ using namespace Victor; using namespace Victor::Biopool;
 SimpleBond::SimpleBond(unsigned int mI, unsigned int mO) : inBonds(),
 outBonds(), maxIn(mI), maxOut(mO), id("X") {
     PRINT_NAME;
-    inBonds.reserve(mI);
-    outBonds.reserve(mO);
 }
 
 SimpleBond::SimpleBond(const SimpleBond& orig) {
@@ -158,7 +156,7 @@ void SimpleBond::unbindOut(SimpleBond& c) {
  *    Private method to find the matching in-bond from c to this to remove.*/
 void SimpleBond::pUnbindIn(SimpleBond& c) {
     PRINT_NAME;
-    vector<SimpleBond*>::iterator iter = find(inBonds.begin(),
+    SimpleBond** iter = find(inBonds.begin(),
             inBonds.end(), &c);
     if (iter == inBonds.end())
         DEBUG_MSG("SimpleBond::pUnbindIn(): WARNING: Bond not found.");
@@ -171,7 +169,7 @@ void SimpleBond::pUnbindIn(SimpleBond& c) {
  */
 void SimpleBond::pUnbindOut(SimpleBond& c) {
     PRINT_NAME;
-    vector<SimpleBond*>::iterator iter = find(outBonds.begin(),
+    SimpleBond** iter = find(outBonds.begin(),
             outBonds.end(), &c);
     if (iter == outBonds.end())
         DEBUG_MSG("SimpleBond::pUnbindOut(): WARNING: Bond not found.");
@@ -192,7 +190,7 @@ void SimpleBond::copy(const SimpleBond& orig) {
     id = orig.id;
 
     // Remove old bonds.
-    vector<SimpleBond*>::iterator iter = inBonds.begin();
+    SimpleBond** iter = inBonds.begin();
     while (iter != inBonds.end())
         unbindIn(**iter);
 
@@ -23,6 +23,7 @@
 #include <string>
 //#include <Debug.h>
 #include <Identity.h>
+#include <BondList.h>
 using namespace std;
 
 // Global constants, typedefs, etc. (to avoid):
@@ -93,7 +94,8 @@ namespace Victor { namespace Biopool {
         virtual void pUnbindOut(SimpleBond& c);
 
         // ATTRIBUTES:
-        vector<SimpleBond*> inBonds, outBonds; // current in and out bonds
+        BondList<SimpleBond, 2> inBonds; // current in bonds
+        BondList<SimpleBond, 4> outBonds; // current out bonds
         unsigned int maxIn, maxOut; // maximum number of in and out bonds
         Identity id; // Object Id and name
 
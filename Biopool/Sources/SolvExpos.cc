@@ -18,7 +18,7 @@
 
 using namespace Victor; using namespace Victor::Biopool;
 
-SolvExpos::SolvExpos(){
+SolvExpos::SolvExpos() : grid(10.0) {
 }
 SolvExpos::~SolvExpos(){
 }
@@ -78,18 +78,19 @@ unsigned int SolvExpos::getNumNeighbours(Spacer &chain, const unsigned int tgt,
     AminoAcid& ta = chain.getAmino(tgt);
     Atom& tr = getReprAtom(ta);
 
-    unsigned int tot = 0;
-    for (unsigned int i = start; i < end; ++i) {
-        AminoAcid &ia = chain.getAmino(i);
-        try {
-            Atom &ir = getReprAtom(ia);
-            double dist = tr.distance(ir);
-            if (dist <= CUTOFF)
-                tot++;
-        } catch (const char* err) {
-            ;
-        }
+    // only the residues in the cells around the target can be in range
+    pUpdateGrid(chain);
+    vector<unsigned int> candidates;
+    grid.getCandidates(tr.getCoords(), candidates);
 
+    unsigned int tot = 0;
+    for (unsigned int k = 0; k < candidates.size(); ++k) {
+        unsigned int i = candidates[k];
+        if ((i < start) || (i >= end))
+            continue;
+        double dist = tr.distance(*grid.getAtom(i));
+        if (dist <= CUTOFF)
+            tot++;
     }
 
     if ((tgt >= start) && (tgt < end))
@@ -221,3 +222,22 @@ vector<double> SolvExpos::getSolvAccessVec(Spacer &chain, unsigned int tgtS,
 
     return seVec;
 }
+
+/**
+ *   Bins the representative atoms of the chain, unless the grid was built
+ *   for it and no atom moved since. Residues without a representative atom
+ *   are left out.
+ *@param chain: a Spacer object representing an entire protein chain.
+ */
+void SolvExpos::pUpdateGrid(Spacer &chain) {
+    if (grid.isValid(chain))
+        return;
+    vector<Atom*> atoms(chain.sizeAmino(), static_cast<Atom*> (NULL));
+    for (unsigned int i = 0; i < chain.sizeAmino(); ++i)
+        try {
+            atoms[i] = &getReprAtom(chain.getAmino(i));
+        } catch (const char* err) {
+            ;
+        }
+    grid.build(chain, atoms);
+}
@@ -18,6 +18,7 @@
 #define __SolvExpos_H__
 
 #include <Spacer.h>
+#include <ResidueGrid.h>
 
 namespace Victor { namespace Biopool { 
 
@@ -54,6 +55,12 @@ namespace Victor { namespace Biopool {
 
         
     private:
+
+        // HELPERS:
+        void pUpdateGrid(Spacer& chain);
+
+        // ATTRIBUTES:
+        ResidueGrid grid; // representative atoms of the last chain
         
     };
 }} //namespace
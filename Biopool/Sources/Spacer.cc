@@ -18,6 +18,7 @@
 #include <Spacer.h>
 #include <Debug.h>
 #include <IntCoordConverter.h>
+#include <SpacerDihedrals.h>
 #include <limits.h>
 #include <float.h>
 #include <math.h>
@@ -48,7 +49,7 @@ double Spacer::BOND_ANGLE_AT_N_TO_CALPHA = 121.9;
  *  Basic constructor
  */
 Spacer::Spacer() : Polymer(1, 1), startOffset(0), startAtomOffset(0), gaps(),
-subSpacerList() {
+subSpacerList(), aminoTable(), aminoTableValid(false), dihedrals(NULL) {
     PRINT_NAME;
 }
 
@@ -56,7 +57,8 @@ subSpacerList() {
  *  constructor based in another object
  *@param orig, reference to the original object to copy
  */
-Spacer::Spacer(const Spacer& orig) : subSpacerList() {
+Spacer::Spacer(const Spacer& orig) : subSpacerList(), aminoTable(),
+aminoTableValid(false), dihedrals(NULL) {
     PRINT_NAME;
     this->copy(orig);
 }
@@ -66,6 +68,7 @@ Spacer::Spacer(const Spacer& orig) : subSpacerList() {
  */
 Spacer::~Spacer() {
     PRINT_NAME;
+    delete dihedrals;
 }
 
 // PREDICATES:
@@ -453,6 +456,7 @@ void Spacer::insertAminoAfterWithGaps(
     aa->addTrans(caTransBack);
     aa->sync();
     components.push_back(aa);
+    pInvalidateAminoTable();
 }
 
 /**
@@ -589,6 +593,7 @@ void Spacer::insertAminoAfter(string code, unsigned int n, double phi, double ps
 
     static int XXX = 0;
     components.insert(components.begin() + n + 1, aa);
+    pInvalidateAminoTable();
     if ((nOldSizeAmino >= 2) && ((int) n < nOldSizeAmino - 2)) {
         ++XXX;
         cout << "((" << XXX << "))";
@@ -735,6 +740,7 @@ void Spacer::insertAminoBefore(string code, unsigned int p, double phi, double p
     aa->patchBetaPosition();
 
     components.insert(components.begin() + p, aa);
+    pInvalidateAminoTable();
 }
 
 
@@ -815,6 +821,7 @@ void Spacer::copy(const Spacer& orig) {
     for (unsigned int n = 0; n < orig.sizeSpacer(); n++)
         subSpacerList.push_back(orig.getSubSpacerListEntry(n));
     Polymer::copy(orig);
+    pInvalidateAminoTable();
 
     if ((sizeAmino() > 1) && (orig.getAmino(0)[C].isBond(orig.getAmino(1)[N])))
         for (unsigned int i = 0; i < sizeAmino() - 1; i++) {
@@ -830,6 +837,48 @@ void Spacer::copy(const Spacer& orig) {
         }
 }
 
+/**
+ *  Exchanges the contents (residues, offsets, gaps and cached data) of 
+ * two spacers without copying any atom, eg. to reorder or filter a 
+ * vector<Spacer>. Both spacers must be free standing, ie. without a 
+ * superior or bonds to other components.
+ *@param other, the spacer to exchange the contents with
+ */
+void Spacer::swap(Spacer& other) {
+    PRINT_NAME;
+    PRECOND(!hasSuperior() && !other.hasSuperior(), exception);
+    PRECOND((sizeInBonds() == 0) && (sizeOutBonds() == 0)
+            && (other.sizeInBonds() == 0) && (other.sizeOutBonds() == 0),
+            exception);
+    if (&other == this)
+        return;
+
+    std::swap(id, other.id);
+    std::swap(maxIn, other.maxIn);
+    std::swap(maxOut, other.maxOut);
+
+    components.swap(other.components);
+    for (unsigned int i = 0; i < components.size(); i++)
+        components[i]->setSuperior(this);
+    for (unsigned int i = 0; i < other.components.size(); i++)
+        other.components[i]->setSuperior(&other);
+    std::swap(lowerBound, other.lowerBound);
+    std::swap(upperBound, other.upperBound);
+    std::swap(modified, other.modified);
+
+    std::swap(startOffset, other.startOffset);
+    std::swap(startAtomOffset, other.startAtomOffset);
+    gaps.swap(other.gaps);
+    ss.swap(other.ss);
+    subSpacerList.swap(other.subSpacerList);
+    aminoTable.swap(other.aminoTable);
+    std::swap(aminoTableValid, other.aminoTableValid);
+    std::swap(dihedrals, other.dihedrals);
+
+    // data cached for either spacer (eg. ResidueGrid) no longer matches
+    Atom::addModification();
+}
+
 /**
  *  clone the spacer
  *@return  pointer to the new component 
@@ -882,6 +931,7 @@ void Spacer::insertComponent(Component* c) {
     }
     Polymer::insertComponent(c);
     setModified();
+    pInvalidateAminoTable();
     if (hasSuperior())
         (dynamic_cast<Spacer&> (getSuperior()))
         .modifySubSpacerList(this, static_cast<int> (count));
@@ -896,6 +946,7 @@ void Spacer::insertComponent(Component* c) {
  */
 
 void Spacer::modifySubSpacerList(Spacer* s, int count) {
+    pInvalidateAminoTable();
     unsigned int index = 0;
     while (&getSpacer(index) != s)
         index++;
@@ -960,37 +1011,11 @@ const Spacer& Spacer::getSpacer(unsigned int n) const {
  * @return aminoacid reference
  */
 
-AminoAcid& Spacer::getAmino(unsigned int n) { // needs to be recoded & optimized
-    PRECOND(n < this->sizeAmino(), exception);
-    unsigned int idxOffset = 0;
-    unsigned int lastMax = 0;
-    unsigned int subSpacerSize = subSpacerList.size();
-    unsigned int betweenOffset = 0;
-    for (unsigned int loop = 0; loop < subSpacerSize; loop++) {
-        betweenOffset += subSpacerList[loop].first - lastMax;
-        // count aminoacids between the spacers and the spacer itself
-        if ((n >= subSpacerList[loop].first) &&
-                (n <= subSpacerList[loop].second)) {
-            return ( dynamic_cast<AminoAcid&>
-                    (dynamic_cast<Spacer*>
-                    (components[betweenOffset])
-                    ->getAmino(n - subSpacerList[loop].first)));
-        }
-        if ((n >= lastMax) && (n < subSpacerList[loop].first)) {
-            if ((*components[n - idxOffset])
-                    .getClassName() != "AminoAcid")
-                ERROR("Component is not an aminoacid !", exception);
-            return (dynamic_cast<AminoAcid&>
-                    (*components[n - idxOffset])); // return aminoacid
-        }
-        lastMax = subSpacerList[loop].second;
-        idxOffset += lastMax - subSpacerList[loop].first;
-    }
-    if ((*components[n - idxOffset])
-            .getClassName() != "AminoAcid")
-        ERROR("The component is not an aminoacid !", exception);
-    return (dynamic_cast<AminoAcid&>
-            (*components[n - idxOffset])); // return aminoacid
+AminoAcid& Spacer::getAmino(unsigned int n) {
+    if (!aminoTableValid)
+        pBuildAminoTable();
+    PRECOND(n < aminoTable.size(), exception);
+    return *aminoTable[n];
 }
 
 /**
@@ -998,38 +1023,29 @@ AminoAcid& Spacer::getAmino(unsigned int n) { // needs to be recoded & optimized
  * @param n, AminoAcid index 
  * @return  aminoacid reference
  */
-const AminoAcid& Spacer::getAmino(unsigned int n) const { // needs to be recoded & optimized
+const AminoAcid& Spacer::getAmino(unsigned int n) const {
+    if (!aminoTableValid)
+        pBuildAminoTable();
+    PRECOND(n < aminoTable.size(), exception);
+    return *aminoTable[n];
+}
 
-    PRECOND(n < this->sizeAmino(), exception);
-    unsigned int idxOffset = 0;
-    unsigned int lastMax = 0;
-    unsigned int subSpacerSize = subSpacerList.size();
-    unsigned int betweenOffset = 0;
-    for (unsigned int loop = 0; loop < subSpacerSize; loop++) {
-        betweenOffset += subSpacerList[loop].first - lastMax;
-        // count aminoacids between the spacers and the spacer itself
-        if ((n >= subSpacerList[loop].first) &&
-                (n <= subSpacerList[loop].second)) {
-            return ( dynamic_cast<AminoAcid&>
-                    (dynamic_cast<Spacer*>
-                    (components[betweenOffset])
-                    ->getAmino(n - subSpacerList[loop].first)));
-        }
-        if ((n >= lastMax) && (n < subSpacerList[loop].first)) {
-            if ((*components[n - idxOffset])
-                    .getClassName() != "AminoAcid")
-                ERROR("Component is not an aminoacid !", exception);
-            return (dynamic_cast<AminoAcid&>
-                    (*components[n - idxOffset])); // return aminoacid
-        }
-        lastMax = subSpacerList[loop].second;
-        idxOffset += lastMax - subSpacerList[loop].first;
-    }
-    if ((*components[n - idxOffset])
-            .getClassName() != "AminoAcid")
-        ERROR("The component is not an aminoacid !", exception);
-    return (dynamic_cast<AminoAcid&>
-            (*components[n - idxOffset])); // return aminoacid
+/**
+ *   Returns the phi, psi, omega and chi angles of all amino acids. They
+ *                 are computed in one pass over the chain and kept until an
+ *                 atom is moved or the structure changes, so call it once
+ *                 before several threads read the same spacer.
+ * @param withChi, whether the chi angles are needed as well
+ * @return  torsion angles of the whole chain
+ */
+const SpacerDihedrals& Spacer::getDihedrals(bool withChi) {
+    if (dihedrals == NULL)
+        dihedrals = new SpacerDihedrals();
+    if (!dihedrals->isValid())
+        dihedrals->build(*this);
+    if (withChi && !dihedrals->hasChi())
+        dihedrals->buildChi(*this);
+    return *dihedrals;
 }
 
 /**
@@ -1257,6 +1273,7 @@ void Spacer::groupLikeStateCode() {
 
 void Spacer::updateSubSpacerList() {
     subSpacerList.clear();
+    pInvalidateAminoTable();
     pair < unsigned int, unsigned int > tmp;
     unsigned int countAA = 0;
     for (unsigned int n = 0; n < components.size(); n++) {
@@ -1273,6 +1290,41 @@ void Spacer::updateSubSpacerList() {
     }
 }
 
+/**
+ *   Marks the amino acid table of this spacer, and of the spacers it
+ *                 belongs to, as out of date.
+ */
+
+void Spacer::pInvalidateAminoTable() {
+    aminoTableValid = false;
+    if (dihedrals != NULL)
+        dihedrals->invalidate();
+    if (hasSuperior() && (getSuperior().getClassName() == "Spacer"))
+        dynamic_cast<Spacer&> (getSuperior()).pInvalidateAminoTable();
+}
+
+/**
+ *   Rebuilds the flat table of amino acids used by getAmino(). It is
+ *                 built on the first access after a change of structure, 
+ *                 so call getAmino() once before reading a modified 
+ *                 spacer from several threads.
+ */
+
+void Spacer::pBuildAminoTable() const {
+    aminoTable.clear();
+    for (unsigned int n = 0; n < components.size(); n++) {
+        if (components[n]->getClassName() == "AminoAcid")
+            aminoTable.push_back(dynamic_cast<AminoAcid*> (components[n]));
+        else if (components[n]->getClassName() == "Spacer") {
+            const Spacer* sub = dynamic_cast<const Spacer*> (components[n]);
+            for (unsigned int i = 0; i < sub->sizeAmino(); i++)
+                aminoTable.push_back(const_cast<AminoAcid*> (&sub->getAmino(i)));
+        } else
+            ERROR("The component is not an aminoacid !", exception);
+    }
+    aminoTableValid = true;
+}
+
 /**
  *   Set the state (HELIX or STRAND ...) from the string sec
  *                 which may be generated for example by DSSP.
@@ -31,6 +31,8 @@
 
 namespace Victor { namespace Biopool { 
 
+    class SpacerDihedrals;
+
     /**@brief Implements a "Spacer" for a protein chain. Includes methods to obtain values from the atoms and its pdb information.
      * 
      *  ***Attention*** The current implementation allows for "1 to 1" spacers,
@@ -86,6 +88,7 @@ namespace Victor { namespace Biopool {
 
         vector<pair<unsigned int, unsigned int> > getHelixData();
         vector<pair<unsigned int, unsigned int> > getStrandData();
+        const SpacerDihedrals& getDihedrals(bool withChi = false);
 
         // MODIFIERS:
 
@@ -147,6 +150,7 @@ namespace Victor { namespace Biopool {
         Spacer* splitSpacer(unsigned int index, unsigned int count);
 
         void copy(const Spacer& orig);
+        void swap(Spacer& other); // exchanges contents without copying
 
         void load(Loader& l); // data loader
 
@@ -211,6 +215,8 @@ namespace Victor { namespace Biopool {
         void modifySubSpacerList(Spacer*, int);
         void updateSubSpacerList();
         void getBackboneHbonds(); // backbone H bonds (for SS)
+        void pInvalidateAminoTable();
+        void pBuildAminoTable() const;
 
         // ATTRIBUTES
 
@@ -226,6 +232,10 @@ namespace Victor { namespace Biopool {
 
     private:
         vector<pair<unsigned int, unsigned int> > subSpacerList;
+        // flat list of all amino acids (incl. sub-spacers), rebuilt on demand
+        mutable vector<AminoAcid*> aminoTable;
+        mutable bool aminoTableValid;
+        SpacerDihedrals* dihedrals; // cached torsion angles, rebuilt on demand
     };
 
     // ---------------------------------------------------------------------------
@@ -258,6 +268,7 @@ namespace Victor { namespace Biopool {
      */
     inline void Spacer::removeComponent(Component* c) {
         Polymer::removeComponent(c);
+        pInvalidateAminoTable();
         setModified();
     }
 
@@ -267,6 +278,7 @@ namespace Victor { namespace Biopool {
      */
     inline void Spacer::removeComponentFromIndex(unsigned int i) {
         Polymer::removeComponentFromIndex(i);
+        pInvalidateAminoTable();
         setModified();
     }
 
@@ -275,6 +287,7 @@ namespace Victor { namespace Biopool {
      *@param c, pointer to the Component to delete
      */inline void Spacer::deleteComponent(Component* c) {
         Polymer::deleteComponent(c);
+        pInvalidateAminoTable();
         setModified();
     }
 
@@ -0,0 +1,189 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <SpacerCoordinates.h>
+#include <NeighbourGrid.h>
+#include <algorithm>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor;
+using namespace Victor::Biopool;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Builds an empty, invalid snapshot.
+ */
+SpacerCoordinates::SpacerCoordinates() : start(1, 0), source(NULL), first(0),
+last(0), valid(false) {
+}
+
+/**
+ *  Builds the snapshot of all residues of a Spacer.
+ *@param   spacer reference(Spacer&)
+ */
+SpacerCoordinates::SpacerCoordinates(Spacer& sp) : start(1, 0), source(NULL),
+first(0), last(0), valid(false) {
+    build(sp);
+}
+
+/**
+ *  Builds the snapshot of the residues [index1, index2) of a Spacer.
+ *@param   spacer reference(Spacer&), start and end positions (unsigned int,unsigned int)
+ */
+SpacerCoordinates::SpacerCoordinates(Spacer& sp, unsigned int index1,
+        unsigned int index2) : start(1, 0), source(NULL), first(0), last(0),
+valid(false) {
+    build(sp, index1, index2);
+}
+
+// PREDICATES:
+
+/**
+ *  Returns the residue an atom belongs to.
+ *@param   atom index (unsigned int)
+ *@return  residue index (unsigned int)
+ */
+unsigned int SpacerCoordinates::getAminoIndex(unsigned int n) const {
+    PRECOND(n < x.size(), exception);
+    return (upper_bound(start.begin(), start.end(), n) - start.begin()) - 1;
+}
+
+/**
+ *  Looks for an atom in a residue.
+ *@param   residue index (unsigned int), atom code (AtomCode)
+ *@return  atom index, -1 if the residue has no such atom (int)
+ */
+int SpacerCoordinates::findAtom(unsigned int r, AtomCode c) const {
+    PRECOND(r < aminoCode.size(), exception);
+    for (unsigned int i = start[r]; i < start[r + 1]; i++)
+        if (code[i] == c)
+            return i;
+    return -1;
+}
+
+/**
+ *  Calculates the RMSD, without superposition, of the atoms with the
+ *  given code to the same atoms of another snapshot. Residues are
+ *  matched by index; atoms missing in either snapshot are skipped.
+ *@param   other snapshot (const SpacerCoordinates&), atom code (AtomCode)
+ *@return  RMSD, 0 if no atoms are compared (double)
+ */
+double SpacerCoordinates::calculateRmsd(const SpacerCoordinates& other,
+        AtomCode c) const {
+    unsigned int n = (sizeAmino() < other.sizeAmino()) ? sizeAmino()
+            : other.sizeAmino();
+    double sum = 0.0;
+    unsigned int count = 0;
+    for (unsigned int r = 0; r < n; r++) {
+        int i = findAtom(r, c);
+        int j = other.findAtom(r, c);
+        if ((i < 0) || (j < 0))
+            continue;
+        double dx = x[i] - other.x[j];
+        double dy = y[i] - other.y[j];
+        double dz = z[i] - other.z[j];
+        sum += dx * dx + dy * dy + dz * dz;
+        count++;
+    }
+    return (count > 0) ? sqrt(sum / count) : 0.0;
+}
+
+/**
+ *  Counts the residue pairs whose atoms with the given code are closer
+ *  than the cutoff.
+ *@param   distance cutoff (double), atom code (AtomCode), minimum
+ *         separation along the sequence of the residues in a pair (unsigned int)
+ *@return  number of contacts (unsigned int)
+ */
+unsigned int SpacerCoordinates::countContacts(double cutoff, AtomCode c,
+        unsigned int minSeparation) const {
+    vector<vgVector3<double> > points;
+    vector<unsigned int> residue;
+    for (unsigned int r = 0; r < sizeAmino(); r++) {
+        int i = findAtom(r, c);
+        if (i < 0)
+            continue;
+        points.push_back(getCoords(i));
+        residue.push_back(r);
+    }
+
+    NeighbourGrid grid(points, cutoff);
+    unsigned int count = 0;
+    vector<unsigned int> neighbours;
+    for (unsigned int i = 0; i < points.size(); i++) {
+        grid.getNeighbours(points[i], neighbours);
+        for (unsigned int k = 0; k < neighbours.size(); k++)
+            if (residue[neighbours[k]] >= residue[i] + minSeparation)
+                count++;
+    }
+    return count;
+}
+
+// MODIFIERS:
+
+/**
+ *  Takes the snapshot of all residues of a Spacer.
+ *@param   spacer reference(Spacer&)
+ */
+void SpacerCoordinates::build(Spacer& sp) {
+    build(sp, 0, sp.sizeAmino());
+}
+
+/**
+ *  Takes the snapshot of the residues [index1, index2) of a Spacer.
+ *@param   spacer reference(Spacer&), start and end positions (unsigned int,unsigned int)
+ */
+void SpacerCoordinates::build(Spacer& sp, unsigned int index1,
+        unsigned int index2) {
+    PRECOND((index1 <= index2) && (index2 <= sp.sizeAmino()), exception);
+    source = &sp;
+    first = index1;
+    last = index2;
+
+    x.clear();
+    y.clear();
+    z.clear();
+    code.clear();
+    aminoCode.clear();
+    start.assign(1, 0);
+    for (unsigned int i = index1; i < index2; i++) {
+        AminoAcid& aa = sp.getAmino(i);
+        for (unsigned int j = 0; j < aa.size(); j++) {
+            vgVector3<double> c = aa[j].getCoords();
+            x.push_back(c.x);
+            y.push_back(c.y);
+            z.push_back(c.z);
+            code.push_back(aa[j].getCode());
+        }
+        start.push_back(x.size());
+        aminoCode.push_back(static_cast<AminoAcidCode> (aa.getCode()));
+    }
+    valid = true;
+}
+
+/**
+ *  Takes the snapshot again from the same Spacer and residue range.
+ */
+void SpacerCoordinates::rebuild() {
+    if (source == NULL)
+        ERROR("SpacerCoordinates::rebuild(): snapshot was never built.",
+            exception);
+    build(*source, first, last);
+}
@@ -0,0 +1,189 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _SPACERCOORDINATES_H_
+#define _SPACERCOORDINATES_H_
+
+// Includes:
+#include <vector>
+#include <Spacer.h>
+#include <AtomCode.h>
+#include <AminoAcidCode.h>
+
+namespace Victor { namespace Biopool { 
+
+    /**
+     * @brief Flat, read-only copy of the atom coordinates of a Spacer.
+     * 
+     *  Coordinates are stored as separate x, y, z arrays together with the
+     * atom codes; the atoms of residue r are [getAminoStart(r),
+     * getAminoEnd(r)), in the order of AminoAcid::operator[](unsigned int).
+     * The snapshot is not updated when the Spacer moves: call invalidate()
+     * when the coordinates change and rebuild() before using it again.
+     * */
+    class SpacerCoordinates {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        SpacerCoordinates();
+        SpacerCoordinates(Spacer& sp);
+        SpacerCoordinates(Spacer& sp, unsigned int index1, unsigned int index2);
+
+        virtual ~SpacerCoordinates() {
+            PRINT_NAME;
+        }
+
+        // PREDICATES:
+        bool isValid() const;
+        unsigned int sizeAmino() const;
+        unsigned int sizeAtoms() const;
+
+        double getX(unsigned int n) const;
+        double getY(unsigned int n) const;
+        double getZ(unsigned int n) const;
+        vgVector3<double> getCoords(unsigned int n) const;
+        AtomCode getCode(unsigned int n) const;
+        const vector<double>& getXs() const;
+        const vector<double>& getYs() const;
+        const vector<double>& getZs() const;
+
+        AminoAcidCode getAminoCode(unsigned int r) const;
+        unsigned int getAminoStart(unsigned int r) const;
+        unsigned int getAminoEnd(unsigned int r) const;
+        unsigned int getAminoIndex(unsigned int n) const;
+        int findAtom(unsigned int r, AtomCode code) const;
+
+        double getSqrDistance(unsigned int n, unsigned int m) const;
+        double calculateRmsd(const SpacerCoordinates& other,
+                AtomCode code = CA) const;
+        unsigned int countContacts(double cutoff, AtomCode code = CA,
+                unsigned int minSeparation = 3) const;
+
+        // MODIFIERS:
+        void build(Spacer& sp);
+        void build(Spacer& sp, unsigned int index1, unsigned int index2);
+        void rebuild();
+        void invalidate();
+
+        // OPERATORS:
+
+    protected:
+
+        // ATTRIBUTES:
+        vector<double> x, y, z;
+        vector<AtomCode> code;
+        vector<unsigned int> start; // atoms of residue r: [start[r], start[r+1])
+        vector<AminoAcidCode> aminoCode;
+        Spacer* source; // Spacer the snapshot was taken from
+        unsigned int first; // range of residues taken from the source
+        unsigned int last;
+        bool valid;
+
+    private:
+
+    };
+
+    // ---------------------------------------------------------------------------
+    //                               SpacerCoordinates
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline bool SpacerCoordinates::isValid() const {
+        return valid;
+    }
+
+    inline unsigned int SpacerCoordinates::sizeAmino() const {
+        return aminoCode.size();
+    }
+
+    inline unsigned int SpacerCoordinates::sizeAtoms() const {
+        return x.size();
+    }
+
+    inline double SpacerCoordinates::getX(unsigned int n) const {
+        PRECOND(n < x.size(), exception);
+        return x[n];
+    }
+
+    inline double SpacerCoordinates::getY(unsigned int n) const {
+        PRECOND(n < y.size(), exception);
+        return y[n];
+    }
+
+    inline double SpacerCoordinates::getZ(unsigned int n) const {
+        PRECOND(n < z.size(), exception);
+        return z[n];
+    }
+
+    inline vgVector3<double> SpacerCoordinates::getCoords(unsigned int n) const {
+        PRECOND(n < x.size(), exception);
+        return vgVector3<double>(x[n], y[n], z[n]);
+    }
+
+    inline AtomCode SpacerCoordinates::getCode(unsigned int n) const {
+        PRECOND(n < code.size(), exception);
+        return code[n];
+    }
+
+    inline const vector<double>& SpacerCoordinates::getXs() const {
+        return x;
+    }
+
+    inline const vector<double>& SpacerCoordinates::getYs() const {
+        return y;
+    }
+
+    inline const vector<double>& SpacerCoordinates::getZs() const {
+        return z;
+    }
+
+    inline AminoAcidCode SpacerCoordinates::getAminoCode(unsigned int r) const {
+        PRECOND(r < aminoCode.size(), exception);
+        return aminoCode[r];
+    }
+
+    inline unsigned int SpacerCoordinates::getAminoStart(unsigned int r) const {
+        PRECOND(r < aminoCode.size(), exception);
+        return start[r];
+    }
+
+    inline unsigned int SpacerCoordinates::getAminoEnd(unsigned int r) const {
+        PRECOND(r < aminoCode.size(), exception);
+        return start[r + 1];
+    }
+
+    inline double SpacerCoordinates::getSqrDistance(unsigned int n,
+            unsigned int m) const {
+        PRECOND((n < x.size()) && (m < x.size()), exception);
+        double dx = x[n] - x[m];
+        double dy = y[n] - y[m];
+        double dz = z[n] - z[m];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // MODIFIERS:
+
+    /**
+     *  Marks the snapshot as out of date, eg. after the Spacer was moved.
+     */
+    inline void SpacerCoordinates::invalidate() {
+        valid = false;
+    }
+
+}} // namespace
+#endif //_SPACERCOORDINATES_H_
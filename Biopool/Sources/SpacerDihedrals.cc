@@ -0,0 +1,215 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <SpacerDihedrals.h>
+#include <IntCoordConverter.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor;
+using namespace Victor::Biopool;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Builds an empty, invalid snapshot.
+ */
+SpacerDihedrals::SpacerDihedrals() : version(0), valid(false) {
+}
+
+/**
+ *  Builds phi, psi and omega of all residues of a Spacer.
+ *@param   spacer reference(Spacer&)
+ */
+SpacerDihedrals::SpacerDihedrals(Spacer& sp) : version(0), valid(false) {
+    build(sp);
+}
+
+// MODIFIERS:
+
+/**
+ *  Computes phi, psi and omega of all residues of a Spacer. Residues
+ *  which are not bonded to their neighbour in the Spacer, or which lack
+ *  a backbone atom, fall back to AminoAcid::getPhi(true) etc.
+ *  The chi angles are only computed by buildChi().
+ *@param   spacer reference(Spacer&)
+ */
+void SpacerDihedrals::build(Spacer& sp) {
+    version = Atom::getModificationCount();
+    const unsigned int n = sp.sizeAmino();
+
+    // backbone trace: N, CA, C of residue r are the points 3r, 3r+1, 3r+2
+    tx.clear();
+    ty.clear();
+    tz.clear();
+    vector<bool> complete(n, false);
+    for (unsigned int r = 0; r < n; r++) {
+        AminoAcid& aa = sp.getAmino(r);
+        Atom* bb[3] = {sFindAtom(aa, N, 0), sFindAtom(aa, CA, 1),
+            sFindAtom(aa, C, 2)};
+        complete[r] = (bb[0] != NULL) && (bb[1] != NULL) && (bb[2] != NULL);
+        for (unsigned int i = 0; i < 3; i++)
+            if (complete[r])
+                pAddTracePoint(*bb[i]);
+            else {
+                tx.push_back(0.0);
+                ty.push_back(0.0);
+                tz.push_back(0.0);
+            }
+    }
+    vector<double> t((n > 1) ? 3 * n - 3 : 1, 0.0);
+    if (n > 1)
+        sCalculateTorsions(tx, ty, tz, 0, 3 * n - 3, &t[0]);
+
+    phi.resize(n);
+    psi.resize(n);
+    omega.resize(n);
+    for (unsigned int r = 0; r < n; r++) {
+        AminoAcid& aa = sp.getAmino(r);
+        bool in = (r > 0) && complete[r - 1] && complete[r]
+                && aa.sizeInBonds() && (&aa.getInBond(0) == &sp.getAmino(r - 1));
+        bool out = (r + 1 < n) && complete[r] && complete[r + 1]
+                && aa.sizeOutBonds() && (&aa.getOutBond(0) == &sp.getAmino(r + 1));
+
+        phi[r] = in ? t[3 * r - 1] : aa.getPhi(true);
+        psi[r] = out ? t[3 * r] : aa.getPsi(true);
+        omega[r] = out ? t[3 * r + 1] : aa.getOmega(true);
+    }
+
+    chi.clear();
+    chiStart.clear();
+    valid = true;
+}
+
+/**
+ *  Computes the chi angles of all residues of the Spacer the snapshot
+ *  was built from. The chi angles of incomplete side chains are set to 999.
+ *@param   spacer reference(Spacer&)
+ */
+void SpacerDihedrals::buildChi(Spacer& sp) {
+    PRECOND(sp.sizeAmino() == phi.size(), exception);
+    const unsigned int n = sp.sizeAmino();
+
+    // side chain traces: N, CA, CB, first G, D, E, Z, H atom
+    chi.clear();
+    chiStart.assign(1, 0);
+    for (unsigned int r = 0; r < n; r++) {
+        SideChain& sc = sp.getAmino(r).getSideChain();
+        unsigned int m = sc.getMaxChi();
+        if ((m > 0) && (sc.size() > 1) && (sc.getBackboneRef() != NULL)
+                && sc.getBackboneRef()->isMember(N)
+                && sc.getBackboneRef()->isMember(CA) && sc.hasB()
+                && sc.hasG() && ((m < 2) || sc.hasD()) && ((m < 3) || sc.hasE())
+                && ((m < 4) || sc.hasZ()) && ((m < 5) || sc.hasH())) {
+            tx.clear();
+            ty.clear();
+            tz.clear();
+            pAddTracePoint((*sc.getBackboneRef())[N]);
+            pAddTracePoint((*sc.getBackboneRef())[CA]);
+            pAddTracePoint(sc[CB]);
+            pAddTracePoint(sc.firstG());
+            if (m > 1)
+                pAddTracePoint(sc.firstD());
+            if (m > 2)
+                pAddTracePoint(sc.firstE());
+            if (m > 3)
+                pAddTracePoint(sc.firstZ());
+            if (m > 4)
+                pAddTracePoint(sc.firstH());
+            chi.resize(chi.size() + m);
+            sCalculateTorsions(tx, ty, tz, 0, m, &chi[chi.size() - m]);
+        } else
+            for (unsigned int i = 0; i < m; i++)
+                chi.push_back(999.0); // as SideChain without atoms
+        chiStart.push_back(chi.size());
+    }
+}
+
+// HELPERS:
+
+/**
+ *  Torsion angles of consecutive quadruples of points, with the same 
+ *  arithmetic as IntCoordConverter::getTorsionAngle().
+ *@param   point coordinates (const vector<double>& x3), quadruples to 
+ *         compute, starting at points [from, to) (unsigned int, unsigned int),
+ *         output array of to - from angles in degrees (double*)
+ */
+void SpacerDihedrals::sCalculateTorsions(const vector<double>& tx,
+        const vector<double>& ty, const vector<double>& tz, unsigned int from,
+        unsigned int to, double* out) {
+    PRECOND(to + 3 <= tx.size(), exception);
+    for (unsigned int k = from; k < to; k++) {
+        double b1x = tx[k] - tx[k + 1];
+        double b1y = ty[k] - ty[k + 1];
+        double b1z = tz[k] - tz[k + 1];
+        double b2x = tx[k + 1] - tx[k + 2];
+        double b2y = ty[k + 1] - ty[k + 2];
+        double b2z = tz[k + 1] - tz[k + 2];
+        double b3x = tx[k + 2] - tx[k + 3];
+        double b3y = ty[k + 2] - ty[k + 3];
+        double b3z = tz[k + 2] - tz[k + 3];
+
+        double c1x = b1y * b2z - b1z * b2y;
+        double c1y = b1z * b2x - b1x * b2z;
+        double c1z = b1x * b2y - b1y * b2x;
+        double c2x = b2y * b3z - b2z * b3y;
+        double c2y = b2z * b3x - b2x * b3z;
+        double c2z = b2x * b3y - b2y * b3x;
+        double c3x = c1y * c2z - c1z * c2y;
+        double c3y = c1z * c2x - c1x * c2z;
+        double c3z = c1x * c2y - c1y * c2x;
+
+        long double d = (c1x * c2x + c1y * c2y + c1z * c2z)
+                / (sqrt(c1x * c1x + c1y * c1y + c1z * c1z)
+                * sqrt(c2x * c2x + c2y * c2y + c2z * c2z));
+        if (d > 1.0)
+            d = 1.0;
+        else if (d < -1.0)
+            d = -1.0;
+        double ang = acos(d);
+
+        if (b2x * c3x + b2y * c3y + b2z * c3z > 0.0)
+            ang = -ang;
+        out[k - from] = RAD2DEG * ang;
+    }
+}
+
+/**
+ *  Returns the atom of an amino acid, looking first at the position where
+ *  the loaders put it.
+ *@param   amino acid reference (AminoAcid&), atom code (AtomCode), 
+ *         expected index (unsigned int)
+ *@return  pointer to the atom, NULL if missing (Atom*)
+ */
+Atom* SpacerDihedrals::sFindAtom(AminoAcid& aa, AtomCode code,
+        unsigned int hint) {
+    if ((hint < aa.size()) && (aa[hint].getCode() == code))
+        return &aa[hint];
+    return aa.isMember(code) ? &aa[code] : NULL;
+}
+
+/**
+ *  Appends the coordinates of an atom to the trace.
+ *@param   atom reference (Atom&)
+ */
+void SpacerDihedrals::pAddTracePoint(Atom& at) {
+    vgVector3<double> c = at.getCoords();
+    tx.push_back(c.x);
+    ty.push_back(c.y);
+    tz.push_back(c.z);
+}
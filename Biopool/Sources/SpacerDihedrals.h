@@ -0,0 +1,160 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _SPACERDIHEDRALS_H_
+#define _SPACERDIHEDRALS_H_
+
+// Includes:
+#include <vector>
+#include <Spacer.h>
+
+namespace Victor { namespace Biopool { 
+
+    /**
+     * @brief Backbone and side chain torsion angles of all residues of a 
+     * Spacer, in degrees.
+     * 
+     *  The N, CA and C atoms of the chain are copied into one flat trace, so
+     * that phi, psi and omega of every residue are the torsions of
+     * consecutive quadruples of the trace and are computed in a single loop.
+     * The chi angles are computed the same way from the side chain trace
+     * of each residue, but only by buildChi(). The values equal those of AminoAcid::getPhi(true),
+     * getPsi(true), getOmega(true) and of a freshly calculated chi.
+     * 
+     *  The snapshot records Atom::getModificationCount() and is no longer 
+     * valid once any atom was modified; Spacer::getDihedrals() keeps one 
+     * up to date.
+     * */
+    class SpacerDihedrals {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        SpacerDihedrals();
+        SpacerDihedrals(Spacer& sp);
+
+        virtual ~SpacerDihedrals() {
+            PRINT_NAME;
+        }
+
+        // PREDICATES:
+        bool isValid() const;
+        bool hasChi() const;
+        unsigned int sizeAmino() const;
+
+        double getPhi(unsigned int r) const;
+        double getPsi(unsigned int r) const;
+        double getOmega(unsigned int r) const;
+        unsigned int sizeChi(unsigned int r) const;
+        double getChi(unsigned int r, unsigned int n) const;
+        const vector<double>& getPhis() const;
+        const vector<double>& getPsis() const;
+        const vector<double>& getOmegas() const;
+
+        // MODIFIERS:
+        void build(Spacer& sp);
+        void buildChi(Spacer& sp);
+        void invalidate();
+
+        // OPERATORS:
+
+    protected:
+
+        // HELPERS:
+        static void sCalculateTorsions(const vector<double>& tx,
+                const vector<double>& ty, const vector<double>& tz,
+                unsigned int from, unsigned int to, double* out);
+        static Atom* sFindAtom(AminoAcid& aa, AtomCode code, unsigned int hint);
+        void pAddTracePoint(Atom& at);
+
+        // ATTRIBUTES:
+        vector<double> phi, psi, omega;
+        vector<double> chi; // chi angles of residue r: [chiStart[r], chiStart[r+1])
+        vector<unsigned int> chiStart;
+        vector<double> tx, ty, tz; // trace the torsions are computed from
+        unsigned long version; // Atom::getModificationCount() when built
+        bool valid;
+
+    private:
+
+    };
+
+    // ---------------------------------------------------------------------------
+    //                               SpacerDihedrals
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline bool SpacerDihedrals::isValid() const {
+        return valid && (version == Atom::getModificationCount());
+    }
+
+    inline bool SpacerDihedrals::hasChi() const {
+        return chiStart.size() == phi.size() + 1;
+    }
+
+    inline unsigned int SpacerDihedrals::sizeAmino() const {
+        return phi.size();
+    }
+
+    inline double SpacerDihedrals::getPhi(unsigned int r) const {
+        PRECOND(r < phi.size(), exception);
+        return phi[r];
+    }
+
+    inline double SpacerDihedrals::getPsi(unsigned int r) const {
+        PRECOND(r < psi.size(), exception);
+        return psi[r];
+    }
+
+    inline double SpacerDihedrals::getOmega(unsigned int r) const {
+        PRECOND(r < omega.size(), exception);
+        return omega[r];
+    }
+
+    inline unsigned int SpacerDihedrals::sizeChi(unsigned int r) const {
+        PRECOND(hasChi() && (r < phi.size()), exception);
+        return chiStart[r + 1] - chiStart[r];
+    }
+
+    inline double SpacerDihedrals::getChi(unsigned int r, unsigned int n) const {
+        PRECOND(n < sizeChi(r), exception);
+        return chi[chiStart[r] + n];
+    }
+
+    inline const vector<double>& SpacerDihedrals::getPhis() const {
+        return phi;
+    }
+
+    inline const vector<double>& SpacerDihedrals::getPsis() const {
+        return psi;
+    }
+
+    inline const vector<double>& SpacerDihedrals::getOmegas() const {
+        return omega;
+    }
+
+    // MODIFIERS:
+
+    /**
+     *  Marks the snapshot as out of date, eg. after residues were inserted.
+     */
+    inline void SpacerDihedrals::invalidate() {
+        valid = false;
+    }
+
+}} // namespace
+#endif //_SPACERDIHEDRALS_H_
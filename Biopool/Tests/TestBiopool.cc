@@ -13,6 +13,11 @@
 #include <TestGroup.h>
 #include <TestAminoAcid.h>
 #include <TestSpacer.h>
+#include <TestNeighbourGrid.h>
+#include <TestSpacerCoordinates.h>
+#include <TestSpacerDihedrals.h>
+#include <TestResidueGrid.h>
+#include <TestPdbLoader.h>
 using namespace std;
 
 
@@ -24,6 +29,11 @@ int main() {
         runner.addTest(TestGroup::suite());
         runner.addTest(TestAminoAcid::suite());
         runner.addTest(TestSpacer::suite());
+        runner.addTest(TestNeighbourGrid::suite());
+        runner.addTest(TestSpacerCoordinates::suite());
+        runner.addTest(TestSpacerDihedrals::suite());
+        runner.addTest(TestResidueGrid::suite());
+        runner.addTest(TestPdbLoader::suite());
 	cout<< "Running the unit tests."<<endl;
 	runner.run();
 
@@ -43,6 +43,9 @@ public:
         suiteOfTests->addTest(new CppUnit::TestCaller<TestGroup>("Calculate the distance between the two loaded atoms.",
         	&TestGroup::testTestGroup_C));
 
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestGroup>("Test4 - atom lookup by code follows group and atom changes.",
+                &TestGroup::testTestGroup_D));
+
         return suiteOfTests;
     }
 
@@ -144,6 +147,31 @@ protected:
         cout << endl << "Solution is: distance =" <<  calculatedDistance<< endl;
         CPPUNIT_ASSERT(distance==calculatedDistance);
       }
-    
+
+    void testTestGroup_D() {
+        // lookup by code after adding, renaming and removing atoms
+        Group group1;
+        Atom atom0;
+        atom0.setType("N");
+        atom0.setNumber(1);
+        group1.addAtom(atom0);
+        atom0.setType("CA");
+        atom0.setNumber(2);
+        atom0.setCoords(0, 0, 1.46);
+        group1.addAtom(atom0);
+        atom0.setType("CA");
+        atom0.setNumber(3);
+        atom0.setCoords(9, 9, 9);
+        group1.addAtom(atom0);
+        CPPUNIT_ASSERT(group1.isMember(N) && group1.isMember(CA) && !group1.isMember(C));
+        // duplicate codes resolve to the first atom
+        CPPUNIT_ASSERT(group1[CA].getCoords().z == 1.46);
+
+        group1[0].setType("C");
+        CPPUNIT_ASSERT(!group1.isMember(N) && group1.isMember(C));
+
+        group1.removeAtom(group1[1]);
+        CPPUNIT_ASSERT((group1.size() == 2) && (group1[CA].getCoords().z == 9));
+    }
 
 };
@@ -0,0 +1,75 @@
+/*
+ * TestNeighbourGrid.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <iostream>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <NeighbourGrid.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+class TestNeighbourGrid : public CppUnit::TestFixture {
+private:
+	vector<vgVector3<double> > points;
+public:
+	TestNeighbourGrid() {}
+	virtual ~TestNeighbourGrid() {}
+
+	static CppUnit::Test *suite() {
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestNeighbourGrid");
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestNeighbourGrid>("Test1 - neighbours as with all pairs.",
+				&TestNeighbourGrid::testNeighbourGrid_neighbours ));
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestNeighbourGrid>("Test2 - query outside the grid.",
+				&TestNeighbourGrid::testNeighbourGrid_outside ));
+
+		return suiteOfTests;
+	}
+
+	/// Setup method
+	void setUp() {
+		// points on a distorted lattice, 3 A apart
+		points.clear();
+		for (unsigned int i = 0; i < 8; i++)
+			for (unsigned int j = 0; j < 8; j++)
+				for (unsigned int k = 0; k < 8; k++)
+					points.push_back(vgVector3<double>(3.0 * i + 0.1 * j,
+						3.0 * j + 0.1 * k, 3.0 * k + 0.1 * i));
+	}
+
+	/// Teardown method
+	void tearDown() {}
+
+protected:
+	void testNeighbourGrid_neighbours() {
+		NeighbourGrid grid(points, 5.0);
+		vector<unsigned int> res;
+		for (unsigned int i = 0; i < points.size(); i++) {
+			vector<unsigned int> expected;
+			for (unsigned int j = 0; j < points.size(); j++)
+				if ((points[j] - points[i]).length() < 5.0)
+					expected.push_back(j);
+			grid.getNeighbours(points[i], res);
+			CPPUNIT_ASSERT( res == expected );
+			CPPUNIT_ASSERT( grid.countNeighbours(points[i]) == expected.size() );
+		}
+	}
+
+	void testNeighbourGrid_outside() {
+		NeighbourGrid grid(points, 5.0);
+		vector<unsigned int> res;
+		grid.getNeighbours(vgVector3<double>(-4.0, 0.0, 0.0), res);
+		CPPUNIT_ASSERT( (res.size() == 1) && (res[0] == 0) );
+		grid.getNeighbours(vgVector3<double>(100.0, 100.0, 100.0), res);
+		CPPUNIT_ASSERT( res.empty() );
+	}
+};
@@ -0,0 +1,188 @@
+/*
+ * TestPdbLoader.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <Protein.h>
+#include <PdbLoader.h>
+#include <PdbAtomRecord.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+/// stream buffer without positioning, like a pipe
+class NonSeekableBuf : public streambuf {
+public:
+	NonSeekableBuf(const string& _data) : data(_data) {
+		setg(&data[0], &data[0], &data[0] + data.size());
+	}
+private:
+	string data;
+};
+
+class TestPdbLoader : public CppUnit::TestFixture {
+private:
+	string text; // 3DFR as chain A, then again as chain B
+public:
+	TestPdbLoader() {}
+	virtual ~TestPdbLoader() {}
+
+	static CppUnit::Test *suite() {
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestPdbLoader");
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestPdbLoader>("Test1 - chains of a seekable stream.",
+				&TestPdbLoader::testPdbLoader_chains ));
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestPdbLoader>("Test2 - loading from a non-seekable stream.",
+				&TestPdbLoader::testPdbLoader_nonSeekable ));
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestPdbLoader>("Test3 - fixed column atom records.",
+				&TestPdbLoader::testPdbLoader_atomRecord ));
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestPdbLoader>("Test4 - coordinates only loading.",
+				&TestPdbLoader::testPdbLoader_coordinatesOnly ));
+
+		return suiteOfTests;
+	}
+
+	/// Setup method
+	void setUp() {
+		string path = getenv("VICTOR_ROOT");
+		string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+		ifstream inFile(inputFile.c_str());
+		if (!inFile)
+			ERROR("File not found.", exception);
+		string line, chainB;
+		text = "";
+		while (getline(inFile, line)) {
+			text += line + "\n";
+			if ((line.substr(0, 4) == "ATOM") && (line.size() > 21)) {
+				line[21] = 'B';
+				chainB += line + "\n";
+			}
+		}
+		text += chainB;
+	}
+
+	/// Teardown method
+	void tearDown() {}
+
+protected:
+	void testPdbLoader_chains() {
+		istringstream in(text);
+		PdbLoader pl(in);
+		pl.setNoVerbose();
+		pl.setNoHAtoms();
+		pl.setAllChains();
+		vector<char> chains = pl.getAllChains();
+		CPPUNIT_ASSERT( (chains.size() == 2) && (chains[0] == 'A') && (chains[1] == 'B') );
+		CPPUNIT_ASSERT( pl.getMaxModels() == 0 );
+
+		// the input is rewound after the scan
+		Protein prot;
+		prot.load(pl);
+		CPPUNIT_ASSERT( prot.sizeProtein() == 2 );
+		CPPUNIT_ASSERT( prot.getSpacer('A')->sizeAmino() == prot.getSpacer('B')->sizeAmino() );
+		CPPUNIT_ASSERT( prot.getSpacer('A')->sizeAmino() > 0 );
+		CPPUNIT_ASSERT( prot.getLigandSet('A') != NULL );
+		CPPUNIT_ASSERT( prot.getLigandSet('B') == NULL );
+	}
+
+	void testPdbLoader_nonSeekable() {
+		istringstream in(text);
+		PdbLoader pl(in);
+		pl.setNoVerbose();
+		pl.setNoHAtoms();
+		pl.setChain('B');
+		Protein prot;
+		prot.load(pl);
+
+		NonSeekableBuf buf(text);
+		istream pipe(&buf);
+		PdbLoader pl2(pipe);
+		pl2.setNoVerbose();
+		pl2.setNoHAtoms();
+		pl2.setChain('B');
+		Protein prot2;
+		prot2.load(pl2);
+
+		CPPUNIT_ASSERT( (prot.sizeProtein() == 1) && (prot2.sizeProtein() == 1) );
+		Spacer& sp = *prot.getSpacer('B');
+		Spacer& sp2 = *prot2.getSpacer('B');
+		CPPUNIT_ASSERT( sp.sizeAmino() == sp2.sizeAmino() );
+		for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
+			CPPUNIT_ASSERT( sp.getAmino(i).size() == sp2.getAmino(i).size() );
+			CPPUNIT_ASSERT( sp.getAmino(i)[CA].getCoords() == sp2.getAmino(i)[CA].getCoords() );
+		}
+	}
+
+	void testPdbLoader_atomRecord() {
+		PdbAtomRecord rec;
+		string line = "ATOM   1234 HD21AASN B 103A    -12.345   6.780 100.001  0.50 23.45           H";
+		CPPUNIT_ASSERT( rec.parse(line.c_str(), line.size()) );
+		CPPUNIT_ASSERT( !rec.hetAtom );
+		CPPUNIT_ASSERT( rec.serial == 1234 );
+		CPPUNIT_ASSERT( string(rec.atomName) == "HD21A" );
+		CPPUNIT_ASSERT( string(rec.resName) == "ASN" );
+		CPPUNIT_ASSERT( (rec.chainID == 'B') && (rec.resSeq == 103) && (rec.iCode == 'A') );
+		CPPUNIT_ASSERT( fabs(rec.coords.x + 12.345) < 1e-9 );
+		CPPUNIT_ASSERT( fabs(rec.coords.y - 6.78) < 1e-9 );
+		CPPUNIT_ASSERT( fabs(rec.coords.z - 100.001) < 1e-9 );
+		CPPUNIT_ASSERT( fabs(rec.bFac - 23.45) < 1e-9 );
+
+		// short HETATM line without B-factor, negative residue number
+		line = "HETATM   12  O   HOH A  -5       1.000  -2.500   0.125";
+		CPPUNIT_ASSERT( rec.parse(line.c_str(), line.size()) );
+		CPPUNIT_ASSERT( rec.hetAtom && (rec.serial == 12) && (rec.resSeq == -5) );
+		CPPUNIT_ASSERT( (string(rec.atomName) == "O") && (string(rec.resName) == "HOH") );
+		CPPUNIT_ASSERT( rec.coords.z == 0.125 );
+		CPPUNIT_ASSERT( rec.bFac == 0.0 );
+
+		line = "REMARK   1 ATOM";
+		CPPUNIT_ASSERT( !rec.parse(line.c_str(), line.size()) );
+	}
+
+	void testPdbLoader_coordinatesOnly() {
+		istringstream in(text);
+		PdbLoader pl(in);
+		pl.setNoVerbose();
+		pl.setNoHAtoms();
+		Protein prot;
+		prot.load(pl);
+
+		istringstream in2(text);
+		PdbLoader pl2(in2);
+		pl2.setNoVerbose();
+		pl2.setCoordinatesOnly();
+		Protein prot2;
+		prot2.load(pl2);
+
+		// same atoms at the same absolute positions, but no bonds
+		Spacer& sp = *prot.getSpacer('A');
+		Spacer& sp2 = *prot2.getSpacer('A');
+		CPPUNIT_ASSERT( sp.sizeAmino() == sp2.sizeAmino() );
+		for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
+			AminoAcid& aa = sp.getAmino(i);
+			AminoAcid& aa2 = sp2.getAmino(i);
+			CPPUNIT_ASSERT( (aa.size() == aa2.size())
+				&& (aa.getSideChain().size() == aa2.getSideChain().size()) );
+			for (unsigned int j = 0; j < aa.size(); j++)
+				CPPUNIT_ASSERT( (aa[j].getCoords() - aa2[j].getCoords()).length() < 1e-9 );
+			for (unsigned int j = 0; j < aa.getSideChain().size(); j++)
+				CPPUNIT_ASSERT( (aa.getSideChain()[j].getCoords()
+					- aa2.getSideChain()[j].getCoords()).length() < 1e-9 );
+		}
+		CPPUNIT_ASSERT( sp.getAmino(1)[N].sizeInBonds() == 1 );
+		CPPUNIT_ASSERT( sp2.getAmino(1)[N].sizeInBonds() == 0 );
+	}
+};
@@ -0,0 +1,110 @@
+/*
+ * TestResidueGrid.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <ResidueGrid.h>
+#include <SolvExpos.h>
+#include <Protein.h>
+#include <PdbLoader.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+class TestResidueGrid : public CppUnit::TestFixture {
+private:
+	Protein prot;
+public:
+	TestResidueGrid() {}
+	virtual ~TestResidueGrid() {}
+
+	static CppUnit::Test *suite() {
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestResidueGrid");
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestResidueGrid>("Test1 - candidates include all residues in range.",
+				&TestResidueGrid::testResidueGrid_candidates ));
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestResidueGrid>("Test2 - SolvExpos counts as with a loop over the chain.",
+				&TestResidueGrid::testResidueGrid_solvExpos ));
+
+		return suiteOfTests;
+	}
+
+	/// Setup method
+	void setUp() {
+		string path = getenv("VICTOR_ROOT");
+		string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+		ifstream inFile(inputFile.c_str());
+		if (!inFile)
+			ERROR("File not found.", exception);
+		PdbLoader pl(inFile);
+		pl.setNoVerbose();
+		pl.setNoHAtoms();
+		prot.load(pl);
+	}
+
+	/// Teardown method
+	void tearDown() {}
+
+protected:
+	void testResidueGrid_candidates() {
+		Spacer& sp = *prot.getSpacer((unsigned int)0);
+		vector<Atom*> atoms(sp.sizeAmino(), static_cast<Atom*> (NULL));
+		for (unsigned int r = 0; r < sp.sizeAmino(); r += 2)
+			atoms[r] = &sp.getAmino(r)[CA];
+		ResidueGrid grid(8.0);
+		grid.build(sp, atoms);
+		CPPUNIT_ASSERT( grid.isValid(sp) );
+
+		vector<unsigned int> cand;
+		for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
+			vgVector3<double> pos = sp.getAmino(i)[CA].getCoords();
+			grid.getCandidates(pos, cand);
+			for (unsigned int k = 1; k < cand.size(); k++)
+				CPPUNIT_ASSERT( cand[k - 1] < cand[k] );
+			for (unsigned int k = 0; k < cand.size(); k++)
+				CPPUNIT_ASSERT( grid.getAtom(cand[k]) != NULL );
+			for (unsigned int r = 0; r < sp.sizeAmino(); r += 2)
+				if (sp.getAmino(i)[CA].distance(sp.getAmino(r)[CA]) <= 8.0)
+					CPPUNIT_ASSERT( find(cand.begin(), cand.end(), r) != cand.end() );
+		}
+
+		Atom& at = sp.getAmino(10)[CA];
+		at.setCoords(at.getCoords() + vgVector3<double>(0.0, 1.0, 0.0));
+		CPPUNIT_ASSERT( !grid.isValid(sp) );
+	}
+
+	void testResidueGrid_solvExpos() {
+		Spacer& sp = *prot.getSpacer((unsigned int)0);
+		SolvExpos se;
+		for (unsigned int round = 0; round < 2; round++) {
+			for (unsigned int t = 0; t < sp.sizeAmino(); t++) {
+				Atom& tr = se.getReprAtom(sp.getAmino(t));
+				unsigned int all = 0, part = 0;
+				for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+					if (tr.distance(se.getReprAtom(sp.getAmino(i))) <= 10.0) {
+						all++;
+						if ((i >= 20) && (i < 60))
+							part++;
+					}
+				CPPUNIT_ASSERT( se.getNumNeighbours(sp, t, 0, sp.sizeAmino()) == all - 1 );
+				CPPUNIT_ASSERT( se.getNumNeighbours(sp, t, 20, 60)
+						== (((t >= 20) && (t < 60)) ? part - 1 : part) );
+			}
+			// the grid has to follow moved atoms
+			for (unsigned int r = 0; r < sp.sizeAmino(); r += 5) {
+				Atom& at = sp.getAmino(r)[CA];
+				at.setCoords(at.getCoords() + vgVector3<double>(3.0, 0.0, -2.0));
+			}
+		}
+	}
+};
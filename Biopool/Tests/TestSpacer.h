@@ -43,6 +43,12 @@ public:
         suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test3 - loading amino acids from pdb without chain.",
                 &TestSpacer::testTestSpacer_C));
 
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test4 - amino acid index after split and merge.",
+                &TestSpacer::testTestSpacer_D));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacer>("Test5 - copy and swap.",
+                &TestSpacer::testTestSpacer_E));
+
         return suiteOfTests;
     }
 
@@ -126,4 +132,81 @@ protected:
     }
 
 
+    void testTestSpacer_D() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        Spacer* sp = prot.getSpacer((unsigned int) 0);
+        vector<AminoAcid*> order;
+        for (unsigned int i = 0; i < sp->sizeAmino(); i++)
+            order.push_back(&sp->getAmino(i));
+
+        // residues 10-19 and 40-59 move into sub-spacers
+        sp->splitSpacer(40, 59);
+        sp->splitSpacer(10, 19);
+        CPPUNIT_ASSERT(sp->sizeSpacer() == 2);
+        CPPUNIT_ASSERT(sp->sizeAmino() == order.size());
+        for (unsigned int i = 0; i < order.size(); i++)
+            CPPUNIT_ASSERT(&sp->getAmino(i) == order[i]);
+
+        // removing a residue of a sub-spacer shifts the following ones
+        Spacer& sub = sp->getSpacer(0);
+        sub.removeComponent(&sub.getAmino(0));
+        CPPUNIT_ASSERT(&sp->getAmino(10) == order[11]);
+        CPPUNIT_ASSERT(&sp->getAmino(order.size() - 2) == order[order.size() - 1]);
+        delete order[10];
+        order.erase(order.begin() + 10);
+
+        sp->makeFlat();
+        CPPUNIT_ASSERT(sp->sizeSpacer() == 0);
+        for (unsigned int i = 0; i < order.size(); i++)
+            CPPUNIT_ASSERT(&sp->getAmino(i) == order[i]);
+    }
+
+    void testTestSpacer_E() {
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        prot.load(pl);
+        Spacer& sp = *prot.getSpacer((unsigned int) 0);
+
+        // the copy has the same atoms and bonds, orig keeps its bonds
+        Spacer copy(sp);
+        CPPUNIT_ASSERT(copy.sizeAmino() == sp.sizeAmino());
+        for (unsigned int i = 1; i < sp.sizeAmino(); i++) {
+            CPPUNIT_ASSERT(&sp.getAmino(i)[N].getInBond(0) == &sp.getAmino(i - 1)[C]);
+            CPPUNIT_ASSERT(&copy.getAmino(i)[N].getInBond(0) == &copy.getAmino(i - 1)[C]);
+            CPPUNIT_ASSERT(&copy.getAmino(i)[CA].getInBond(0) == &copy.getAmino(i)[N]);
+            CPPUNIT_ASSERT(copy.getAmino(i)[CA].getNumber() == sp.getAmino(i)[CA].getNumber());
+            CPPUNIT_ASSERT(copy.getAmino(i).size() == sp.getAmino(i).size());
+            CPPUNIT_ASSERT((copy.getAmino(i)[CA].getCoords() - sp.getAmino(i)[CA].getCoords()).length() < 1e-9);
+        }
+
+        // swap exchanges the residues without copying them
+        Spacer other;
+        AminoAcid* first = &copy.getAmino(0);
+        unsigned int n = copy.sizeAmino();
+        other.swap(copy);
+        CPPUNIT_ASSERT((copy.sizeAmino() == 0) && (other.sizeAmino() == n));
+        CPPUNIT_ASSERT(&other.getAmino(0) == first);
+        CPPUNIT_ASSERT(&other.getAmino(0).getSuperior() == &other);
+        CPPUNIT_ASSERT(other.getStartOffset() == sp.getStartOffset());
+        CPPUNIT_ASSERT((other.getAmino(n - 1)[CA].getCoords() - sp.getAmino(n - 1)[CA].getCoords()).length() < 1e-9);
+    }
+
+
 };
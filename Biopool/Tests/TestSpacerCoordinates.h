@@ -0,0 +1,110 @@
+/*
+ * TestSpacerCoordinates.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <iostream>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <SpacerCoordinates.h>
+#include <Protein.h>
+#include <PdbLoader.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+class TestSpacerCoordinates : public CppUnit::TestFixture {
+private:
+	Protein prot;
+public:
+	TestSpacerCoordinates() {}
+	virtual ~TestSpacerCoordinates() {}
+
+	static CppUnit::Test *suite() {
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestSpacerCoordinates");
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacerCoordinates>("Test1 - snapshot matches the spacer.",
+				&TestSpacerCoordinates::testSpacerCoordinates_build ));
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacerCoordinates>("Test2 - invalidate and rebuild.",
+				&TestSpacerCoordinates::testSpacerCoordinates_rebuild ));
+
+		return suiteOfTests;
+	}
+
+	/// Setup method
+	void setUp() {
+		string path = getenv("VICTOR_ROOT");
+		string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+		ifstream inFile(inputFile.c_str());
+		if (!inFile)
+			ERROR("File not found.", exception);
+		PdbLoader pl(inFile);
+		pl.setNoVerbose();
+		pl.setNoHAtoms();
+		prot.load(pl);
+	}
+
+	/// Teardown method
+	void tearDown() {}
+
+protected:
+	void testSpacerCoordinates_build() {
+		Spacer& sp = *prot.getSpacer((unsigned int)0);
+		SpacerCoordinates coords(sp);
+		CPPUNIT_ASSERT( coords.isValid() );
+		CPPUNIT_ASSERT( coords.sizeAmino() == sp.sizeAmino() );
+
+		unsigned int n = 0;
+		for (unsigned int r = 0; r < sp.sizeAmino(); r++) {
+			AminoAcid& aa = sp.getAmino(r);
+			CPPUNIT_ASSERT( coords.getAminoCode(r) == aa.getCode() );
+			CPPUNIT_ASSERT( coords.getAminoStart(r) == n );
+			for (unsigned int j = 0; j < aa.size(); j++, n++) {
+				CPPUNIT_ASSERT( coords.getCode(n) == aa[j].getCode() );
+				CPPUNIT_ASSERT( coords.getCoords(n) == aa[j].getCoords() );
+				CPPUNIT_ASSERT( coords.getAminoIndex(n) == r );
+			}
+			CPPUNIT_ASSERT( coords.getAminoEnd(r) == n );
+			int ca = coords.findAtom(r, CA);
+			CPPUNIT_ASSERT( (ca >= 0) && (coords.getCoords(ca) == aa[CA].getCoords()) );
+		}
+		CPPUNIT_ASSERT( coords.sizeAtoms() == n );
+
+		// contacts as with all CA pairs
+		unsigned int expected = 0;
+		for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+			for (unsigned int j = i + 3; j < sp.sizeAmino(); j++)
+				if ((sp.getAmino(i)[CA].getCoords() - sp.getAmino(j)[CA].getCoords()).length() < 8.0)
+					expected++;
+		CPPUNIT_ASSERT( coords.countContacts(8.0) == expected );
+
+		SpacerCoordinates part(sp, 10, 20);
+		CPPUNIT_ASSERT( part.sizeAmino() == 10 );
+		CPPUNIT_ASSERT( part.getCoords(0) == sp.getAmino(10)[0].getCoords() );
+	}
+
+	void testSpacerCoordinates_rebuild() {
+		Spacer& sp = *prot.getSpacer((unsigned int)0);
+		SpacerCoordinates coords(sp);
+		SpacerCoordinates old(sp);
+		CPPUNIT_ASSERT( coords.calculateRmsd(old) == 0.0 );
+
+		for (unsigned int r = 0; r < sp.sizeAmino(); r++)
+			for (unsigned int j = 0; j < sp.getAmino(r).size(); j++) {
+				Atom& at = sp.getAmino(r)[j];
+				at.setCoords(at.getCoords() + vgVector3<double>(1.0, 0.0, 0.0));
+			}
+		coords.invalidate();
+		CPPUNIT_ASSERT( !coords.isValid() );
+		coords.rebuild();
+		CPPUNIT_ASSERT( coords.isValid() );
+		CPPUNIT_ASSERT( fabs(coords.calculateRmsd(old) - 1.0) < 1e-9 );
+		CPPUNIT_ASSERT( fabs(coords.calculateRmsd(old, CB) - 1.0) < 1e-9 );
+	}
+};
@@ -0,0 +1,95 @@
+/*
+ * TestSpacerDihedrals.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <iostream>
+#include <cmath>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <SpacerDihedrals.h>
+#include <Protein.h>
+#include <PdbLoader.h>
+
+using namespace std;
+using namespace Victor::Biopool;
+
+class TestSpacerDihedrals : public CppUnit::TestFixture {
+private:
+	Protein prot;
+public:
+	TestSpacerDihedrals() {}
+	virtual ~TestSpacerDihedrals() {}
+
+	static CppUnit::Test *suite() {
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestSpacerDihedrals");
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacerDihedrals>("Test1 - angles match the amino acids.",
+				&TestSpacerDihedrals::testSpacerDihedrals_build ));
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestSpacerDihedrals>("Test2 - cache follows moved atoms.",
+				&TestSpacerDihedrals::testSpacerDihedrals_modified ));
+
+		return suiteOfTests;
+	}
+
+	/// Setup method
+	void setUp() {
+		string path = getenv("VICTOR_ROOT");
+		string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+		ifstream inFile(inputFile.c_str());
+		if (!inFile)
+			ERROR("File not found.", exception);
+		PdbLoader pl(inFile);
+		pl.setNoVerbose();
+		pl.setNoHAtoms();
+		prot.load(pl);
+	}
+
+	/// Teardown method
+	void tearDown() {}
+
+protected:
+	void testSpacerDihedrals_build() {
+		Spacer& sp = *prot.getSpacer((unsigned int)0);
+		const SpacerDihedrals& d = sp.getDihedrals(true);
+		CPPUNIT_ASSERT( d.isValid() && d.hasChi() );
+		CPPUNIT_ASSERT( d.sizeAmino() == sp.sizeAmino() );
+
+		for (unsigned int r = 0; r < sp.sizeAmino(); r++) {
+			AminoAcid& aa = sp.getAmino(r);
+			CPPUNIT_ASSERT( d.getPhi(r) == aa.getPhi(true) );
+			CPPUNIT_ASSERT( d.getPsi(r) == aa.getPsi(true) );
+			CPPUNIT_ASSERT( d.getOmega(r) == aa.getOmega(true) );
+			CPPUNIT_ASSERT( d.sizeChi(r) == aa.getSideChain().getMaxChi() );
+			for (unsigned int n = 0; n < d.sizeChi(r); n++)
+				CPPUNIT_ASSERT( d.getChi(r, n) == aa.getChi(n) );
+		}
+		CPPUNIT_ASSERT( &sp.getDihedrals() == &d );
+	}
+
+	void testSpacerDihedrals_modified() {
+		Spacer& sp = *prot.getSpacer((unsigned int)0);
+		const SpacerDihedrals& d = sp.getDihedrals();
+		double psi = d.getPsi(20);
+
+		sp.getAmino(21).setPhi(-60.0);
+		CPPUNIT_ASSERT( !d.isValid() );
+		sp.getDihedrals();
+		CPPUNIT_ASSERT( d.isValid() );
+		CPPUNIT_ASSERT( fabs(d.getPhi(21) - -60.0) < 1e-6 );
+		CPPUNIT_ASSERT( d.getPsi(20) == psi );
+		for (unsigned int r = 0; r < sp.sizeAmino(); r++)
+			CPPUNIT_ASSERT( d.getPhi(r) == sp.getAmino(r).getPhi(true) );
+
+		Atom& at = sp.getAmino(30)[CA];
+		at.setCoords(at.getCoords() + vgVector3<double>(0.5, 0.0, 0.0));
+		CPPUNIT_ASSERT( !d.isValid() );
+		CPPUNIT_ASSERT( sp.getDihedrals().getPhi(30) == sp.getAmino(30).getPhi(true) );
+	}
+};
@@ -0,0 +1,103 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+@Description Compares the linear search and the index table lookup of
+ group atoms by code in speed and result, over a full chain energy
+ evaluation (RAPDF, solvation and torsion) as done by pdb2energy. */
+#include <string>
+#include <ctime>
+#include <GetArg.h>
+#include <PdbLoader.h>
+#include <SolvationPotential.h>
+#include <RapdfPotential.h>
+#include <TorsionPotential.h>
+#include <PhiPsi.h>
+
+using namespace Victor;
+
+using namespace Victor::Energy;
+using namespace Victor::Biopool;
+
+void sShowHelp(){
+  cout << "Atom Index Benchmark\n"
+       << " Options: \n"
+       << "\t-i <filename> [<filename> ...] \t Input PDB files\n"
+       << "\t[-n <num>] \t\t Repetitions per structure (def = 10)\n"
+       << "\n";
+}
+
+/// average seconds per full energy evaluation of sp
+double sTime(RapdfPotential& rapdf, SolvationPotential& solv,
+TorsionPotential& tors, Spacer& sp, unsigned int num, long double& en){
+  clock_t start = clock();
+  for (unsigned int i = 0; i < num; i++)
+    en = rapdf.calculateEnergy(sp) + solv.calculateEnergy(sp)
+      + tors.calculateEnergy(sp);
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC / num;
+}
+
+
+int main(int nArgs, char* argv[]){
+  if (getArg( "h", nArgs, argv))  {
+      sShowHelp();
+      return 1;
+    };
+  vector<string> inputFiles;
+  unsigned int num;
+  getArg( "i", inputFiles, nArgs, argv);
+  getArg( "n", num, nArgs, argv, 10);
+  if (inputFiles.size() == 0)  {
+      cout << "Missing file specification. Aborting. (-h for help)" << endl;
+      return -1;
+    }
+  if (num == 0)
+    num = 1;
+
+  RapdfPotential rapdf;
+  SolvationPotential solv;
+  PhiPsi tors(10);
+  bool same = true;
+  cout << "file\tresidues\tenergy\tlinear (s)\tindex (s)\tspeedup\n";
+  for (unsigned int f = 0; f < inputFiles.size(); f++) {
+      ifstream inFile(inputFiles[f].c_str());
+      if (!inFile)
+	ERROR("File not found.", exception);
+      PdbLoader pl(inFile);
+      pl.setNoHAtoms();
+      pl.setNoVerbose();
+      pl.setPermissive();
+      Protein prot;
+      prot.load(pl);
+      Spacer& sp = *prot.getSpacer(static_cast<unsigned int>(0));
+
+      long double enLinear, enIndex;
+      sTime(rapdf, solv, tors, sp, 1, enIndex); // warm up
+      Group::setUseAtomIndex(false);
+      double tLinear = sTime(rapdf, solv, tors, sp, num, enLinear);
+      Group::setUseAtomIndex(true);
+      double tIndex = sTime(rapdf, solv, tors, sp, num, enIndex);
+
+      if (enLinear != enIndex)
+	same = false;
+      cout << inputFiles[f] << "\t" << sp.sizeAmino() << "\t"
+	   << setprecision(8) << enIndex << "\t" << setprecision(4)
+	   << tLinear << "\t" << tIndex << "\t"
+	   << (tIndex > 0 ? tLinear / tIndex : 0.0)
+	   << (enLinear != enIndex ? "\tMISMATCH" : "") << "\n";
+    }
+
+  return (same ? 0 : 1);
+}
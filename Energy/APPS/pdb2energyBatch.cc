@@ -0,0 +1,158 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**  
+@Description Scores many PDB files (eg. decoys) with RAPDF, solvation and
+ torsion potentials. The parameter tables are loaded once, files are
+ scored on a pool of threads a chunk at a time and results are written
+ in input order. */
+#include <string>
+#include <GetArg.h>
+#include <EnergyBatch.h>
+#include <SolvationPotential.h>
+#include <PolarSolvationPotential.h>
+#include <RapdfPotential.h>
+#include <TorsionPotential.h>
+#include <PhiPsi.h>
+#include <PhiPsiOmegaChi1Chi2PreAngle.h>
+#include <ThreadTools.h>
+
+using namespace Victor;
+
+using namespace Victor::Energy;
+using namespace Victor::Biopool;
+
+void sShowHelp(){
+  cout << "PDB to Energy, batch mode\n"
+       << " Options: \n"
+       << "\t[-i <filename>] \t List of PDB files, one per line (def = stdin)\n"
+       << "\t[-o <filename>] \t Output file (def = stdout)\n"
+       << "\t[--csv] \t\t Comma separated output (def = tab separated)\n"
+       << "\t[--threads <num>] \t Number of threads (def = 0, one per processor)\n"
+       << "\t[--chunk <num>] \t Files scored at a time (def = 16 per thread)\n"
+       << "\t[-T] \t\t\t New (Mk2) torsion angle potential \n"
+       << "\t[-S] \t\t\t New (Mk2) solvation potential \n"
+       << "\n"
+       << " Files which cannot be loaded are reported with NA energies.\n"
+       << "\n";
+}
+
+/// reads the next chunk of file names, skipping empty lines and comments
+void sReadChunk(istream& in, unsigned int size, vector<string>& fileNames){
+  fileNames.clear();
+  string line;
+  while ((fileNames.size() < size) && getline(in, line)) {
+      string::size_type first = line.find_first_not_of(" \t\r");
+      if ((first == string::npos) || (line[first] == '#'))
+	continue;
+      string::size_type last = line.find_last_not_of(" \t\r");
+      fileNames.push_back(line.substr(first, last - first + 1));
+    }
+}
+
+
+int main(int nArgs, char* argv[]){ 
+  if (getArg( "h", nArgs, argv))  {
+      sShowHelp();
+      return 1;
+    };
+  string inputFile, outputFile;
+  unsigned int numThreads, chunk;
+  getArg( "i", inputFile, nArgs, argv, "!");
+  getArg( "o", outputFile, nArgs, argv, "!");
+  getArg( "-threads", numThreads, nArgs, argv, 0);
+  getArg( "-chunk", chunk, nArgs, argv, 0);
+  bool csv = getArg( "-csv", nArgs, argv);
+  bool newTorsion = getArg( "T", nArgs, argv);
+  bool newSolvation = getArg( "S", nArgs, argv);
+
+  if (numThreads == 0)
+    numThreads = getNumProcessors();
+  if (chunk == 0)
+    chunk = 16 * numThreads;
+
+  ifstream inFile;
+  if (inputFile != "!") {
+      inFile.open(inputFile.c_str());
+      if (!inFile)
+	ERROR("File not found.", exception);
+    }
+  istream& in = (inputFile != "!") ? inFile : cin;
+
+  ofstream outFile;
+  if (outputFile != "!") {
+      outFile.open(outputFile.c_str());
+      if (!outFile)
+	ERROR("Could not open file for writing.", exception);
+    }
+  ostream& out = (outputFile != "!") ? outFile : cout;
+
+  // parameter tables are read once and shared by all threads
+  RapdfPotential rapdf;
+  Potential* solv = NULL;
+  if (!newSolvation)
+    solv = new SolvationPotential;
+  else
+    solv = new PolarSolvationPotential;
+  TorsionPotential* tors = NULL;
+  if (!newTorsion)
+    tors =  new PhiPsi(10);//default ARCSTEP = 10
+  else
+    tors =  new PhiPsiOmegaChi1Chi2PreAngle(20);//ARCSTEP 20, ARCSTEP2 40 
+
+  EnergyBatch batch(numThreads);
+  batch.addPotential(&rapdf);
+  batch.addPotential(solv);
+  batch.addPotential(tors);
+
+  char sep = csv ? ',' : '\t';
+  out << "file" << sep << "rapdf" << sep << "solvation" << sep << "torsion"
+      << "\n";
+  out.setf(ios::fixed, ios::floatfield);
+
+  double start = getWallTime();
+  unsigned int count = 0;
+  unsigned int failed = 0;
+  vector<string> fileNames;
+  sReadChunk(in, chunk, fileNames);
+  while (fileNames.size() > 0) {
+      vector<vector<long double> > res = batch.calculateEnergy(fileNames);
+      for (unsigned int i = 0; i < res.size(); i++) {
+	  out << fileNames[i];
+	  for (unsigned int j = 0; j < batch.sizePotentials(); j++)
+	    if (res[i].empty())
+	      out << sep << "NA";
+	    else
+	      out << sep << setprecision(4) << res[i][j];
+	  out << "\n";
+	  if (res[i].empty())
+	    failed++;
+	}
+      out.flush();
+      count += fileNames.size();
+      sReadChunk(in, chunk, fileNames);
+    }
+  double time = getWallTime() - start;
+
+  cerr.setf(ios::fixed, ios::floatfield);
+  cerr << "Scored " << count << " structures (" << failed << " failed) in "
+       << setprecision(2) << time << " s with " << numThreads 
+       << " threads, " << setprecision(1) 
+       << ((time > 0.0) ? count / time : 0.0) << " structures/s\n";
+
+  delete solv;
+  delete tors;
+  return 0;
+}
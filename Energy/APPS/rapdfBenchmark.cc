@@ -0,0 +1,95 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**  
+@Description Compares the all-pairs and the neighbour grid evaluation of
+ the RAPDF energy in speed and result. */
+#include <string>
+#include <ctime>
+#include <GetArg.h>
+#include <PdbLoader.h>
+#include <RapdfPotential.h>
+
+using namespace Victor;
+
+using namespace Victor::Energy;
+using namespace Victor::Biopool;
+
+void sShowHelp(){
+  cout << "RAPDF Benchmark\n"
+       << " Options: \n"
+       << "\t-i <filename> [<filename> ...] \t Input PDB files\n"
+       << "\t[-n <num>] \t\t Repetitions per structure (def = 10)\n"
+       << "\n";
+}
+
+/// average seconds per energy evaluation of the first chain of sp
+double sTime(RapdfPotential& rapdf, Spacer& sp, unsigned int num, 
+long double& en){
+  clock_t start = clock();
+  for (unsigned int i = 0; i < num; i++)
+    en = rapdf.calculateEnergy(sp);
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC / num;
+}
+
+
+int main(int nArgs, char* argv[]){ 
+  if (getArg( "h", nArgs, argv))  {
+      sShowHelp();
+      return 1;
+    };
+  vector<string> inputFiles;
+  unsigned int num;
+  getArg( "i", inputFiles, nArgs, argv);
+  getArg( "n", num, nArgs, argv, 10);
+  if (inputFiles.size() == 0)  {
+      cout << "Missing file specification. Aborting. (-h for help)" << endl;
+      return -1;
+    }
+  if (num == 0)
+    num = 1;
+
+  RapdfPotential rapdf;
+  bool same = true;
+  cout << "file\tresidues\tenergy\tall pairs (s)\tgrid (s)\tspeedup\n";
+  for (unsigned int f = 0; f < inputFiles.size(); f++) {
+      ifstream inFile(inputFiles[f].c_str());
+      if (!inFile)
+	ERROR("File not found.", exception);
+      PdbLoader pl(inFile);
+      pl.setNoHAtoms();
+      pl.setNoVerbose();
+      pl.setPermissive();
+      Protein prot;
+      prot.load(pl);
+      Spacer& sp = *prot.getSpacer(static_cast<unsigned int>(0));
+
+      long double enAll, enGrid;
+      rapdf.setUseGrid(false);
+      double tAll = sTime(rapdf, sp, num, enAll);
+      rapdf.setUseGrid(true);
+      double tGrid = sTime(rapdf, sp, num, enGrid);
+
+      if (enAll != enGrid)
+	same = false;
+      cout << inputFiles[f] << "\t" << sp.sizeAmino() << "\t" 
+	   << setprecision(8) << enGrid << "\t" << setprecision(4) 
+	   << tAll << "\t" << tGrid << "\t" 
+	   << (tGrid > 0 ? tAll / tGrid : 0.0) 
+	   << (enAll != enGrid ? "\tMISMATCH" : "") << "\n";
+    }
+
+  return (same ? 0 : 1);
+}
@@ -18,17 +18,47 @@
 // Includes:
 #include <EffectiveSolvationPotential.h>
 #include <AminoAcidCode.h>
+#include <cmath>
 
 using namespace Victor;
 
 // Global constants, typedefs, etc. (to avoid):
 
+namespace Victor { namespace Energy {
+
+    /**
+     * Buried fraction of residue n + 1 (the chain ends have none), from a
+     * CA distance matrix, into slot n + 1.
+     */
+    class FracBuriedTask : public ParallelTask {
+    public:
+
+        FracBuriedTask(const EffectiveSolvationPotential& _pot,
+                const vector<double>& _dist, unsigned int _size,
+                vector<double>& _fracBuried)
+        : pot(_pot), dist(_dist), size(_size), fracBuried(_fracBuried) {
+        }
+
+        virtual void run(unsigned int n) {
+            fracBuried[n + 1] = pot.pCalcFracBuried(n + 1, dist, size);
+        }
+
+    private:
+        const EffectiveSolvationPotential& pot;
+        const vector<double>& dist;
+        unsigned int size;
+        vector<double>& fracBuried;
+    };
+
+}} // namespace
+
 // CONSTRUCTORS/DESTRUCTOR:
 
 /**
  *     Basic constructor, sets the efective solvation potential for a chain.
  */
-EffectiveSolvationPotential::EffectiveSolvationPotential() {
+EffectiveSolvationPotential::EffectiveSolvationPotential() : cache(),
+cacheLock() {
 
     solvCoeff.resize(AminoAcid_CODE_SIZE);
 
@@ -69,57 +99,76 @@ EffectiveSolvationPotential::EffectiveSolvationPotential() {
  *@return energy value (long double)
  */
 long double EffectiveSolvationPotential::calculateEnergy(Spacer& sp) {
-    long double solv = 0.0;
-
-    for (unsigned int i = 0; i < sp.sizeAmino(); i++)
-        solv += calculateEnergy(sp.getAmino(i), sp);
-
-    return solv;
+    return calculateEnergy(sp, 0, sp.sizeAmino());
 }
 
 /**
- *  Calculates Energy
+ *  Calculates Energy, ie. the chain energy once for every amino acid of
+ *  the portion, from a single burial profile.
  *@param spacer reference(spacer&),positions of the start and eend of the amino acids portion of the spacer(unsigned int,unsigned int)
  *@return energy value(long double)
  */
 long double EffectiveSolvationPotential::calculateEnergy(Spacer& sp, unsigned int index1,
         unsigned int index2) {
-    long double solv = 0.0;
+    if (index2 <= index1)
+        return 0.0;
 
-    for (unsigned int i = index1; i < index2; i++)
-        solv += calculateEnergy(sp.getAmino(i), sp);
+    BurialProfile prof;
+    pGetProfile(sp, prof);
+    return (index2 - index1) * prof.chainEnergy;
+}
 
-    return solv;
+/**
+ *  Calculates the energy term of a single residue. The terms of all
+ *  residues add up to calculateEnergy(AminoAcid&, Spacer&).
+ *@param   residue position(unsigned int),spacer reference(spacer&)
+ *@return energy value (long double), 0 for the first and last residue
+ */
+long double EffectiveSolvationPotential::calculateResidueEnergy(unsigned int index,
+        Spacer& sp) {
+    PRECOND(index < sp.sizeAmino(), exception);
+    BurialProfile prof;
+    pGetProfile(sp, prof);
+    return prof.energy[index];
+}
+
+/**
+ *  Calculates the buried fraction of every residue in the spacer
+ *@param  spacer reference(spacer&)
+ *@return one value per residue, 0 for the first and last residue (vector<double>)
+ */
+vector<double> EffectiveSolvationPotential::calculateFracBuried(Spacer& sp) {
+    BurialProfile prof;
+    pGetProfile(sp, prof);
+    return prof.fracBuried;
 }
 
 /**
  *  Calculates Fraction of the amino acids Buried in the spacer
- *@param   central amino acid position to considers,(unsigned int ),spacer reference(spacer&)
+ *@param   central amino acid position to considers,(unsigned int ),CA distance
+ *  matrix, row by row (const vector<double>&),number of residues(unsigned int)
  *@return the fraction of the amino acids buried (double)
  */
-double EffectiveSolvationPotential::pCalcFracBuried(unsigned int index, Spacer& sp) {
+double EffectiveSolvationPotential::pCalcFracBuried(unsigned int index,
+        const vector<double>& dist, unsigned int size) const {
+    const double* dIndex = &dist[index * size];
     double barea = 0.0;
     double fneb = 0.0;
     double scheck = 0.0;
-    unsigned int count = 0;
 
-    for (unsigned int j = 0; j < sp.sizeAmino(); j++) {
+    for (unsigned int j = 0; j < size; j++) {
         //only does this for the amino acids that are not in the group of 3, considering the index as the center of this 3 aas
         if ((j > index + 1) || (j < index - 1)) {
-            fneb += 4.0 / sp.getAmino(index)[CA].distance(sp.getAmino(j)[CA]);
+            const double* dJ = &dist[j * size];
+            fneb += 4.0 / dIndex[j];
 
-            for (unsigned int k = 0; k < sp.sizeAmino(); k++)
+            // the factors are finite, so once fneb is 0 it stays 0
+            for (unsigned int k = 0; (k < size) && (fneb != 0.0); k++)
                 if ((k > index + 1) || (k < index - 1)) {
-                    scheck = sp.getAmino(index)[CA].distance(sp.getAmino(j)[CA])
-                            / (sp.getAmino(index)[CA].distance(sp.getAmino(k)[CA])
-                            + sp.getAmino(j)[CA].distance(sp.getAmino(k)[CA]));
-
-                    if (scheck > 0.7) {
-                        count++;
-
+                    scheck = dIndex[j] / (dIndex[k] + dJ[k]);
 
+                    if (scheck > 0.7)
                         fneb *= (1 - scheck);
-                    }
                 }
             barea += fneb;
         }
@@ -128,21 +177,64 @@ double EffectiveSolvationPotential::pCalcFracBuried(unsigned int index, Spacer&
 }
 
 /**
- *  Calculates the energy for the amino acids in the Spacer
- *@param  amino acid reference(not used AminoAcid&),spacer reference(Spacer&),
- *@return energy value (long double)
+ *  Gets the burial profile of the spacer, from the cache if its CA atoms
+ *  did not move and its residues did not change since the last evaluation.
+ *@param  spacer reference(spacer&),profile (BurialProfile&)
+ *@return changes are made internally(void)
  */
-long double EffectiveSolvationPotential::calculateEnergy(AminoAcid& aa, Spacer& sp) {
-    long double energy = 0.0;
+void EffectiveSolvationPotential::pGetProfile(Spacer& sp, BurialProfile& prof) {
+    unsigned int size = sp.sizeAmino();
+    prof.ca.resize(size);
+    prof.code.resize(size);
+    for (unsigned int i = 0; i < size; i++) {
+        prof.ca[i] = sp.getAmino(i)[CA].getCoords();
+        prof.code[i] = sp.getAmino(i).getCode();
+    }
 
-    for (unsigned int i = 1; i < sp.sizeAmino() - 1; i++) {
-        double fracBuried = pCalcFracBuried(i, sp);
+    {
+        MutexLock lock(cacheLock);
+        if ((cache.ca == prof.ca) && (cache.code == prof.code)
+                && (cache.fracBuried.size() == size)) {
+            prof = cache;
+            return;
+        }
+    }
 
+    vector<double> dist(size * size, 0.0);
+    for (unsigned int i = 0; i < size; i++)
+        for (unsigned int j = i + 1; j < size; j++) {
+            vgVector3<double> d = prof.ca[i] - prof.ca[j];
+            dist[i * size + j] = dist[j * size + i] =
+                    sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+        }
+
+    prof.fracBuried.assign(size, 0.0);
+    if (size > 2) {
+        FracBuriedTask task(*this, dist, size, prof.fracBuried);
+        runParallel(task, size - 2, numThreads);
+    }
+
+    prof.energy.assign(size, 0.0);
+    prof.chainEnergy = 0.0;
+    for (unsigned int i = 1; i + 1 < size; i++) {
         double sign = (isPolar(sp.getAmino(i)) ? -1.0 : 1.0);
 
-        energy += sign * fracBuried
+        prof.energy[i] = sign * prof.fracBuried[i]
                 * (solvCoeff[sp.getAmino(i).getCode()] - 60.0) / 29.8;
+        prof.chainEnergy += prof.energy[i];
     }
-    return energy;
+
+    MutexLock lock(cacheLock);
+    cache = prof;
 }
 
+/**
+ *  Calculates the energy for the amino acids in the Spacer
+ *@param  amino acid reference(not used AminoAcid&),spacer reference(Spacer&),
+ *@return energy value (long double)
+ */
+long double EffectiveSolvationPotential::calculateEnergy(AminoAcid& aa, Spacer& sp) {
+    BurialProfile prof;
+    pGetProfile(sp, prof);
+    return prof.chainEnergy;
+}
@@ -22,6 +22,7 @@
 #include <vector>
 #include <Spacer.h>
 #include <Potential.h>
+#include <ThreadTools.h>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -32,12 +33,18 @@ namespace Victor { namespace Energy {
 
     const double SOLVATION_CUTOFF_DISTANCE_EFFECTIVE = 10.0;
 
+    class FracBuriedTask;
+
     /**
      * @brief Implements a knowledge-based solvation with polar/hydrophobic information potential. 
      * A coefficient is used to normalize the propensity.
      * 
      *   This class implements a knowledge-based solvation with polar/hydrophobic 
      *    information potential. The final values are normalized by an hardcoded coefficient (see source)
+     * 
+     *   The buried fractions of all residues are derived from one CA distance
+     *    matrix and kept for the last chain evaluated, so repeated calls on
+     *    an unchanged chain are cheap.
      * */
     class EffectiveSolvationPotential : public Potential {
     public:
@@ -54,22 +61,43 @@ namespace Victor { namespace Energy {
         virtual long double calculateEnergy(Spacer& sp, unsigned int index1,
                 unsigned int index2);
         virtual long double calculateEnergy(AminoAcid& aa, Spacer& sp);
+        long double calculateResidueEnergy(unsigned int index, Spacer& sp);
+        vector<double> calculateFracBuried(Spacer& sp);
 
         // MODIFIERS:
 
         // OPERATORS:
 
+        friend class FracBuriedTask;
+
     protected:
 
+        /**
+         * Buried fraction and energy term of every residue of a chain,
+         * together with the CA coordinates and amino acid codes they were
+         * computed from.
+         */
+        struct BurialProfile {
+            vector<vgVector3<double> > ca;
+            vector<unsigned int> code;
+            vector<double> fracBuried;
+            vector<long double> energy;
+            long double chainEnergy;
+        };
+
         // HELPERS:
         bool isPolar(AminoAcid& aa);
-        double pCalcFracBuried(unsigned int index, Spacer& sp);
+        double pCalcFracBuried(unsigned int index, const vector<double>& dist,
+                unsigned int size) const;
+        void pGetProfile(Spacer& sp, BurialProfile& prof);
 
     private:
 
         // ATTRIBUTES:
 
         vector<double> solvCoeff;
+        BurialProfile cache; // profile of the last chain evaluated
+        Mutex cacheLock;
 
     };
 
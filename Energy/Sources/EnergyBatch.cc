@@ -0,0 +1,116 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <EnergyBatch.h>
+#include <PdbLoader.h>
+#include <Protein.h>
+#include <ThreadTools.h>
+
+using namespace Victor;
+
+using namespace Victor::Biopool;
+
+using namespace Victor::Energy;
+
+// Global constants, typedefs, etc. (to avoid):
+
+/**
+ * Scores file n of the list into slot n of the results.
+ */
+class EnergyBatchTask : public ParallelTask {
+public:
+
+    EnergyBatchTask(EnergyBatch& _batch, const vector<string>& _fileNames,
+            vector<vector<long double> >& _results)
+    : batch(_batch), fileNames(_fileNames), results(_results) {
+    }
+
+    virtual void run(unsigned int n) {
+        results[n] = batch.calculateEnergy(fileNames[n]);
+    }
+
+private:
+    EnergyBatch& batch;
+    const vector<string>& fileNames;
+    vector<vector<long double> >& results;
+};
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Builds an empty batch.
+ *@param   number of threads, 0 = one per processor (unsigned int)
+ */
+EnergyBatch::EnergyBatch(unsigned int _numThreads) : potentials(),
+numThreads(_numThreads) {
+}
+
+// PREDICATES:
+
+/**
+ *  Calculates the energy of a Spacer with each potential, in the order
+ *  they were added.
+ *@param   spacer reference(Spacer&)
+ *@return  energy values (vector<long double>)
+ */
+vector<long double> EnergyBatch::calculateEnergy(Spacer& sp) {
+    vector<long double> res;
+    for (unsigned int i = 0; i < potentials.size(); i++)
+        res.push_back(potentials[i]->calculateEnergy(sp));
+    return res;
+}
+
+/**
+ *  Loads the first chain of a PDB file and calculates its energies.
+ *@param   PDB file name (string)
+ *@return  energy values, empty if the file has no amino acids
+ *         (vector<long double>)
+ */
+vector<long double> EnergyBatch::calculateEnergy(const string& fileName) {
+    ifstream inFile(fileName.c_str());
+    if (!inFile)
+        return vector<long double>();
+
+    PdbLoader pl(inFile);
+    pl.setNoHAtoms();
+    pl.setNoVerbose();
+    pl.setPermissive();
+    Protein prot;
+    prot.load(pl);
+    if (prot.sizeProtein() == 0)
+        return vector<long double>();
+    Spacer& sp = *prot.getSpacer(static_cast<unsigned int> (0));
+    if (sp.sizeAmino() == 0)
+        return vector<long double>();
+    return calculateEnergy(sp);
+}
+
+/**
+ *  Calculates the energies of a list of PDB files, spread over the
+ *  worker threads.
+ *@param   PDB file names (vector<string>)
+ *@return  energy values of each file, see calculateEnergy(string)
+ *         (vector<vector<long double> >)
+ */
+vector<vector<long double> > EnergyBatch::calculateEnergy(
+        const vector<string>& fileNames) {
+    vector<vector<long double> > results(fileNames.size());
+    EnergyBatchTask task(*this, fileNames, results);
+    runParallel(task, fileNames.size(), numThreads);
+    return results;
+}
@@ -0,0 +1,109 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _ENERGYBATCH_H_
+#define _ENERGYBATCH_H_
+
+// Includes:
+#include <vector>
+#include <string>
+#include <Potential.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Energy {
+
+    /**
+     * @brief Scores a list of PDB files with a set of potentials on a pool
+     * of threads.
+     * 
+     *  Each file is loaded (first chain, no H atoms) and scored by a worker
+     * thread; the potentials are shared by all threads, so they must not
+     * change while scoring, which holds for the potentials of this library.
+     * Results are returned in input order, whatever the number of threads.
+     * */
+    class EnergyBatch {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        EnergyBatch(unsigned int _numThreads = 0);
+
+        virtual ~EnergyBatch() {
+            PRINT_NAME;
+        }
+
+        // PREDICATES:
+        unsigned int sizePotentials() const;
+        unsigned int getNumThreads() const;
+
+        vector<long double> calculateEnergy(Spacer& sp);
+        vector<long double> calculateEnergy(const string& fileName);
+        vector<vector<long double> > calculateEnergy(
+                const vector<string>& fileNames);
+
+        // MODIFIERS:
+        void addPotential(Potential* pot);
+        void setNumThreads(unsigned int n);
+
+        // OPERATORS:
+
+    protected:
+
+        // ATTRIBUTES:
+        vector<Potential*> potentials; // not owned
+        unsigned int numThreads; // 0 = one per processor
+
+    private:
+
+    };
+
+    // ---------------------------------------------------------------------------
+    //                               EnergyBatch
+    // -----------------x-------------------x-------------------x-----------------
+
+    // PREDICATES:
+
+    inline unsigned int EnergyBatch::sizePotentials() const {
+        return potentials.size();
+    }
+
+    inline unsigned int EnergyBatch::getNumThreads() const {
+        return numThreads;
+    }
+
+    // MODIFIERS:
+
+    /**
+     *  Adds a potential to the batch. The potential is not copied and must
+     *  outlive the batch.
+     *@param   pointer to the potential (Potential*)
+     */
+    inline void EnergyBatch::addPotential(Potential* pot) {
+        PRECOND(pot != NULL, exception);
+        potentials.push_back(pot);
+    }
+
+    /**
+     *  Sets the number of worker threads (0 = one per processor).
+     *@param   number of threads (unsigned int)
+     */
+    inline void EnergyBatch::setNumThreads(unsigned int n) {
+        numThreads = n;
+    }
+
+}} // namespace
+#endif //_ENERGYBATCH_H_
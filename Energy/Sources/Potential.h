@@ -46,10 +46,10 @@ using namespace Victor::Biopool;
 
         // CONSTRUCTORS/DESTRUCTOR:
 
-        Potential() {
+        Potential() : numThreads(1) {
         }
 
-        Potential(string inputFile) {
+        Potential(string inputFile) : numThreads(1) {
         }
 
         virtual ~Potential() {
@@ -77,8 +77,24 @@ using namespace Victor::Biopool;
         virtual vector< vector<ANGLES> >* orderedEnergy() {
             ERROR("ERROR. NOT IMPLEMENTED FOR THIS CLASS.", exception);
         }
+
+        /**
+         * Number of threads used by the Spacer energies of the potentials
+         * supporting it (0 = one per processor).
+         */
+        unsigned int getNumThreads() const {
+            return numThreads;
+        }
         // MODIFIERS:
 
+        /**
+         * Sets the number of threads for the Spacer energies. The result
+         * does not depend on it.
+         */
+        virtual void setNumThreads(unsigned int n) {
+            numThreads = n;
+        }
+
         // OPERATORS:
 
     protected:
@@ -86,6 +102,7 @@ using namespace Victor::Biopool;
         // HELPERS:
 
         // ATTRIBUTES:
+        unsigned int numThreads;
 
     private:
 
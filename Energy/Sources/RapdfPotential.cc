@@ -19,7 +19,11 @@
 #include <RapdfPotential.h>
 #include <AminoAcidCode.h>
 #include <Spacer.h>
+#include <NeighbourGrid.h>
+#include <ThreadTools.h>
+#include <EmbeddedData.h>
 #include <cstring>
+#include <cmath>
 
 using namespace Victor;
 
@@ -28,23 +32,72 @@ using namespace Victor::Biopool;
 using namespace Victor::Energy;
 // Global constants, typedefs, etc. (to avoid):
 
+namespace Victor {
+    extern const EmbeddedData EMBEDDED_RAM_PAR; // data/ram.par
+}
+
+namespace Victor { namespace Energy {
+
+    /**
+     * Sums the residue pairs (i, ii > i) of row i of an AtomTable into its
+     * own slot, so that rows can be computed by different threads.
+     */
+    class RapdfRowTask : public ParallelTask {
+    public:
+
+        RapdfRowTask(const RapdfPotential& _pot,
+                const RapdfPotential::AtomTable& _table,
+                const vector<vector<unsigned int> >* _partners,
+                vector<long double>& _rows)
+        : pot(_pot), table(_table), partners(_partners), rows(_rows) {
+        }
+
+        virtual void run(unsigned int i) {
+            if (partners == NULL) {
+                for (unsigned int ii = i + 1; ii < table.sizeResidues(); ii++)
+                    pot.pSumResiduePair(table, i, table, ii, rows[i]);
+            } else {
+                const vector<unsigned int>& row = (*partners)[i];
+                for (unsigned int k = 0; k < row.size(); k++)
+                    pot.pSumResiduePair(table, i, table, row[k], rows[i]);
+            }
+        }
+
+    private:
+        const RapdfPotential& pot;
+        const RapdfPotential::AtomTable& table;
+        const vector<vector<unsigned int> >* partners;
+        vector<long double>& rows;
+    };
+
+}} // namespace
+
 
 // CONSTRUCTORS/DESTRUCTOR:
 
 /**
- *     Basic constructor, allocate the information from the ram.par file 
+ *     Basic constructor, uses the ram.par tables compiled into the library
  */
-RapdfPotential::RapdfPotential() {
-
-    char *victor = getenv("VICTOR_ROOT");
-    if (victor == NULL)
-        ERROR("Environment variable VICTOR_ROOT was not found.\n Use the command:\n export VICTOR_ROOT=......", exception);
+RapdfPotential::RapdfPotential() : useGrid(true) {
     path = "data/ram.par";
-    string inputFile = getenv("VICTOR_ROOT");
-    if (inputFile.length() < 3)
-        ERROR("Environment variable VICTOR_ROOT was not found.", exception);
-    inputFile += path;
-    ifstream in(inputFile.c_str());
+    if (EMBEDDED_RAM_PAR.sizeNumbers != MAX_BINS * MAX_TYPES * MAX_TYPES)
+        ERROR("RapdfPotential() : embedded ram.par table has the wrong size.",
+            exception);
+    const double* p = EMBEDDED_RAM_PAR.numbers;
+    for (unsigned int i = 0; i < MAX_BINS; i++)
+        for (unsigned int j = 0; j < MAX_TYPES; j++)
+            for (unsigned int k = 0; k < MAX_TYPES; k++)
+                prob[i][j][k] = *p++;
+    pSetupTables();
+}
+
+/**
+ *     Constructor for custom tables, reads a file in the ram.par format
+ *@param   parameter file name (string)
+ */
+RapdfPotential::RapdfPotential(const string& paramFile) : useGrid(true) {
+    path = paramFile;
+    ifstream in(paramFile.c_str());
     if (!in)
         ERROR("Could not read data file.", exception);
     for (unsigned int i = 0; i < MAX_BINS; i++)
@@ -55,6 +108,7 @@ RapdfPotential::RapdfPotential() {
                 in >> prob[i][j][k];
         }
     in.close();
+    pSetupTables();
 }
 
 // PREDICATES:
@@ -65,21 +119,7 @@ RapdfPotential::RapdfPotential() {
  *@return energy value (long double)
  */
 long double RapdfPotential::calculateEnergy(Spacer& sp) {
-    long double en = 0.0;
-    unsigned int size = sp.sizeAmino();
-    for (unsigned int i = 0; i < size - 1; i++) {
-        AminoAcid& aa = sp.getAmino(i);
-        string aaType = aa.getType();
-        for (unsigned int ii = i + 1; ii < size; ii++) {
-            AminoAcid& aa2 = sp.getAmino(ii);
-            string aaType2 = aa2.getType();
-            for (unsigned int j = 0; j < aa.size(); j++)
-                for (unsigned int k = 0; k < aa2.size(); k++)
-                    en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
-        }
-    }
-
-    return en;
+    return calculateEnergy(sp, 0, sp.sizeAmino());
 }
 
 /**
@@ -88,18 +128,26 @@ long double RapdfPotential::calculateEnergy(Spacer& sp) {
  *@return energy value (long double)
  */
 long double RapdfPotential::calculateEnergy(Spacer& sp, unsigned int index1, unsigned int index2) {
+    return calculateEnergy(SpacerCoordinates(sp, index1, index2));
+}
+
+/**
+ *  Calculates the energy for all residues of a coordinate snapshot
+ *@param   snapshot of (part of) a spacer (const SpacerCoordinates&)
+ *@return energy value (long double)
+ */
+long double RapdfPotential::calculateEnergy(const SpacerCoordinates& coords) {
+    PRECOND(coords.isValid(), exception);
+    AtomTable table;
+    pFillTable(coords, table);
+
     long double en = 0.0;
-    for (unsigned int i = index1; i < index2; i++) {
-        AminoAcid& aa = sp.getAmino(i);
-        string aaType = aa.getType();
-        for (unsigned int ii = i + 1; ii < index2; ii++) {
-            AminoAcid& aa2 = sp.getAmino(ii);
-            string aaType2 = aa2.getType();
-            for (unsigned int j = 0; j < aa.size(); j++)
-                for (unsigned int k = 0; k < aa2.size(); k++)
-                    en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
-        }
-    }
+    if (useGrid) {
+        vector<vector<unsigned int> > partners;
+        pGetNeighbourPairs(table, partners);
+        pSumRows(table, &partners, en);
+    } else
+        pSumRows(table, NULL, en);
     return en;
 }
 
@@ -109,17 +157,19 @@ long double RapdfPotential::calculateEnergy(Spacer& sp, unsigned int index1, uns
  *@return energy value (long double)
  */
 long double RapdfPotential::calculateEnergy(AminoAcid& aa, Spacer& sp) {
-    long double en = 0.0;
-    string aaType = aa.getType();
+    AtomTable self;
+    pAddResidue(aa, self);
+    AtomTable table;
     for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
         AminoAcid& aa2 = sp.getAmino(i);
         if (aa == aa2) // exclude self-energy
             continue;
-        string aaType2 = aa2.getType();
-        for (unsigned int j = 0; j < aa.size(); j++)
-            for (unsigned int k = 0; k < aa2.size(); k++)
-                en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
+        pAddResidue(aa2, table);
     }
+
+    long double en = 0.0;
+    for (unsigned int i = 0; i < table.sizeResidues(); i++)
+        pSumResiduePair(self, 0, table, i, en);
     return en;
 }
 
@@ -131,13 +181,11 @@ long double RapdfPotential::calculateEnergy(AminoAcid& aa, Spacer& sp) {
 long double RapdfPotential::calculateEnergy(AminoAcid& aa, AminoAcid& aa2) {
     if (aa == aa2) // exclude self-energy
         return 0.0;
+    AtomTable table;
+    pAddResidue(aa, table);
+    pAddResidue(aa2, table);
     long double en = 0.0;
-    string aaType = aa.getType();
-    string aaType2 = aa2.getType();
-    for (unsigned int j = 0; j < aa.size(); j++)
-        for (unsigned int k = 0; k < aa2.size(); k++)
-            en += calculateEnergy(aa[j], aa2[k], aaType, aaType2);
-
+    pSumResiduePair(table, 0, table, 1, en);
     return en;
 }
 
@@ -146,6 +194,32 @@ long double RapdfPotential::calculateEnergy(AminoAcid& aa, AminoAcid& aa2) {
 /******************************************************************/
 // HELPERS:
 
+/**
+ *  Resolves the RAPDF atom types and distance bins once, instead of once
+ *  per atom pair.
+ */
+void RapdfPotential::pSetupTables() {
+    for (unsigned int i = 0; i < AminoAcid_CODE_SIZE; i++)
+        for (unsigned int j = 0; j < ATOM_CODE_SIZE; j++) {
+            AminoAcidCode aaCode = static_cast<AminoAcidCode> (i);
+            AtomCode atCode = static_cast<AtomCode> (j);
+            if ((atCode == OXT) || ((atCode == CB) && (aaCode == GLY))) {
+                typeIndex[i][j] = RAPDF_IGNORE;
+                continue;
+            }
+            string tmp = aminoAcidOneLetterTranslator(aaCode)
+                    + AtomTranslator(atCode);
+            unsigned int grp = pGetGroupBin(tmp.c_str());
+            typeIndex[i][j] = (grp < MAX_TYPES) ? grp : RAPDF_IGNORE;
+        }
+
+    // bin boundaries are integer distances, hence integer squared distances
+    for (unsigned int i = 0; i < MAX_SQR_DIST; i++)
+        distBin[i] = pGetDistanceBinOne(sqrt(static_cast<double> (i)));
+}
+
+/******************************************************************/
+
 /**
  *  Retrieves the corresponding index for the given distance
  *@param  distance (double)
@@ -179,6 +253,153 @@ unsigned int RapdfPotential::pGetDistanceBinOne(double distance)
 
 /******************************************************************/
 
+/**
+ *  Appends the coordinates and RAPDF types of the atoms of a residue to
+ *  the table.
+ *@param  amino acid reference(AminoAcid&), table reference(AtomTable&)
+ */
+void RapdfPotential::pAddResidue(AminoAcid& aa, AtomTable& table) {
+    AminoAcidCode aaCode = static_cast<AminoAcidCode> (aa.getCode());
+    for (unsigned int j = 0; j < aa.size(); j++) {
+        vgVector3<double> c = aa[j].getCoords();
+        table.x.push_back(c.x);
+        table.y.push_back(c.y);
+        table.z.push_back(c.z);
+        table.type.push_back(getTypeIndex(aaCode, aa[j].getCode()));
+    }
+    table.start.push_back(table.x.size());
+}
+
+/******************************************************************/
+
+/**
+ *  Fills an atom table with the residues of a coordinate snapshot.
+ *@param  snapshot (const SpacerCoordinates&), table to fill (AtomTable&)
+ */
+void RapdfPotential::pFillTable(const SpacerCoordinates& coords,
+        AtomTable& table) {
+    table.x = coords.getXs();
+    table.y = coords.getYs();
+    table.z = coords.getZs();
+    table.type.resize(coords.sizeAtoms());
+    table.start.resize(coords.sizeAmino() + 1);
+    for (unsigned int r = 0; r < coords.sizeAmino(); r++) {
+        AminoAcidCode aaCode = coords.getAminoCode(r);
+        for (unsigned int j = coords.getAminoStart(r);
+                j < coords.getAminoEnd(r); j++)
+            table.type[j] = getTypeIndex(aaCode, coords.getCode(j));
+        table.start[r + 1] = coords.getAminoEnd(r);
+    }
+}
+
+/******************************************************************/
+
+/**
+ *  Adds the energy of all atom pairs between two residues of the tables.
+ *@param  first table and residue index, second table and residue index,
+ *        energy accumulator (long double&)
+ */
+void RapdfPotential::pSumResiduePair(const AtomTable& t1, unsigned int r1,
+        const AtomTable& t2, unsigned int r2, long double& en) const {
+    for (unsigned int j = t1.start[r1]; j < t1.start[r1 + 1]; j++) {
+        unsigned int type1 = t1.type[j];
+        if (type1 == RAPDF_IGNORE)
+            continue;
+        for (unsigned int k = t2.start[r2]; k < t2.start[r2 + 1]; k++) {
+            unsigned int type2 = t2.type[k];
+            if (type2 == RAPDF_IGNORE)
+                continue;
+            double dx = t1.x[j] - t2.x[k];
+            double dy = t1.y[j] - t2.y[k];
+            double dz = t1.z[j] - t2.z[k];
+            en += pAtomEnergy(type1, type2, dx * dx + dy * dy + dz * dz);
+        }
+    }
+}
+
+/******************************************************************/
+
+/**
+ *  Adds the energy of residue pairs of the table. Row i, ie. the pairs
+ *  (i, ii > i), is summed on its own and the rows are added in order, so
+ *  that the result does not depend on the number of threads.
+ *@param  table reference(AtomTable&), partners of each residue, NULL for
+ *        all pairs (vector<vector<unsigned int> >*),
+ *        energy accumulator (long double&)
+ */
+void RapdfPotential::pSumRows(const AtomTable& table,
+        const vector<vector<unsigned int> >* partners, long double& en) const {
+    vector<long double> rows(table.sizeResidues(), 0.0);
+    RapdfRowTask task(*this, table, partners, rows);
+    runParallel(task, rows.size(), numThreads);
+    for (unsigned int i = 0; i < rows.size(); i++)
+        en += rows[i];
+}
+
+/******************************************************************/
+
+/**
+ *  Finds, for each residue i, the residues ii > i with at least one atom
+ *  pair possibly within the 20 A cutoff. Each residue is enclosed in a
+ *  sphere around its scored atoms and only pairs of overlapping (cutoff
+ *  enlarged) spheres, found with a NeighbourGrid, are kept. The pairs
+ *  dropped would only add zero terms, and the others are listed in
+ *  increasing order, so summing them gives the same result as all pairs.
+ *@param  table reference(AtomTable&), partners of each residue
+ *        (vector<vector<unsigned int> >&)
+ */
+void RapdfPotential::pGetNeighbourPairs(const AtomTable& table,
+        vector<vector<unsigned int> >& partners) const {
+    const double cutoff = sqrt(static_cast<double> (MAX_SQR_DIST));
+    const double margin = 0.01; // guard against rounding errors
+    unsigned int size = table.sizeResidues();
+    partners.assign(size, vector<unsigned int>());
+
+    vector<vgVector3<double> > centre(size, vgVector3<double>(0, 0, 0));
+    vector<double> radius(size, -1.0); // < 0: no scored atoms
+    vector<unsigned int> scored; // residues with scored atoms
+    double maxRadius = 0.0;
+    for (unsigned int i = 0; i < size; i++) {
+        unsigned int n = 0;
+        for (unsigned int j = table.start[i]; j < table.start[i + 1]; j++)
+            if (table.type[j] != RAPDF_IGNORE) {
+                centre[i] += vgVector3<double>(table.x[j], table.y[j], table.z[j]);
+                n++;
+            }
+        if (n == 0)
+            continue;
+        centre[i] /= n;
+        radius[i] = 0.0;
+        for (unsigned int j = table.start[i]; j < table.start[i + 1]; j++)
+            if (table.type[j] != RAPDF_IGNORE)
+                radius[i] = max(radius[i], (vgVector3<double>(table.x[j],
+                        table.y[j], table.z[j]) - centre[i]).length());
+        maxRadius = max(maxRadius, radius[i]);
+        scored.push_back(i);
+    }
+
+    vector<vgVector3<double> > points;
+    for (unsigned int i = 0; i < scored.size(); i++)
+        points.push_back(centre[scored[i]]);
+    NeighbourGrid grid(points, cutoff + 2 * maxRadius + margin);
+
+    vector<unsigned int> cand;
+    for (unsigned int c = 0; c < scored.size(); c++) {
+        unsigned int i = scored[c];
+        grid.getCandidates(centre[i], cand);
+        for (unsigned int k = 0; k < cand.size(); k++) {
+            if (cand[k] <= c)
+                continue;
+            unsigned int ii = scored[cand[k]];
+            double range = cutoff + radius[i] + radius[ii] + margin;
+            if ((centre[ii] - centre[i]).square() < range * range)
+                partners[i].push_back(ii);
+        }
+    }
+}
+
+/******************************************************************/
+
 /**
  *  Retrieves the corresponding index for the given group(AAtype_AtomType)
  *@param  group name (char*)
@@ -20,13 +20,20 @@
 // Includes:
 #include <vector>
 #include <Potential.h>
+#include <AminoAcidCode.h>
+#include <SpacerCoordinates.h>
 
 // Global constants, typedefs, etc. (to avoid):
 const unsigned int MAX_BINS = 18;
 const unsigned int MAX_TYPES = 168;
+const unsigned int MAX_SQR_DIST = 400; // (20 A)^2, interaction cutoff
+const unsigned int RAPDF_IGNORE = 999; // atom type or distance not scored
 
  namespace Victor { namespace Energy {
 
+    class RapdfRowTask;
+    class RapdfSegmentEnergy;
+
     /**
      * @brief Distance-dependent residue-specific all-atom probability discriminatory function.
      * 
@@ -41,6 +48,7 @@ const unsigned int MAX_TYPES = 168;
 
         // CONSTRUCTORS/DESTRUCTOR:
         RapdfPotential();
+        RapdfPotential(const string& paramFile);
 
         virtual ~RapdfPotential() {
             PRINT_NAME;
@@ -51,21 +59,62 @@ const unsigned int MAX_TYPES = 168;
         virtual long double calculateEnergy(Spacer& sp, unsigned int index1,
                 unsigned int index2);
         virtual long double calculateEnergy(AminoAcid& aa, Spacer& sp);
+        long double calculateEnergy(const SpacerCoordinates& coords);
         virtual long double calculateEnergy(AminoAcid& aa, AminoAcid& aa2);
         virtual long double calculateEnergy(Atom& at1, Atom& at2, string aaType,
                 string aaType2);
 
+        unsigned int getTypeIndex(AminoAcidCode aa, AtomCode at) const;
+        bool isUsingGrid() const;
+
         // MODIFIERS: 
+        void setUseGrid(bool use);
+
+        friend class RapdfRowTask;
+        friend class RapdfSegmentEnergy;
         // OPERATORS:
 
     protected:
 
+        /**
+         * Flat copy of the atoms of a set of residues, with the RAPDF type
+         * of each atom resolved once. Atoms of residue i are stored in the
+         * range [start[i], start[i+1]).
+         */
+        struct AtomTable {
+            vector<double> x, y, z;
+            vector<unsigned int> type;
+            vector<unsigned int> start;
+
+            AtomTable() : start(1, 0) {
+            }
+
+            unsigned int sizeResidues() const {
+                return start.size() - 1;
+            }
+        };
+
         // HELPERS:
+        void pSetupTables();
         unsigned int pGetDistanceBinOne(double distance);
         unsigned int pGetGroupBin(const char* group_name);
+        void pAddResidue(AminoAcid& aa, AtomTable& table);
+        void pFillTable(const SpacerCoordinates& coords, AtomTable& table);
+        void pSumResiduePair(const AtomTable& t1, unsigned int r1,
+                const AtomTable& t2, unsigned int r2, long double& en) const;
+        void pSumRows(const AtomTable& table,
+                const vector<vector<unsigned int> >* partners,
+                long double& en) const;
+        void pGetNeighbourPairs(const AtomTable& table,
+                vector<vector<unsigned int> >& partners) const;
+        double pAtomEnergy(unsigned int type1, unsigned int type2,
+                double sqrDist) const;
 
         // ATTRIBUTES:
         double prob[MAX_BINS][MAX_TYPES][MAX_TYPES];
+        unsigned int typeIndex[AminoAcid_CODE_SIZE][ATOM_CODE_SIZE];
+        unsigned int distBin[MAX_SQR_DIST];
+        bool useGrid; // skip residue pairs out of range with a NeighbourGrid
 
     public:
 
@@ -85,20 +134,55 @@ const unsigned int MAX_TYPES = 168;
      */
     inline long double RapdfPotential::calculateEnergy(Atom& at1, Atom& at2, string aaType,
             string aaType2) {
-        double d = at1.distance(at2);
-        if ((d >= 20.0) || (at1.getType() == "OXT") || (at2.getType() == "OXT")
-                || ((at1.getType() == "CB") && (aaType == "GLY"))
-                || ((at2.getType() == "CB") && (aaType2 == "GLY")))
+        unsigned int grp1 = getTypeIndex(aminoAcidThreeLetterTranslator(aaType),
+                at1.getCode());
+        unsigned int grp2 = getTypeIndex(aminoAcidThreeLetterTranslator(aaType2),
+                at2.getCode());
+        if ((grp1 == RAPDF_IGNORE) || (grp2 == RAPDF_IGNORE))
+            return 0.0;
+        return pAtomEnergy(grp1, grp2,
+                (at1.getCoords() - at2.getCoords()).square());
+    }
+
+    /**
+     *  Returns the RAPDF atom type for an atom of a given residue type.
+     *@param   the amino acid and atom codes (AminoAcidCode, AtomCode)
+     *@return    type index, RAPDF_IGNORE if the atom is not scored (unsigned int)
+     */
+    inline unsigned int RapdfPotential::getTypeIndex(AminoAcidCode aa,
+            AtomCode at) const {
+        return typeIndex[aa][at];
+    }
+
+    /**
+     *  Is the neighbour grid used to skip distant residue pairs?
+     *@return    bool
+     */
+    inline bool RapdfPotential::isUsingGrid() const {
+        return useGrid;
+    }
+
+    /**
+     *  Selects the neighbour grid or the all-pairs loop for the Spacer
+     *  energy. Both give the same result.
+     *@param   use the grid (bool)
+     */
+    inline void RapdfPotential::setUseGrid(bool use) {
+        useGrid = use;
+    }
+
+    /**
+     *  Looks up the energy of two typed atoms at a given squared distance.
+     *  Distance bins are 1 A wide with integer boundaries, so the integer
+     *  part of the squared distance is enough to find the bin.
+     *@param   the atom types and their squared distance (unsigned int, unsigned int, double)
+     *@return    energy value (double)
+     */
+    inline double RapdfPotential::pAtomEnergy(unsigned int type1,
+            unsigned int type2, double sqrDist) const {
+        if (sqrDist >= MAX_SQR_DIST)
             return 0.0;
-        string tmp1 = threeLetter2OneLetter(aaType) + at1.getType();
-        string tmp2 = threeLetter2OneLetter(aaType2) + at2.getType();
-        unsigned int dist = pGetDistanceBinOne(d);
-        unsigned int grp1 = pGetGroupBin(tmp1.c_str());
-        unsigned int grp2 = pGetGroupBin(tmp2.c_str());
-        if (dist + grp1 + grp2 < 999)
-            return prob[dist][grp1][grp2];
-        else // ignore errors
-            return 0;
+        return prob[distBin[static_cast<unsigned int> (sqrDist)]][type1][type2];
     }
 
 }} // namespace
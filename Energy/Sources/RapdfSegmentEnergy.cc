@@ -0,0 +1,283 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Includes:
+#include <RapdfSegmentEnergy.h>
+#include <cmath>
+
+using namespace Victor;
+
+using namespace Victor::Biopool;
+
+using namespace Victor::Energy;
+
+// Global constants, typedefs, etc. (to avoid):
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *  Builds an empty segment energy on a (loaded) RAPDF potential.
+ *@param   potential providing types and parameters (RapdfPotential&)
+ */
+RapdfSegmentEnergy::RapdfSegmentEnergy(RapdfPotential& _rapdf) : rapdf(_rapdf) {
+}
+
+// PREDICATES:
+
+/**
+ *  Returns the energy of the segment in its environment, including the
+ *  terms of a pending move that has been evaluated.
+ *@return energy value (long double)
+ */
+long double RapdfSegmentEnergy::getEnergy() const {
+    long double en = 0.0;
+    for (unsigned int r = 0; r < envEnergy.size(); r++) {
+        en += envEnergy[r];
+        for (unsigned int t = r + 1; t < envEnergy.size(); t++)
+            en += pairEnergy[r][t];
+    }
+    return en;
+}
+
+/**
+ *  Recalculates the terms of the residues moved since the last accepted
+ *  or rejected move and returns the resulting energy.
+ *@return energy value (long double)
+ */
+long double RapdfSegmentEnergy::calculateTrialEnergy() {
+    for (unsigned int k = 0; k < movedResidues.size(); k++)
+        pUpdateSphere(seg, movedResidues[k], segCentre, segRadius);
+    for (unsigned int k = 0; k < movedResidues.size(); k++)
+        pCalculateTerms(movedResidues[k]);
+    return getEnergy();
+}
+
+/**
+ *  Returns the current coordinates of an atom of the segment.
+ *@param   segment residue and atom code (unsigned int, AtomCode)
+ *@return coordinates (vgVector3<double>)
+ */
+vgVector3<double> RapdfSegmentEnergy::getCoords(unsigned int residue,
+        AtomCode code) const {
+    unsigned int j = pGetAtomIndex(residue, code);
+    return vgVector3<double>(seg.x[j], seg.y[j], seg.z[j]);
+}
+
+// MODIFIERS:
+
+/**
+ *  Sets the fixed residues: all residues of the Spacer except the ones
+ *  from index1 to index2 (both included), as in LoopModel.
+ *@param   spacer, first and last excluded residue (Spacer&, unsigned int, unsigned int)
+ */
+void RapdfSegmentEnergy::setEnvironment(Spacer& sp, unsigned int index1,
+        unsigned int index2) {
+    PRECOND(!isMoving(), exception);
+    env = RapdfPotential::AtomTable();
+    for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+        if ((i < index1) || (i > index2))
+            rapdf.pAddResidue(sp.getAmino(i), env);
+
+    envCentre.resize(env.sizeResidues());
+    envRadius.resize(env.sizeResidues());
+    for (unsigned int i = 0; i < env.sizeResidues(); i++)
+        pUpdateSphere(env, i, envCentre, envRadius);
+
+    for (unsigned int r = 0; r < seg.sizeResidues(); r++)
+        pCalculateTerms(r);
+}
+
+/**
+ *  Sets the moving residues and calculates all their terms. The Spacer
+ *  is only read.
+ *@param   segment (Spacer&)
+ */
+void RapdfSegmentEnergy::setSegment(Spacer& segSp) {
+    PRECOND(!isMoving(), exception);
+    seg = RapdfPotential::AtomTable();
+    segCode.clear();
+    for (unsigned int r = 0; r < segSp.sizeAmino(); r++) {
+        AminoAcid& aa = segSp.getAmino(r);
+        rapdf.pAddResidue(aa, seg);
+        for (unsigned int j = 0; j < aa.size(); j++)
+            segCode.push_back(static_cast<AtomCode> (aa[j].getCode()));
+    }
+
+    unsigned int size = seg.sizeResidues();
+    segCentre.resize(size);
+    segRadius.resize(size);
+    for (unsigned int r = 0; r < size; r++)
+        pUpdateSphere(seg, r, segCentre, segRadius);
+
+    envEnergy.assign(size, 0.0);
+    pairEnergy.assign(size, vector<long double>(size, 0.0));
+    moved.assign(size, false);
+    for (unsigned int r = 0; r < size; r++)
+        pCalculateTerms(r);
+}
+
+/**
+ *  Moves an atom of the segment as part of the pending move. The energy
+ *  is only updated by calculateTrialEnergy().
+ *@param   segment residue, atom code, displacement (unsigned int, AtomCode, vgVector3<double>)
+ */
+void RapdfSegmentEnergy::moveAtom(unsigned int residue, AtomCode code,
+        vgVector3<double> disp) {
+    unsigned int j = pGetAtomIndex(residue, code);
+    movedAtoms.push_back(j);
+    oldCoords.push_back(vgVector3<double>(seg.x[j], seg.y[j], seg.z[j]));
+    seg.x[j] += disp.x;
+    seg.y[j] += disp.y;
+    seg.z[j] += disp.z;
+
+    if (!moved[residue]) {
+        moved[residue] = true;
+        movedResidues.push_back(residue);
+        oldEnvEnergy.push_back(envEnergy[residue]);
+        oldPairEnergy.push_back(pairEnergy[residue]);
+    }
+}
+
+/**
+ *  Keeps the pending move. It must have been evaluated with
+ *  calculateTrialEnergy().
+ */
+void RapdfSegmentEnergy::acceptMove() {
+    for (unsigned int k = 0; k < movedResidues.size(); k++)
+        moved[movedResidues[k]] = false;
+    movedAtoms.clear();
+    oldCoords.clear();
+    movedResidues.clear();
+    oldEnvEnergy.clear();
+    oldPairEnergy.clear();
+}
+
+/**
+ *  Rolls back the pending move, restoring coordinates and cached terms.
+ */
+void RapdfSegmentEnergy::rejectMove() {
+    for (unsigned int k = movedAtoms.size(); k > 0; k--) {
+        unsigned int j = movedAtoms[k - 1];
+        seg.x[j] = oldCoords[k - 1].x;
+        seg.y[j] = oldCoords[k - 1].y;
+        seg.z[j] = oldCoords[k - 1].z;
+    }
+
+    // restore in reverse order, a row saved later may hold a trial term
+    for (unsigned int k = movedResidues.size(); k > 0; k--) {
+        unsigned int r = movedResidues[k - 1];
+        envEnergy[r] = oldEnvEnergy[k - 1];
+        pairEnergy[r] = oldPairEnergy[k - 1];
+        for (unsigned int t = 0; t < pairEnergy.size(); t++)
+            pairEnergy[t][r] = pairEnergy[r][t];
+        pUpdateSphere(seg, r, segCentre, segRadius);
+    }
+    acceptMove();
+}
+
+// HELPERS:
+
+/**
+ *  Finds an atom of the segment.
+ *@param   segment residue and atom code (unsigned int, AtomCode)
+ *@return index of the atom in the segment table (unsigned int)
+ */
+unsigned int RapdfSegmentEnergy::pGetAtomIndex(unsigned int residue,
+        AtomCode code) const {
+    PRECOND(residue < seg.sizeResidues(), exception);
+    for (unsigned int j = seg.start[residue]; j < seg.start[residue + 1]; j++)
+        if (segCode[j] == code)
+            return j;
+    ERROR("Atom not found in segment.", exception);
+    return 0;
+}
+
+/******************************************************************/
+
+/**
+ *  Encloses the scored atoms of residue r of a table in a sphere, as in
+ *  RapdfPotential::pGetNeighbourPairs().
+ *@param   table and residue (AtomTable&, unsigned int), centres and radii
+ *         to update (vector<vgVector3<double> >&, vector<double>&)
+ */
+void RapdfSegmentEnergy::pUpdateSphere(const RapdfPotential::AtomTable& table,
+        unsigned int r, vector<vgVector3<double> >& centre,
+        vector<double>& radius) const {
+    centre[r] = vgVector3<double>(0, 0, 0);
+    radius[r] = -1.0;
+    unsigned int n = 0;
+    for (unsigned int j = table.start[r]; j < table.start[r + 1]; j++)
+        if (table.type[j] != RAPDF_IGNORE) {
+            centre[r] += vgVector3<double>(table.x[j], table.y[j], table.z[j]);
+            n++;
+        }
+    if (n == 0)
+        return;
+    centre[r] /= n;
+    radius[r] = 0.0;
+    for (unsigned int j = table.start[r]; j < table.start[r + 1]; j++)
+        if (table.type[j] != RAPDF_IGNORE)
+            radius[r] = max(radius[r], (vgVector3<double>(table.x[j],
+                table.y[j], table.z[j]) - centre[r]).length());
+}
+
+/******************************************************************/
+
+/**
+ *  Can two residues, given by their spheres, have an atom pair within the
+ *  20 A cutoff? The pairs skipped would only add zero terms.
+ *@param   centre and radius of both residues
+ *@return bool
+ */
+bool RapdfSegmentEnergy::pInRange(const vgVector3<double>& c1, double r1,
+        const vgVector3<double>& c2, double r2) const {
+    const double margin = 0.01; // guard against rounding errors
+    if ((r1 < 0.0) || (r2 < 0.0))
+        return false;
+    double range = sqrt(static_cast<double> (MAX_SQR_DIST)) + r1 + r2 + margin;
+    return (c1 - c2).square() < range * range;
+}
+
+/******************************************************************/
+
+/**
+ *  Calculates the terms of segment residue r: with the environment and
+ *  with each other segment residue. Atom pairs keep the order of
+ *  LoopModel, ie. environment first and lower segment residue first.
+ *@param   segment residue (unsigned int)
+ */
+void RapdfSegmentEnergy::pCalculateTerms(unsigned int r) {
+    long double en = 0.0;
+    for (unsigned int e = 0; e < env.sizeResidues(); e++)
+        if (pInRange(envCentre[e], envRadius[e], segCentre[r], segRadius[r]))
+            rapdf.pSumResiduePair(env, e, seg, r, en);
+    envEnergy[r] = en;
+
+    for (unsigned int t = 0; t < seg.sizeResidues(); t++) {
+        if (t == r) // exclude self-energy
+            continue;
+        long double pair = 0.0;
+        if (pInRange(segCentre[t], segRadius[t], segCentre[r], segRadius[r])) {
+            if (t < r)
+                rapdf.pSumResiduePair(seg, t, seg, r, pair);
+            else
+                rapdf.pSumResiduePair(seg, r, seg, t, pair);
+        }
+        pairEnergy[r][t] = pair;
+        pairEnergy[t][r] = pair;
+    }
+}
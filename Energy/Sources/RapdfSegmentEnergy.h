@@ -0,0 +1,111 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef _RAPDFSEGMENTENERGY_H_
+#define _RAPDFSEGMENTENERGY_H_
+
+// Includes:
+#include <vector>
+#include <RapdfPotential.h>
+
+// Global constants, typedefs, etc. (to avoid):
+
+namespace Victor { namespace Energy {
+
+    /**
+     * @brief RAPDF energy of a segment (eg. a loop) in a fixed environment,
+     * updated incrementally when segment atoms are moved.
+     * 
+     *  The energy is the same as summing RapdfPotential::calculateEnergy(aa, aa2)
+     * over all (environment, segment) and (segment, segment) residue pairs.
+     * The term of each segment residue with the environment and the term of
+     * each pair of segment residues are cached, so a trial move only
+     * recalculates the terms of the residues it touches. Moves are applied
+     * to an internal copy of the coordinates and can be accepted or rolled
+     * back, ie. the Spacers are never modified or copied.
+     * */
+    class RapdfSegmentEnergy {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        RapdfSegmentEnergy(RapdfPotential& _rapdf);
+
+        virtual ~RapdfSegmentEnergy() {
+            PRINT_NAME;
+        }
+
+        // PREDICATES:
+        long double getEnergy() const;
+        long double calculateTrialEnergy();
+        vgVector3<double> getCoords(unsigned int residue, AtomCode code) const;
+        bool isMoving() const;
+
+        // MODIFIERS:
+        void setEnvironment(Spacer& sp, unsigned int index1,
+                unsigned int index2);
+        void setSegment(Spacer& seg);
+        void moveAtom(unsigned int residue, AtomCode code,
+                vgVector3<double> disp);
+        void acceptMove();
+        void rejectMove();
+
+    protected:
+
+        // HELPERS:
+        unsigned int pGetAtomIndex(unsigned int residue, AtomCode code) const;
+        void pUpdateSphere(const RapdfPotential::AtomTable& table,
+                unsigned int r, vector<vgVector3<double> >& centre,
+                vector<double>& radius) const;
+        bool pInRange(const vgVector3<double>& c1, double r1,
+                const vgVector3<double>& c2, double r2) const;
+        void pCalculateTerms(unsigned int r);
+
+        // ATTRIBUTES:
+        RapdfPotential& rapdf;
+        RapdfPotential::AtomTable env; // fixed residues
+        vector<vgVector3<double> > envCentre; // sphere around scored atoms
+        vector<double> envRadius; // < 0: no scored atoms
+        RapdfPotential::AtomTable seg; // moving residues
+        vector<AtomCode> segCode; // code of each segment atom
+        vector<vgVector3<double> > segCentre;
+        vector<double> segRadius;
+        vector<long double> envEnergy; // segment residue vs. environment
+        vector<vector<long double> > pairEnergy; // segment residue pairs
+
+        // pending move, kept to roll it back:
+        vector<unsigned int> movedAtoms;
+        vector<vgVector3<double> > oldCoords;
+        vector<unsigned int> movedResidues;
+        vector<bool> moved;
+        vector<long double> oldEnvEnergy;
+        vector<vector<long double> > oldPairEnergy;
+    };
+
+    // ---------------------------------------------------------------------------
+    //                            RapdfSegmentEnergy
+    // -----------------x-------------------x-------------------x-----------------
+
+    /**
+     *  Is a move pending, ie. neither accepted nor rejected?
+     *@return    bool
+     */
+    inline bool RapdfSegmentEnergy::isMoving() const {
+        return !movedAtoms.empty();
+    }
+
+}} // namespace
+#endif //_RAPDFSEGMENTENERGY_H_
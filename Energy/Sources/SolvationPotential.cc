@@ -18,6 +18,8 @@
 // Includes:
 #include <float.h>
 #include <SolvationPotential.h>
+#include <ThreadTools.h>
+#include <EmbeddedData.h>
 
 using namespace Victor;
 
@@ -26,50 +28,90 @@ using namespace Victor::Biopool;
 using namespace Victor::Energy;
 
 // Global constants, typedefs, etc. (to avoid):
+
+namespace Victor {
+    extern const EmbeddedData EMBEDDED_SOLV_PAR; // data/solv.par
+}
+
+namespace Victor { namespace Energy {
+
+    /**
+     * Solvation of residue offset + n of a Spacer, stored in slot n. The
+     * grid is shared read-only by all threads.
+     */
+    class SolvationTask : public ParallelTask {
+    public:
+
+        SolvationTask(SolvationPotential& _pot, Spacer& _sp, unsigned int _offset,
+                const ResidueGrid& _grid, vector<long double>& _terms)
+        : pot(_pot), sp(_sp), offset(_offset), grid(_grid), terms(_terms) {
+        }
+
+        virtual void run(unsigned int n) {
+            terms[n] = pot.pCalculateSolvation(sp.getAmino(offset + n), sp, 0,
+                    9999, grid);
+        }
+
+    private:
+        SolvationPotential& pot;
+        Spacer& sp;
+        unsigned int offset;
+        const ResidueGrid& grid;
+        vector<long double>& terms;
+    };
+
+}} // namespace
+
 unsigned int SolvationPotential::MAX_BINS = 30;
 
 // CONSTRUCTORS/DESTRUCTOR:
 
 /**
- *     Basic constructor, allocate information from the "solv.par" file, and set the min and max propensities values.
+ *     Basic constructor, uses the solv.par tables compiled into the library, and sets the min and max propensities values.
  *@param      _resol is the number of bins to calculate the statistics. 1 = max resulution.
  */
-SolvationPotential::SolvationPotential(unsigned int _resol) : sum(), binResolution(_resol) {
-    char *victor = getenv("VICTOR_ROOT");
-    if (victor == NULL)
-        ERROR("Environment variable VICTOR_ROOT was not found.\n Use the command:\n export VICTOR_ROOT=......", exception);
-    string path = "data/solv.par"; //comment this if you are using a no 64bits OC
-    string inputFile = getenv("VICTOR_ROOT");
-    if (inputFile.length() < 3)
-        ERROR("Environment variable VICTOR_ROOT was not found.", exception);
-    //inputFile += SOLV_PARAM_FILE;//uncomment this if you are using a no 64bits OC
-    inputFile += path; //comment this if you are using a no 64bits OC
-    ifstream input(inputFile.c_str());
+SolvationPotential::SolvationPotential(unsigned int _resol) : sum(
+AminoAcid_CODE_SIZE, vector<int>((MAX_BINS / _resol) + 1, 0)),
+grid(SOLVATION_CUTOFF_DISTANCE), gridLock(), binResolution(_resol) {
+    // one record per residue type: total count, name, MAX_BINS counts
+    if (EMBEDDED_SOLV_PAR.sizeNumbers
+            != EMBEDDED_SOLV_PAR.sizeWords * (MAX_BINS + 1))
+        ERROR("SolvationPotential() : embedded solv.par table has the wrong size.",
+            exception);
+    const double* p = EMBEDDED_SOLV_PAR.numbers;
+    for (unsigned int r = 0; r < EMBEDDED_SOLV_PAR.sizeWords; r++) {
+        unsigned int num = static_cast<unsigned int> (*p++);
+        vector<int> counts(p, p + MAX_BINS);
+        p += MAX_BINS;
+        pSetCounts(aminoAcidThreeLetterTranslator(EMBEDDED_SOLV_PAR.words[r]),
+                num, counts);
+    }
+
+    pConstructMaxPropensities();
+    pConstructMinPropensities();
+}
+
+/**
+ *     Constructor for custom tables, reads a file in the solv.par format, and sets the min and max propensities values.
+ *@param      parameter file name (string), _resol is the number of bins to calculate the statistics. 1 = max resulution.
+ */
+SolvationPotential::SolvationPotential(const string& paramFile,
+        unsigned int _resol) : sum(AminoAcid_CODE_SIZE,
+vector<int>((MAX_BINS / _resol) + 1, 0)), grid(SOLVATION_CUTOFF_DISTANCE),
+gridLock(), binResolution(_resol) {
+    ifstream input(paramFile.c_str());
     if (!input)
         ERROR("Could not read data file.", exception);
-    for (unsigned int i = 0; i < AminoAcid_CODE_SIZE; i++) {
-        vector<int >* tmp = new vector<int >;
-        (*tmp).reserve(MAX_BINS / binResolution);
-        for (unsigned int i = 0; i < (MAX_BINS / binResolution) + 1; i++)
-            (*tmp).push_back(0);
-        sum.push_back(*tmp);
-    }
     while (input) {
         unsigned int num;
         string type;
         input >> num >> type;
         if (!input)
             break;
-        AminoAcidCode code = aminoAcidThreeLetterTranslator(type);
-        sum[code][(MAX_BINS / binResolution)] = num;
-        for (unsigned int i = 0; i < (MAX_BINS / binResolution); i++) {
-            sum[code][i] = 0;
-            for (unsigned int j = 0; j < binResolution; j++) {
-                int tmp;
-                input >> tmp;
-                sum[code][i] += tmp;
-            }
-        }
+        vector<int> counts(MAX_BINS, 0);
+        for (unsigned int i = 0; i < MAX_BINS; i++)
+            input >> counts[i];
+        pSetCounts(aminoAcidThreeLetterTranslator(type), num, counts);
     }
 
     input.close();
@@ -85,10 +127,7 @@ SolvationPotential::SolvationPotential(unsigned int _resol) : sum(), binResoluti
  *@return    value of the total solvation potential(long double)
  */
 long double SolvationPotential::calculateSolvation(Spacer& sp) {
-    long double solv = 0.0;
-    for (unsigned int i = 0; i < sp.sizeAmino(); i++)
-        solv += calculateSolvation(sp.getAmino(i), sp);
-    return solv;
+    return calculateEnergy(sp, 0, sp.sizeAmino());
 }
 
 /**
@@ -97,9 +136,22 @@ long double SolvationPotential::calculateSolvation(Spacer& sp) {
  *@return    value of the total solvation potential(long double)
  */
 long double SolvationPotential::calculateEnergy(Spacer& sp, unsigned int index1, unsigned int index2) {
+    if (index2 <= index1)
+        return 0.0;
+    // coordinates are only read from here on, allowing concurrent access
+    for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+        sp.getAmino(i).sync();
+
+    ResidueGrid cb(SOLVATION_CUTOFF_DISTANCE);
+    sBuildGrid(sp, cb);
+
+    vector<long double> terms(index2 - index1, 0.0);
+    SolvationTask task(*this, sp, index1, cb, terms);
+    runParallel(task, terms.size(), numThreads);
+
     long double solv = 0.0;
-    for (unsigned int i = index1; i < index2; i++)
-        solv += calculateSolvation(sp.getAmino(i), sp);
+    for (unsigned int i = 0; i < terms.size(); i++)
+        solv += terms[i];
     return solv;
 }
 
@@ -110,28 +162,10 @@ long double SolvationPotential::calculateEnergy(Spacer& sp, unsigned int index1,
  *@return    value of the total solvation potential(long double)
  */
 long double SolvationPotential::calculateSolvation(AminoAcid& aa, Spacer& sp, unsigned int start, unsigned int end) {
-    if ((aa.getCode() == GLY) || (!aa.getSideChain().isMember(CB)))
-        return 0.0;
-    start = (start >= 0) ? start : 0;
-    end = (end < sp.sizeAmino()) ? end : sp.sizeAmino() - 1;
-    unsigned int count = 0;
-    for (unsigned int j = start; j <= end; j++) {
-        if (sp.getAmino(j).getSideChain().isMember(CB))
-            if ((aa.getSideChain()[CB].distance(
-                    sp.getAmino(j).getSideChain()[CB]) <= SOLVATION_CUTOFF_DISTANCE)
-                    && (aa.getSideChain()[CB].distance(
-                    sp.getAmino(j).getSideChain()[CB]) > 0.0)) // check not identical
-                count++;
-    }
-    // adapt to binResolution:
-    count /= binResolution;
-    if (count >= (MAX_BINS / binResolution))
-        count = (MAX_BINS / binResolution) - 1;
-    long double a = static_cast<long double> (sum[aa.getCode()][count] + 1) /
-            static_cast<long double> (sum[aa.getCode()][MAX_BINS / binResolution]);
-    long double b = static_cast<long double> (sum[sum.size() - 1][count] + 1) /
-            static_cast<long double> (sum[sum.size() - 1][MAX_BINS / binResolution]);
-    return -propCoeff() * log(a / b);
+    MutexLock lock(gridLock);
+    if (!grid.isValid(sp))
+        sBuildGrid(sp, grid);
+    return pCalculateSolvation(aa, sp, start, end, grid);
 }
 
 /**
@@ -152,14 +186,13 @@ long double SolvationPotential::calculateSolvation(AminoAcid& resid, AminoAcidCo
 
     /* count the number of CB atoms that are within a cutoff distance
        of the CB atom of resid. */
-    unsigned int count = 0;
-    for (unsigned int j = 0; j < sp.sizeAmino(); j++) {
-        if (sp.getAmino(j).getSideChain().isMember(CB))
-            if ((resid.getSideChain()[CB].distance(
-                    sp.getAmino(j).getSideChain()[CB]) <= SOLVATION_CUTOFF_DISTANCE)
-                    && (resid.getSideChain()[CB].distance(
-                    sp.getAmino(j).getSideChain()[CB]) > 0.0)) // check not identical
-                count++;
+    unsigned int count;
+    {
+        MutexLock lock(gridLock);
+        if (!grid.isValid(sp))
+            sBuildGrid(sp, grid);
+        count = pCountNeighbours(resid.getSideChain()[CB], 0, sp.sizeAmino(),
+                grid);
     }
     /* use such a count as a bin index in the solvation-potential table.
        Legend: a:amino acid type; c:count; o:occurrences; t:total; f:fraction */
@@ -176,6 +209,66 @@ long double SolvationPotential::calculateSolvation(AminoAcid& resid, AminoAcidCo
     return -propCoeff() * log(caf / ctf);
 }
 
+/**
+ *  solvation potential of a residue with respect to a portion of the spacer, 
+ *  counting its neighbours with the grid of the spacer's CB atoms.
+ *@param  reference of a residue (AminoAcid&), reference of a Spacer(Spacer&), index for the beginning and ending position of the residues portion(unsigned int), grid of the CB atoms of the Spacer (const ResidueGrid&)
+ *@return    value of the solvation potential(long double)
+ */
+long double SolvationPotential::pCalculateSolvation(AminoAcid& aa, Spacer& sp,
+        unsigned int start, unsigned int end, const ResidueGrid& g) {
+    if ((aa.getCode() == GLY) || (!aa.getSideChain().isMember(CB)))
+        return 0.0;
+    start = (start >= 0) ? start : 0;
+    end = (end < sp.sizeAmino()) ? end : sp.sizeAmino() - 1;
+    unsigned int count = pCountNeighbours(aa.getSideChain()[CB], start,
+            end + 1, g);
+    // adapt to binResolution:
+    count /= binResolution;
+    if (count >= (MAX_BINS / binResolution))
+        count = (MAX_BINS / binResolution) - 1;
+    long double a = static_cast<long double> (sum[aa.getCode()][count] + 1) /
+            static_cast<long double> (sum[aa.getCode()][MAX_BINS / binResolution]);
+    long double b = static_cast<long double> (sum[sum.size() - 1][count] + 1) /
+            static_cast<long double> (sum[sum.size() - 1][MAX_BINS / binResolution]);
+    return -propCoeff() * log(a / b);
+}
+
+/**
+ *  counts the CB atoms of residues start to end - 1 which are within 
+ *  SOLVATION_CUTOFF_DISTANCE of a CB atom, but not identical to it. Only 
+ *  the residues in the cells around the atom are tested.
+ *@param  CB atom (Atom&), index for the beginning and (past the) ending position of the residues portion(unsigned int), grid of the CB atoms (const ResidueGrid&)
+ *@return    number of neighbours (unsigned int)
+ */
+unsigned int SolvationPotential::pCountNeighbours(Atom& cb, unsigned int start,
+        unsigned int end, const ResidueGrid& g) const {
+    vector<unsigned int> candidates;
+    g.getCandidates(cb.getCoords(), candidates);
+    unsigned int count = 0;
+    for (unsigned int k = 0; k < candidates.size(); k++) {
+        unsigned int j = candidates[k];
+        if ((j < start) || (j >= end))
+            continue;
+        double d = cb.distance(*g.getAtom(j));
+        if ((d <= SOLVATION_CUTOFF_DISTANCE) && (d > 0.0)) // check not identical
+            count++;
+    }
+    return count;
+}
+
+/**
+ *  bins the CB atoms of all residues of the spacer.
+ *@param  reference of a Spacer(Spacer&), grid to build (ResidueGrid&)
+ */
+void SolvationPotential::sBuildGrid(Spacer& sp, ResidueGrid& g) {
+    vector<Atom*> atoms(sp.sizeAmino(), static_cast<Atom*> (NULL));
+    for (unsigned int j = 0; j < sp.sizeAmino(); j++)
+        if (sp.getAmino(j).getSideChain().isMember(CB))
+            atoms[j] = &sp.getAmino(j).getSideChain()[CB];
+    g.build(sp, atoms);
+}
+
 /**
  *     obtains the propensity value
  *@param  amino acid type (AminoAcidCode), count (unsigned int)
@@ -224,6 +317,23 @@ long double SolvationPotential::pGetMinPropensity(const AminoAcidCode type) cons
     return min;
 }
 
+/**
+ *     stores the counts of one amino acid type, merging binResolution
+ *    consecutive bins into one.
+ *@param   amino acid type (AminoAcidCode), total count (unsigned int),
+ *         count of each of the MAX_BINS bins (vector<int>)
+ *@return    changes the object internally (void)  
+ */
+void Victor::Energy::SolvationPotential::pSetCounts(AminoAcidCode code,
+        unsigned int num, const vector<int>& counts) {
+    sum[code][(MAX_BINS / binResolution)] = num;
+    for (unsigned int i = 0; i < (MAX_BINS / binResolution); i++) {
+        sum[code][i] = 0;
+        for (unsigned int j = 0; j < binResolution; j++)
+            sum[code][i] += counts[i * binResolution + j];
+    }
+}
+
 /**
  *     stores the maximum propensity of each amino acid type. 
  *    the max. propensity of the i-th amino acid type in the AminoAcidCode
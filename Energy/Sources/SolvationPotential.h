@@ -23,7 +23,9 @@
 // Includes:
 #include <vector>
 #include <Spacer.h>
+#include <ResidueGrid.h>
 #include <Potential.h>
+#include <ThreadTools.h>
 
 // Global constants, typedefs, etc. (to avoid):
 const double SOLVATION_CUTOFF_DISTANCE = 10.0;
@@ -31,6 +33,7 @@ const double SOLVATION_CUTOFF_DISTANCE = 10.0;
 using namespace Victor;
 namespace Victor { namespace Energy {
 
+    class SolvationTask;
    
     /**@brief Includes methods that allow to  calculate solvation, energy and propensity. 
      * 
@@ -40,12 +43,17 @@ namespace Victor { namespace Energy {
      *   Cβ atoms within a sphere of radius 10 Å centered on the residue’s Cβ atom. This computationally simple measure was reported to correlate very well (cc > 0.85) with the accessible surface of the residue (Jones, 1999). 
      *   Since up to 40 surrounding Cβ atoms were encountered in the database, individual propensity bins
      *   were chosen for each number i of surrounding Cβ atoms (i = 0,..., 40). The energy for a given structure is calculated by summing the individual energies over all residues in the protein.
+     * 
+     *   The Cβ atoms are counted with a ResidueGrid, kept for the last chain
+     *   evaluated residue by residue, so a residue only looks at the Cβ atoms
+     *   of the cells around it.
     */
     class SolvationPotential : public Potential {
     public:
 
         // CONSTRUCTORS/DESTRUCTOR:
         SolvationPotential(unsigned int _resol = 1);
+        SolvationPotential(const string& paramFile, unsigned int _resol = 1);
 
         virtual ~SolvationPotential() {
             PRINT_NAME;
@@ -85,6 +93,8 @@ namespace Victor { namespace Energy {
             return 0.582;
         }
 
+        friend class SolvationTask;
+
     protected:
 
     private:
@@ -94,13 +104,22 @@ namespace Victor { namespace Energy {
                 unsigned int count) const;
         long double pGetMaxPropensity(const AminoAcidCode type) const;
         long double pGetMinPropensity(const AminoAcidCode type) const;
+        long double pCalculateSolvation(AminoAcid& aa, Spacer& sp,
+                unsigned int start, unsigned int end, const ResidueGrid& g);
+        unsigned int pCountNeighbours(Atom& cb, unsigned int start,
+                unsigned int end, const ResidueGrid& g) const;
+        static void sBuildGrid(Spacer& sp, ResidueGrid& g);
 
         // MODIFIERS
+        void pSetCounts(AminoAcidCode code, unsigned int num,
+                const vector<int>& counts);
         void pConstructMaxPropensities();
         void pConstructMinPropensities();
 
         // ATTRIBUTES:
         vector<vector<int> > sum;
+        ResidueGrid grid; // CB atoms of the last chain
+        Mutex gridLock;
 
         unsigned int binResolution;
 
@@ -16,6 +16,7 @@
 
 // Includes:
 #include <PhiPsi.h>
+#include <SpacerDihedrals.h>
 
 using namespace Victor::Biopool;
 using namespace Victor::Energy;
@@ -61,25 +62,9 @@ void PhiPsi::pConstructData() {
     if (!input)
         ERROR("Could not read data file. " + inputFile, exception);
 
-    // Propensities tables construct
+    // Propensities table construct and filling
 
-    for (int i = 0; i < AminoAcid_CODE_SIZE; i++) {
-        vector<vector<int >* >* tmpB = new vector<vector<int >* >;
-        (*tmpB).reserve(SIZE_OF_TABLE);
-
-        for (int j = 0; j < SIZE_OF_TABLE; j++) {
-            vector<int >* tmpA = new vector<int >;
-            (*tmpA).reserve(SIZE_OF_TABLE);
-
-            for (int z = 0; z < SIZE_OF_TABLE; z++) {
-                (*tmpA).push_back(0);
-            }
-            (*tmpB).push_back(tmpA);
-        }
-        propensities.push_back(tmpB);
-    }
-
-    // Propensities table filling
+    propensities.assign(AminoAcid_CODE_SIZE * SIZE_OF_TABLE * SIZE_OF_TABLE, 1);
 
 
     long numCount;
@@ -89,11 +74,6 @@ void PhiPsi::pConstructData() {
     for (int i = 0; i < AminoAcid_CODE_SIZE; i++)
         amino_count[i] = 1;
 
-    for (int i = 0; i < AminoAcid_CODE_SIZE; i += 1)
-        for (int j = 0; j < SIZE_OF_TABLE; j++)
-            for (int k = 0; k < SIZE_OF_TABLE; k++)
-                (*(*propensities[i])[j])[k] = 1;
-
     input >> numCount;
 
     for (int i = 0; i < numCount; i++) {
@@ -105,35 +85,23 @@ void PhiPsi::pConstructData() {
 
     input.close();
 
-    // All propensities table construct
+    // All propensities table construct and filling
 
     total = 1;
-
-    for (int i = 0; i < SIZE_OF_TABLE; i++) {
-        vector<int>* tmp = new vector<int>;
-        (*tmp).reserve(SIZE_OF_TABLE);
-
-        for (int j = 0; j < SIZE_OF_TABLE; j++) {
-            (*tmp).push_back(0);
-        }
-        all_propensities.push_back(tmp);
-    }
-
-    for (int i = 0; i < SIZE_OF_TABLE; i++)
-        for (int j = 0; j < SIZE_OF_TABLE; j++)
-            (*all_propensities[i])[j] = 1;
-
-    //All propensities tables filling
+    const int cells = SIZE_OF_TABLE * SIZE_OF_TABLE;
+    all_propensities.assign(cells, 1);
 
     for (int i = 0; i < AminoAcid_CODE_SIZE; i++) {
         total += amino_count[i];
 
-        for (int j = 0; j < SIZE_OF_TABLE; j++)
-            for (int k = 0; k < SIZE_OF_TABLE; k++)
-                (*all_propensities[j])[k] += (*(*propensities[i])[j])[k];
+        for (int j = 0; j < cells; j++)
+            all_propensities[j] += propensities[i * cells + j];
     }
 
-    //Construct the max/min propensities vector
+    //Construct the energy tables and the max/min propensities vector
+    pConstructEnergyTable(propensities, all_propensities, amino_count, total,
+            energies);
+    pConstructSmoothEnergies();
     pConstructMaxPropensities();
     pConstructMinPropensities();
 
@@ -145,25 +113,13 @@ void PhiPsi::pConstructData() {
  * @return    changes the object internally (void)  
  */
 void PhiPsi::pResetData() {
-    //Reset data for propensieties and all propensities tables
-
-    for (unsigned int i = 0; i < propensities.size(); i++) {
-        for (unsigned int j = 0; j < (*propensities[i]).size(); j++) {
-            (*(*propensities[i])[j]).clear();
-            delete ((*propensities[i])[j]);
-        }
-        (*propensities[i]).clear();
-        delete (propensities[i]);
-    }
+    //Reset data for propensieties, all propensities and energy tables
     propensities.clear();
-
-
-    for (unsigned int i = 0; i < all_propensities.size(); i++) {
-        (*all_propensities[i]).clear();
-        delete (all_propensities[i]);
-    }
     all_propensities.clear();
-
+    energies.clear();
+    smooth_energies.clear();
+    amino_max_propensities.clear();
+    amino_min_propensities.clear();
 }
 
 
@@ -177,9 +133,12 @@ void PhiPsi::pResetData() {
  */
 long double PhiPsi::calculateEnergy(Spacer& sp) {
     long double en = 0.0;
+    const SpacerDihedrals& d = sp.getDihedrals();
 
     for (unsigned int i = 1; i < sp.sizeAmino() - 1; i++)
-        en += calculateEnergy(sp.getAmino(i));
+        en += pLookupEnergy(
+            aminoAcidThreeLetterTranslator(sp.getAmino(i).getType()),
+            d.getPhi(i), d.getPsi(i));
 
     return en;
 }
@@ -194,9 +153,12 @@ long double PhiPsi::calculateEnergy(Spacer& sp, unsigned int index1, unsigned in
 
     index1 = (index1 >= 1) ? index1 : 1;
     index2 = (index2 <= sp.sizeAmino() - 1) ? index2 : sp.sizeAmino() - 1;
+    const SpacerDihedrals& d = sp.getDihedrals();
 
     for (unsigned int i = index1; i < index2; i++)
-        en += calculateEnergy(sp.getAmino(i));
+        en += pLookupEnergy(
+            aminoAcidThreeLetterTranslator(sp.getAmino(i).getType()),
+            d.getPhi(i), d.getPsi(i));
 
     return en;
 }
@@ -207,26 +169,13 @@ long double PhiPsi::calculateEnergy(Spacer& sp, unsigned int index1, unsigned in
  * @return corresponding energy value(long double)
  */
 long double PhiPsi::calculateEnergy(AminoAcid& aa) {
-    // current amino acid type:
-    int table_entry = aminoAcidThreeLetterTranslator(aa.getType());
-
-    // offsets for the array
-    int x = sGetPropBin(aa.getPhi(true));
-    int y = sGetPropBin(aa.getPsi(true));
-
-    if ((x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE))
-        return 0;
-    else {
-
-        return -log((static_cast<double> ((*(*propensities[table_entry])[x])[y])
-                / (*all_propensities[x])[y])
-                / (static_cast<double> (amino_count[table_entry])
-                / total));
-    }
+    return pLookupEnergy(aminoAcidThreeLetterTranslator(aa.getType()),
+            aa.getPhi(true), aa.getPsi(true));
 }
 
 /** 
- *   calculates the total energy for the amino acid 
+ *   calculates the total energy for the amino acid, interpolated with the 
+ *   neighbouring bins 
  * @param the amino acid reference (AminoAcir&)
  * @return corresponding energy value(long double)
  */
@@ -235,82 +184,15 @@ long double PhiPsi::calculateEnergySmooth(AminoAcid& aa) {
     // current amino acid type:
     int table_entry = aminoAcidThreeLetterTranslator(aa.getType());
 
-    // offsets for the array
-    double diffX, diffY;
-    int x = sGetPropBinDiff(aa.getPhi(true), diffX);
-    int y = sGetPropBinDiff(aa.getPsi(true), diffY);
+    // offsets for the array, before the 180 degrees wrap (see sGetPropBinDiff)
+    int x = static_cast<int> (aa.getPhi(true) + 180) / ARC_STEP;
+    int y = static_cast<int> (aa.getPsi(true) + 180) / ARC_STEP;
 
-    if ((x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE))
+    if ((x < 0) || (y < 0) || (x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE))
         return 0;
 
-    long double en1 = -log((static_cast<double> (
-            (*(*propensities[table_entry])[x])[y])
-            / (*all_propensities[x])[y])
-            / (static_cast<double> (amino_count[table_entry])
-            / total));
-
-    long double enX = 0.0;
-    if (diffX >= 0)
-        enX = -log((static_cast<double> (
-            (*(*propensities[table_entry])[x + 1])[y])
-            / (*all_propensities[x + 1])[y])
-            / (static_cast<double> (amino_count[table_entry])
-            / total));
-    else
-        enX = -log((static_cast<double> (
-            (*(*propensities[table_entry])[x - 1])[y])
-            / (*all_propensities[x - 1])[y])
-            / (static_cast<double> (amino_count[table_entry])
-            / total));
-
-
-    long double enY = 0.0;
-    if (diffY >= 0)
-        enY = -log((static_cast<double> (
-            (*(*propensities[table_entry])[x])[y + 1])
-            / (*all_propensities[x])[y + 1])
-            / (static_cast<double> (amino_count[table_entry])
-            / total));
-    else
-        enY = -log((static_cast<double> (
-            (*(*propensities[table_entry])[x])[y - 1])
-            / (*all_propensities[x])[y - 1])
-            / (static_cast<double> (amino_count[table_entry])
-            / total));
-
-    long double enXY = 0.0;
-    if ((diffX >= 0) && (diffY >= 0))
-        enXY = -log((static_cast<double> (
-            (*(*propensities[table_entry])[x + 1])[y + 1])
-            / (*all_propensities[x + 1])[y + 1])
-            / (static_cast<double> (amino_count[table_entry])
-            / total));
-    else if ((diffX >= 0) && (diffY < 0))
-        enXY = -log((static_cast<double> (
-            (*(*propensities[table_entry])[x + 1])[y - 1])
-            / (*all_propensities[x + 1])[y - 1])
-            / (static_cast<double> (amino_count[table_entry])
-            / total));
-    else if ((diffX < 0) && (diffY >= 0))
-        enXY = -log((static_cast<double> (
-            (*(*propensities[table_entry])[x - 1])[y + 1])
-            / (*all_propensities[x - 1])[y + 1])
-            / (static_cast<double> (amino_count[table_entry])
-            / total));
-    else
-        enXY = -log((static_cast<double> (
-            (*(*propensities[table_entry])[x - 1])[y - 1])
-            / (*all_propensities[x - 1])[y - 1])
-            / (static_cast<double> (amino_count[table_entry])
-            / total));
-
-
-    double d = sqrt((diffX * diffX) + (diffY * diffY)) / 1.4;
-
-    return ( ((diffX * en1) + ((1 - diffX) * enX))
-            + ((diffY * en1) + ((1 - diffY) * enY))
-            + ((d * en1) + ((1 - d) * enXY))
-            / 3);
+    return smooth_energies[(table_entry * (SIZE_OF_TABLE + 1) + x)
+            * (SIZE_OF_TABLE + 1) + y];
 }
 
 /** 
@@ -329,15 +211,10 @@ long double PhiPsi::calculateEnergy(AminoAcid& aa, double phi, double psi) {
         int x = sGetPropBin(phi);
         int y = sGetPropBin(psi);
 
-        if ((x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE))
+        if ((x < 0) || (y < 0) || (x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE))
             return 0;
-        else {
-
-            return -log((static_cast<double> ((*(*propensities[table_entry])[x])[y])
-                    / (*all_propensities[x])[y])
-                    / (static_cast<double> (amino_count[table_entry])
-                    / total));
-        }
+        else
+            return energies[pGetIndex(table_entry, x, y)];
     }
     return 0;
 }
@@ -356,14 +233,10 @@ long double PhiPsi::calculateEnergy(AminoAcid& diheds, AminoAcidCode code) {
     int x = sGetPropBin(diheds.getPhi(true));
     int y = sGetPropBin(diheds.getPsi(true));
 
-    if ((x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE)) // why?
+    if ((x < 0) || (y < 0) || (x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE)) // why?
         return 0;
-    else {
-        return -log((static_cast<double> ((*(*propensities[table_entry])[x])[y])
-                / (*all_propensities[x])[y])
-                / (static_cast<double> (amino_count[table_entry])
-                / total));
-    }
+    else
+        return energies[pGetIndex(table_entry, x, y)];
 }
 
 /**
@@ -398,10 +271,26 @@ inline int PhiPsi::sGetPropBinDiff(double p, double& diff) {
  * @return    changes the object internally (void)  
  */
 inline void PhiPsi::sAddProp(int code, int x, int y) {
-    (*(*propensities[code])[x])[y]++;
+    propensities[pGetIndex(code, x, y)]++;
     amino_count[code]++;
 }
 
+/**
+ *   Looks up the energy of an amino acid type for a pair of angles.
+ * @param   amino acid type (int), phi and psi angles in degrees (double, double)
+ * @return  corresponding energy value, 0 outside of the table (long double)
+ */
+long double PhiPsi::pLookupEnergy(int code, double phi, double psi) {
+    // offsets for the array
+    int x = sGetPropBin(phi);
+    int y = sGetPropBin(psi);
+
+    if ((x < 0) || (y < 0) || (x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE))
+        return 0;
+    else
+        return energies[pGetIndex(code, x, y)];
+}
+
 /**
  *   Sets the step for the arc  
  * @param   the step value(int)
@@ -424,8 +313,8 @@ double PhiPsi::pGetMaxPropensities(int amino) {
 
     for (int j = 0; j < SIZE_OF_TABLE; j++) {
         for (int k = 0; k < SIZE_OF_TABLE; k++) {
-            int tmp = (*all_propensities[j])[k];
-            int tmp2 = (*(*propensities[amino])[j])[k];
+            int tmp = all_propensities[j * SIZE_OF_TABLE + k];
+            int tmp2 = propensities[pGetIndex(amino, j, k)];
             double propensities = ((static_cast<double> (tmp2) / tmp)
                     / ((static_cast<double> (amino_count[amino])) / total));
             if (propensities > max) {
@@ -446,8 +335,8 @@ double PhiPsi::pGetMinPropensities(int amino) {
 
     for (int j = 0; j < SIZE_OF_TABLE; j++) {
         for (int k = 0; k < SIZE_OF_TABLE; k++) {
-            int tmp = (*all_propensities[j])[k];
-            int tmp2 = (*(*propensities[amino])[j])[k];
+            int tmp = all_propensities[j * SIZE_OF_TABLE + k];
+            int tmp2 = propensities[pGetIndex(amino, j, k)];
             double propensities = ((static_cast<double> (tmp2) / tmp)
                     / ((static_cast<double> (amino_count[amino])) / total));
             if (propensities < min) {
@@ -504,6 +393,47 @@ void PhiPsi::pConstructMinPropensities() {
     }
 }
 
+/**
+ *   fill the table of interpolated energies. The interpolation weights of 
+ *   sGetPropBinDiff() only depend on the bins, so every (phi, psi) bin pair,
+ *   including the ones of angles of exactly 180 degrees, gets one entry. 
+ * @param   none
+ * @return    changes the object internally (void)  
+ */
+void PhiPsi::pConstructSmoothEnergies() {
+    const int rows = SIZE_OF_TABLE + 1;
+    smooth_energies.assign(AminoAcid_CODE_SIZE * rows * rows, 0.0);
+
+    for (int i = 0; i < AminoAcid_CODE_SIZE; i++)
+        for (int binX = 0; binX < rows; binX++)
+            for (int binY = 0; binY < rows; binY++) {
+                int x = (binX == SIZE_OF_TABLE) ? binX - 1 : binX;
+                int y = (binY == SIZE_OF_TABLE) ? binY - 1 : binY;
+                double diffX = 1 - (binX / 2);
+                double diffY = 1 - (binY / 2);
+
+                int nextX = (diffX >= 0) ? x + 1 : x - 1;
+                int nextY = (diffY >= 0) ? y + 1 : y - 1;
+                if ((nextX < 0) || (nextX >= SIZE_OF_TABLE))
+                    nextX = x;
+                if ((nextY < 0) || (nextY >= SIZE_OF_TABLE))
+                    nextY = y;
+
+                long double en1 = energies[pGetIndex(i, x, y)];
+                long double enX = energies[pGetIndex(i, nextX, y)];
+                long double enY = energies[pGetIndex(i, x, nextY)];
+                long double enXY = energies[pGetIndex(i, nextX, nextY)];
+
+                double d = sqrt((diffX * diffX) + (diffY * diffY)) / 1.4;
+
+                smooth_energies[(i * rows + binX) * rows + binY] =
+                        ( ((diffX * en1) + ((1 - diffX) * enX))
+                        + ((diffY * en1) + ((1 - diffY) * enY))
+                        + ((d * en1) + ((1 - d) * enXY))
+                        / 3);
+            }
+}
+
 /**
  *   calculates the energy from the PhiPsi angles of an amino acid 
  * @param   code of the amino acid(AminoAcidCode), values for phi and psi(double,double)
@@ -516,12 +446,8 @@ double PhiPsi::getEnergyFromPhiPsi(AminoAcidCode code, double phi, double psi) {
     int x = sGetPropBin(phi);
     int y = sGetPropBin(psi);
 
-    if ((x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE)) // why?
+    if ((x < 0) || (y < 0) || (x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE)) // why?
         return 0;
-    else {
-        return -log((static_cast<double> ((*(*propensities[table_entry])[x])[y])
-                / (*all_propensities[x])[y])
-                / (static_cast<double> (amino_count[table_entry])
-                / total));
-    }
+    else
+        return energies[pGetIndex(table_entry, x, y)];
 }
@@ -36,7 +36,10 @@ using namespace Victor;
      * 
      *   Includes methods that allow to obtain information about the angle and the energy. This class implements a simple torsion potential based on the 
      *    statistical preference of aminoacid types for phi and psi angles.
-
+     *
+     *   The energies (plain and smoothed) are tabulated per amino acid and 
+     *   bin when the knowledge is loaded, so that lookups do not change the 
+     *   object and one instance can be shared by several threads.
      * */
     class PhiPsi : public TorsionPotential {
     public:
@@ -89,6 +92,9 @@ using namespace Victor;
         virtual double pGetMinPropensities(int amino);
         int sGetPropBin(double p);
         void sAddProp(int code, int x, int y);
+        int pGetIndex(int code, int x, int y) const;
+        long double pLookupEnergy(int code, double phi, double psi);
+        void pConstructSmoothEnergies();
         virtual void pConstructMaxPropensities();
         virtual void pConstructMinPropensities();
 
@@ -99,8 +105,10 @@ using namespace Victor;
         int ARC_STEP; // important: must be a divisior of 360 !!!! 
         int SIZE_OF_TABLE; // "granularity" props.
         int amino_count[AminoAcid_CODE_SIZE]; //number of amino.
-        vector<vector<vector<int>* >* > propensities; // the propensities table.
-        vector<vector<int>* > all_propensities; // the sum of propropensities table.
+        vector<int> propensities; // the propensities table, [aa][phi][psi].
+        vector<int> all_propensities; // the sum of propropensities table, [phi][psi].
+        vector<double> energies; // -log of the propensities, [aa][phi][psi].
+        vector<double> smooth_energies; // the interpolated energies, [aa][phi][psi].
         double total; //total numer of ammino considered.
         vector<double> amino_max_propensities; //vector with max amino propensities
         // according to knowledge.
@@ -113,6 +121,16 @@ using namespace Victor;
 
     // ---------------------------------------------------------------------------
     //                            PhiPsi
+    // -----------------x-------------------x-------------------x-----------------
+
+    /**
+     *    Position of a bin in the flat tables
+     * @param   amino acid code (int), phi and psi bins (int, int)
+     * @return  index into propensities, energies and smooth_energies (int)
+     */
+    inline int PhiPsi::pGetIndex(int code, int x, int y) const {
+        return (code * SIZE_OF_TABLE + x) * SIZE_OF_TABLE + y;
+    }
 
 }} // namespace
 #endif// _PHIPSI_H_
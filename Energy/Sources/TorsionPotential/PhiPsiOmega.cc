@@ -16,6 +16,7 @@
 
 // Includes:
 #include <PhiPsiOmega.h>
+#include <SpacerDihedrals.h>
 #include <float.h>
 
 using namespace Victor;
@@ -72,31 +73,10 @@ void PhiPsiOmega::pConstructData() {
     if (!input)
         ERROR("Could not read data file. " + inputFile, exception);
 
-    // Propensities tables construct 
+    // Propensities table construct and filling
 
-    for (int i = 0; i < AminoAcid_CODE_SIZE; i++) {
-        vector<vector<vector<int>* >* >* tmpC = new vector<vector<vector<int>* >* >;
-        (*tmpC).reserve(SIZE_OF_TABLE);
-
-        for (int j = 0; j < SIZE_OF_TABLE; j++) {
-            vector<vector<int>* >* tmpB = new vector<vector<int>* >;
-            (*tmpB).reserve(SIZE_OF_TABLE);
-
-            for (int k = 0; k < SIZE_OF_TABLE; k++) {
-                vector<int>* tmpA = new vector<int>;
-                (*tmpA).reserve(RANGE_OMEGA);
-
-                for (int x = 0; x < RANGE_OMEGA; x++) {
-                    (*tmpA).push_back(0);
-                }
-                (*tmpB).push_back(tmpA);
-            }
-            (*tmpC).push_back(tmpB);
-        }
-        (propensities).push_back(tmpC);
-    }
-
-    // Propensities table filling
+    propensities.assign(AminoAcid_CODE_SIZE * SIZE_OF_TABLE * SIZE_OF_TABLE
+            * RANGE_OMEGA, 1);
 
     long numCount;
     double phi, psi, omega;
@@ -105,12 +85,6 @@ void PhiPsiOmega::pConstructData() {
     for (int i = 0; i < AminoAcid_CODE_SIZE; i++)
         amino_count[i] = 1;
 
-    for (int i = 0; i < AminoAcid_CODE_SIZE; i += 1)
-        for (int j = 0; j < SIZE_OF_TABLE; j++)
-            for (int k = 0; k < SIZE_OF_TABLE; k++)
-                for (int l = 0; l < RANGE_OMEGA; l++)
-                    (*(*(*propensities[i])[j])[k])[l] = 1;
-
     input >> numCount;
 
     for (int i = 0; i < numCount; i++) {
@@ -123,41 +97,23 @@ void PhiPsiOmega::pConstructData() {
 
     input.close();
 
-    // All propensities table construct
+    // All propensities table construct and filling
 
     total = 1;
-
-    for (int i = 0; i < SIZE_OF_TABLE; i++) {
-        vector<vector<int>* >* tmpE = new vector<vector<int>* >;
-        (*tmpE).reserve(SIZE_OF_TABLE);
-
-        for (int j = 0; j < SIZE_OF_TABLE; j++) {
-            vector<int>* tmpD = new vector<int>;
-            (*tmpD).reserve(RANGE_OMEGA);
-
-            for (int k = 0; k < RANGE_OMEGA; k++) {
-                (*tmpD).push_back(0);
-            }
-            (*tmpE).push_back(tmpD);
-        }
-        all_propensities.push_back(tmpE);
-    }
-
-
-    for (int j = 0; j < SIZE_OF_TABLE; j++)
-        for (int k = 0; k < SIZE_OF_TABLE; k++)
-            for (int l = 0; l < RANGE_OMEGA; l++)
-                (*(*all_propensities[j])[k])[l] = 1;
+    const int cells = SIZE_OF_TABLE * SIZE_OF_TABLE * RANGE_OMEGA;
+    all_propensities.assign(cells, 1);
 
     for (int i = 0; i < AminoAcid_CODE_SIZE; i++) {
         total += amino_count[i];
 
-        for (int j = 0; j < SIZE_OF_TABLE; j++)
-            for (int k = 0; k < SIZE_OF_TABLE; k++)
-                for (int l = 0; l < RANGE_OMEGA; l++)
-                    (*(*all_propensities[j])[k])[l] += (*(*(*propensities[i])[j])[k])[l];
+        for (int j = 0; j < cells; j++)
+            all_propensities[j] += propensities[i * cells + j];
     }
 
+    //Construct the energy table
+    pConstructEnergyTable(propensities, all_propensities, amino_count, total,
+            energies);
+
     //Construct the max and min propensity vectors
     pConstructMaxPropensities();
     pConstructMinPropensities();
@@ -170,30 +126,11 @@ void PhiPsiOmega::pConstructData() {
  * @return changes are made internally(void)
  */
 void PhiPsiOmega::pResetData() {
-    for (unsigned int i = 0; i < propensities.size(); i++) {
-        for (unsigned int j = 0; j < (*propensities[i]).size(); j++) {
-            for (unsigned int k = 0; k < (*(*propensities[i])[j]).size(); k++) {
-                (*(*(*propensities[i])[j])[k]).clear();
-                delete ((*(*propensities[i])[j])[k]);
-            }
-            (*(*propensities[i])[j]).clear();
-            delete ((*propensities[i])[j]);
-        }
-        (*propensities[i]).clear();
-        delete (propensities[i]);
-    }
     propensities.clear();
-
-    for (unsigned int i = 0; i < all_propensities.size(); i++) {
-        for (unsigned int j = 0; j < (*all_propensities[i]).size(); j++) {
-            (*(*all_propensities[i])[j]).clear();
-            delete (*all_propensities[i])[j];
-        }
-        (*all_propensities[i]).clear();
-        delete all_propensities[i];
-    }
     all_propensities.clear();
-
+    energies.clear();
+    amino_max_propensities.clear();
+    amino_min_propensities.clear();
 }
 
 
@@ -206,10 +143,12 @@ void PhiPsiOmega::pResetData() {
  */
 long double PhiPsiOmega::calculateEnergy(Spacer& sp) {
     long double en = 0.0;
+    const SpacerDihedrals& d = sp.getDihedrals();
 
     for (unsigned int i = 1; i < sp.sizeAmino() - 1; i++)
-        en += calculateEnergy(sp.getAmino(i));
-
+        en += pLookupEnergy(
+            aminoAcidThreeLetterTranslator(sp.getAmino(i).getType()),
+            d.getPhi(i), d.getPsi(i), d.getOmega(i));
 
     return en;
 }
@@ -225,9 +164,12 @@ long double PhiPsiOmega::calculateEnergy(Spacer& sp, unsigned int index1,
 
     index1 = (index1 >= 1) ? index1 : 1;
     index2 = (index2 <= sp.sizeAmino() - 1) ? index2 : sp.sizeAmino() - 1;
+    const SpacerDihedrals& d = sp.getDihedrals();
 
     for (unsigned int i = index1; i < index2; i++)
-        en += calculateEnergy(sp.getAmino(i));
+        en += pLookupEnergy(
+            aminoAcidThreeLetterTranslator(sp.getAmino(i).getType()),
+            d.getPhi(i), d.getPsi(i), d.getOmega(i));
 
     return en;
 }
@@ -238,23 +180,8 @@ long double PhiPsiOmega::calculateEnergy(Spacer& sp, unsigned int index1,
  * @return energy value for given amino acid  (long double)
  */
 long double PhiPsiOmega::calculateEnergy(AminoAcid& aa) {
-    // current amino acid type:
-    int table_entry = aminoAcidThreeLetterTranslator(aa.getType());
-
-    // offsets for the array
-    int x = sGetPropBin(aa.getPhi(true));
-    int y = sGetPropBin(aa.getPsi(true));
-    int z = sGetPropOmegaBin(aa.getOmega(true));
-
-    if ((x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE) || (z > RANGE_OMEGA))
-        return 0;
-    else {
-
-        return -log((static_cast<double> ((*(*(*propensities[table_entry])[x])[y])[z])
-                / (*(*all_propensities[x])[y])[z])
-                / (static_cast<double> (amino_count[table_entry])
-                / total));
-    }
+    return pLookupEnergy(aminoAcidThreeLetterTranslator(aa.getType()),
+            aa.getPhi(true), aa.getPsi(true), aa.getOmega(true));
 }
 
 /**
@@ -273,13 +200,7 @@ long double PhiPsiOmega::calculateEnergy(AminoAcid& diheds, AminoAcidCode code)
     int y = sGetPropBin(diheds.getPsi(true));
     int z = sGetPropOmegaBin(diheds.getOmega(true));
 
-    const int amiProp = (*(*(*propensities[table_entry])[x])[y])[z];
-    const int allProp = (*(*all_propensities[x])[y])[z];
-
-    const double propFrac = static_cast<double> (amiProp) / allProp;
-    const double countFrac = static_cast<double> (amino_count[table_entry]) / total;
-
-    return -log(propFrac / countFrac);
+    return energies[pGetIndex(table_entry, x, y, z)];
 }
 
 /**
@@ -388,10 +309,29 @@ inline int PhiPsiOmega::sGetPropOmegaBin(double p) {
  * @return changes are made internally(void)
  */
 inline void PhiPsiOmega::sAddProp(int code, int x, int y, int z) {
-    (*(*(*propensities[code])[x])[y])[z]++;
+    propensities[pGetIndex(code, x, y, z)]++;
     amino_count[code]++;
 }
 
+/**
+ *   Looks up the energy of an amino acid type for a triple of angles.
+ * @param amino acid type (int), phi, psi and omega angles in degrees (double, double, double)
+ * @return corresponding energy value, 0 outside of the table (long double)
+ */
+long double PhiPsiOmega::pLookupEnergy(int code, double phi, double psi,
+        double omega) {
+    // offsets for the array
+    int x = sGetPropBin(phi);
+    int y = sGetPropBin(psi);
+    int z = sGetPropOmegaBin(omega);
+
+    if ((x < 0) || (y < 0) || (z < 0)
+            || (x > SIZE_OF_TABLE) || (y > SIZE_OF_TABLE) || (z > RANGE_OMEGA))
+        return 0;
+    else
+        return energies[pGetIndex(code, x, y, z)];
+}
+
 /**
  *  
  * @param
@@ -446,8 +386,8 @@ double PhiPsiOmega::pGetMaxPropensities(int amino) {
     for (int j = 0; j < SIZE_OF_TABLE; j++) {
         for (int k = 0; k < SIZE_OF_TABLE; k++) {
             for (int x = 0; x < RANGE_OMEGA; x++) {
-                int tmp = (*(*all_propensities[j])[k])[x];
-                int tmp2 = (*(*(*propensities[amino])[j])[k])[x];
+                int tmp = all_propensities[pGetIndex(0, j, k, x)];
+                int tmp2 = propensities[pGetIndex(amino, j, k, x)];
                 double propensities = ((static_cast<double> (tmp2) / tmp)
                         / ((static_cast<double> (amino_count[amino])) / total));
                 if (propensities > max) {
@@ -495,8 +435,8 @@ double PhiPsiOmega::pGetMinPropensities(int amino) {
     for (int j = 0; j < SIZE_OF_TABLE; j++)
         for (int k = 0; k < SIZE_OF_TABLE; k++)
             for (int x = 0; x < RANGE_OMEGA; x++) {
-                const int amiProp = (*(*(*propensities[amino])[j])[k])[x];
-                const int allProp = (*(*all_propensities[j])[k])[x];
+                const int amiProp = propensities[pGetIndex(amino, j, k, x)];
+                const int allProp = all_propensities[pGetIndex(0, j, k, x)];
 
                 const double propFrac = static_cast<double> (amiProp) / allProp;
 
@@ -571,15 +511,14 @@ vector< vector<Potential::ANGLES> >* PhiPsiOmega::getOrderedEnergyTable() {
     vector< vector<ANGLES> > *arr = new vector< vector<ANGLES> >;
 
     for (int aa = 0; aa < AminoAcid_CODE_SIZE; ++aa) {
-        // get the propensities for each amino acid:
-        vector< vector< vector<int>* >* >* data = propensities[aa];
         vector<ANGLES> elem;
         for (int x = 0; x < SIZE_OF_TABLE; ++x)
             for (int y = 0; y < SIZE_OF_TABLE; ++y)
                 for (int z = 0; z < RANGE_OMEGA; ++z) {
                     ANGLES tmp = {getPhiPsiAngle(x, SIZE_OF_TABLE, ARC_STEP),
                         getPhiPsiAngle(y, SIZE_OF_TABLE, ARC_STEP),
-                        getOmegaAngle(z, RANGE_OMEGA), (*(*(*data)[x])[y])[z]};
+                        getOmegaAngle(z, RANGE_OMEGA),
+                        propensities[pGetIndex(aa, x, y, z)]};
                     elem.push_back(tmp);
                 }
         // Let's sort the array
@@ -35,6 +35,8 @@ namespace Victor { namespace Energy {
     /** @brief class manages the angle qualities and the energy 
      * 
      *    This class implements a simple torsion potential based on the statistical preference of aminoacid types phi , psi and omega angles.
+     *    The energies are tabulated per amino acid and bin when the knowledge
+     *    is loaded, lookups only read them.
      * */
     class PhiPsiOmega : public TorsionPotential {
     public:
@@ -92,6 +94,9 @@ namespace Victor { namespace Energy {
             ERROR("ERROR. NOT IMPLEMENTED FOR THIS CLASS.", exception)
         }
         void sAddProp(int code, int x, int y, int z);
+        int pGetIndex(int code, int x, int y, int z) const;
+        long double pLookupEnergy(int code, double phi, double psi,
+                double omega);
         int sGetPropOmegaBin(double p);
         int sGetPropBin(double p);
         virtual void pConstructMaxPropensities();
@@ -109,16 +114,26 @@ namespace Victor { namespace Energy {
         int SIZE_OF_TABLE; // "granularity" props
         int RANGE_OMEGA;
         int amino_count[AminoAcid_CODE_SIZE]; //number of amino. 
-        vector<vector<vector<vector<int>* >* >* > propensities; // the propensities table.
-        vector<vector<vector<int>* >* > all_propensities; // the sum of propropensities table.
+        vector<int> propensities; // the propensities table, [aa][phi][psi][omega].
+        vector<int> all_propensities; // the sum of propropensities table, [phi][psi][omega].
+        vector<double> energies; // -log of the propensities, [aa][phi][psi][omega].
         double total; //total numer of ammino considered.
         vector<double> amino_max_propensities; // vectors with max and min amino propensities
         vector<double> amino_min_propensities; // according to knowledge. 
     };
 
     // ---------------------------------------------------------------------------
-    //                            TorsionPotential
+    //                            PhiPsiOmega
     // -----------------x-------------------x-------------------x-----------------
+
+    /**
+     *    Position of a bin in the flat tables
+     * @param   amino acid code (int), phi, psi and omega bins (int, int, int)
+     * @return  index into propensities and energies (int)
+     */
+    inline int PhiPsiOmega::pGetIndex(int code, int x, int y, int z) const {
+        return ((code * SIZE_OF_TABLE + x) * SIZE_OF_TABLE + y) * RANGE_OMEGA + z;
+    }
 }} // namespace
 #endif// _FULLTORSIONPOTENTIAL_H_
 
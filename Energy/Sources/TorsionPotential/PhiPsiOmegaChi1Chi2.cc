@@ -61,42 +61,8 @@ void PhiPsiOmegaChi1Chi2::pConstructData() {
 
     if (!input)
         ERROR("Could not read data file. " + inputFile, exception);
-    for (int i = 0; i < AminoAcid_CODE_SIZE; i++) {
-        vector<vector<vector<vector<vector<int>* >* >* >* >* tmpC =
-                new vector<vector<vector<vector<vector<int>* >* >* >* >;
-        (*tmpC).reserve(SIZE_OF_TABLE);
-
-        for (int j = 0; j < SIZE_OF_TABLE; j++) {
-            vector<vector<vector<vector<int>* >* >* >* tmpB =
-                    new vector<vector<vector<vector<int>* >* >* >;
-            (*tmpB).reserve(SIZE_OF_TABLE);
-
-            for (int z = 0; z < SIZE_OF_TABLE; z++) {
-                vector<vector<vector<int>* >* >* tmpA =
-                        new vector<vector<vector<int>* >* >;
-                (*tmpA).reserve(CHI_RANGE);
-
-                for (int x = 0; x < CHI_RANGE; x++) {
-                    vector<vector<int>* >* tmpAA =
-                            new vector<vector<int>* >;
-                    (*tmpAA).reserve(CHI_RANGE);
-                    for (int y = 0; y < CHI_RANGE; y++) {
-                        vector<int>* tmpZ = new vector<int>;
-                        (*tmpZ).reserve(RANGE_OMEGA);
-
-                        for (int n = 0; n < RANGE_OMEGA; n++) {
-                            (*tmpZ).push_back(0);
-                        }
-                        (*tmpAA).push_back(tmpZ);
-                    }
-                    (*tmpA).push_back(tmpAA);
-                }
-                (*tmpB).push_back(tmpA);
-            }
-            (*tmpC).push_back(tmpB);
-        }
-        (propensities).push_back(tmpC);
-    }
+    propensities.assign(AminoAcid_CODE_SIZE * SIZE_OF_TABLE * SIZE_OF_TABLE
+            * CHI_RANGE * CHI_RANGE * RANGE_OMEGA, 1);
 
     long numCount;
     double phi, psi, chi1, chi2, omega, numchi;
@@ -105,14 +71,6 @@ void PhiPsiOmegaChi1Chi2::pConstructData() {
     for (int i = 0; i < AminoAcid_CODE_SIZE; i++)
         amino_count[i] = 1;
 
-    for (int i = 0; i < AminoAcid_CODE_SIZE; i += 1)
-        for (int j = 0; j < SIZE_OF_TABLE; j++)
-            for (int k = 0; k < SIZE_OF_TABLE; k++)
-                for (int l = 0; l < CHI_RANGE; l++)
-                    for (int n = 0; n < CHI_RANGE; n++)
-                        for (int m = 0; m < RANGE_OMEGA; m++)
-                            (*(*(*(*(*propensities[i])[j])[k])[l])[n])[m] = 1;
-
     input >> numCount;
     for (int i = 0; i < numCount; i++) {
         input >> phi >> psi >> name >> vartmp1 >> vartmp2 >> omega >> numchi;
@@ -139,56 +97,21 @@ void PhiPsiOmegaChi1Chi2::pConstructData() {
     // calculate some constant values:
 
     total = 1;
-    for (int i = 0; i < SIZE_OF_TABLE; i++) {
-        vector<vector<vector<vector<int>* >* >* >* tmpE =
-                new vector<vector<vector<vector<int>* >* >* >;
-        (*tmpE).reserve(SIZE_OF_TABLE);
-
-        for (int i = 0; i < SIZE_OF_TABLE; i++) {
-            vector<vector<vector<int>* >* >* tmpD =
-                    new vector<vector<vector<int>* >* >;
-            (*tmpD).reserve(CHI_RANGE);
-
-            for (int i = 0; i < CHI_RANGE; i++) {
-                vector<vector<int>* >* tmpDD =
-                        new vector<vector<int>* >;
-                (*tmpDD).reserve(CHI_RANGE);
-
-                for (int i = 0; i < CHI_RANGE; i++) {
-                    vector<int>* tmpY = new vector<int>;
-                    (*tmpY).reserve(RANGE_OMEGA);
-
-                    for (int i = 0; i < RANGE_OMEGA; i++) {
-                        (*tmpY).push_back(0);
-                    }
-                    (*tmpDD).push_back(tmpY);
-                }
-
-                (*tmpD).push_back(tmpDD);
-            }
-            (*tmpE).push_back(tmpD);
-        }
-        all_propensities.push_back(tmpE);
-    }
-
-    for (int j = 0; j < SIZE_OF_TABLE; j++)
-        for (int k = 0; k < SIZE_OF_TABLE; k++)
-            for (int l = 0; l < CHI_RANGE; l++)
-                for (int n = 0; n < CHI_RANGE; n++)
-                    for (int m = 0; m < RANGE_OMEGA; m++)
-                        (*(*(*(*all_propensities[j])[k])[l])[n])[m] = 1;
+    const int cells = SIZE_OF_TABLE * SIZE_OF_TABLE * CHI_RANGE * CHI_RANGE
+            * RANGE_OMEGA;
+    all_propensities.assign(cells, 1);
 
     for (int i = 0; i < AminoAcid_CODE_SIZE; i++) {
         total += amino_count[i];
 
-        for (int j = 0; j < SIZE_OF_TABLE; j++)
-            for (int k = 0; k < SIZE_OF_TABLE; k++)
-                for (int l = 0; l < CHI_RANGE; l++)
-                    for (int n = 0; n < CHI_RANGE; n++)
-                        for (int m = 0; m < RANGE_OMEGA; m++)
-                            (*(*(*(*all_propensities[j])[k])[l])[n])[m] +=
-                                (*(*(*(*(*propensities[i])[j])[k])[l])[n])[m];
+        for (int j = 0; j < cells; j++)
+            all_propensities[j] += propensities[i * cells + j];
     }
+
+    //Construct the energy table
+    pConstructEnergyTable(propensities, all_propensities, amino_count, total,
+            energies);
+
     //Construct the max propensities vector
     pConstructMaxPropensities();
     pConstructMinPropensities();
@@ -200,49 +123,11 @@ void PhiPsiOmegaChi1Chi2::pConstructData() {
  * @return    changes the object internally (void)  
  */
 void PhiPsiOmegaChi1Chi2::pResetData() {
-
-    for (unsigned int i = 0; i < propensities.size(); i++) {
-        for (unsigned int j = 0; j < (*propensities[i]).size(); j++) {
-            for (unsigned int k = 0; k < (*(*propensities[i])[j]).size(); k++) {
-                for (unsigned int l = 0; l < (*(*(*propensities[i])[j])[k]).size(); l++) {
-                    for (unsigned int n = 0; n < (*(*(*(*propensities[i])[j])[k])[l]).size(); n++) {
-                        (*(*(*(*(*propensities[i])[j])[k])[l])[n]).clear();
-                        delete ((*(*(*(*propensities[i])[j])[k])[l])[n]);
-                    }
-                    (*(*(*(*propensities[i])[j])[k])[l]).clear();
-                    delete ((*(*(*propensities[i])[j])[k])[l]);
-                }
-                (*(*(*propensities[i])[j])[k]).clear();
-                delete ((*(*propensities[i])[j])[k]);
-
-            }
-            (*(*propensities[i])[j]).clear();
-            delete ((*propensities[i])[j]);
-        }
-        (*propensities[i]).clear();
-        delete (propensities[i]);
-    }
     propensities.clear();
-
-    for (unsigned int i = 0; i < all_propensities.size(); i++) {
-        for (unsigned int j = 0; j < (*all_propensities[i]).size(); j++) {
-            for (unsigned int k = 0; k < (*(*all_propensities[i])[j]).size(); k++) {
-                for (unsigned int l = 0; l < (*(*(*all_propensities[i])[j])[k]).size(); l++) {
-                    (*(*(*(*all_propensities[i])[j])[k])[l]).clear();
-                    delete ((*(*(*all_propensities[i])[j])[k])[l]);
-                }
-                (*(*(*all_propensities[i])[j])[k]).clear();
-                delete ((*(*all_propensities[i])[j])[k]);
-            }
-
-            (*(*all_propensities[i])[j]).clear();
-            delete ((*all_propensities[i])[j]);
-
-        }
-        (*all_propensities[i]).clear();
-        delete (all_propensities[i]);
-    }
     all_propensities.clear();
+    energies.clear();
+    amino_max_propensities.clear();
+    amino_min_propensities.clear();
 }
 
 // PREDICATES:
@@ -293,8 +178,7 @@ long double PhiPsiOmegaChi1Chi2::calculateEnergy(AminoAcid& aa) {
         int n = sGetPropChiBin(0.0);
         int o = sGetPropOmegaBin(aa.getOmega(true));
 
-        return -log((static_cast<double> ((*(*(*(*(*propensities[table_entry])[x])[y])[z])[n])[o])
-                / (*(*(*(*all_propensities[x])[y])[z])[n])[o]) / (static_cast<double> (amino_count[table_entry]) / total));
+        return energies[pGetIndex(table_entry, x, y, z, n, o)];
     } else if (a == 1) {
         int x = sGetPropBin(aa.getPhi(true));
         int y = sGetPropBin(aa.getPsi(true));
@@ -302,9 +186,7 @@ long double PhiPsiOmegaChi1Chi2::calculateEnergy(AminoAcid& aa) {
         int n = sGetPropChiBin(0.0);
         int o = sGetPropOmegaBin(aa.getOmega(true));
 
-        return -log((static_cast<double> ((*(*(*(*(*propensities[table_entry])[x])[y])[z])[n])[o])
-                / (*(*(*(*all_propensities[x])[y])[z])[n])[o]) / (static_cast<double>
-                (amino_count[table_entry]) / total));
+        return energies[pGetIndex(table_entry, x, y, z, n, o)];
     } else if (a >= 2) {
         int x = sGetPropBin(aa.getPhi(true));
         int y = sGetPropBin(aa.getPsi(true));
@@ -312,9 +194,7 @@ long double PhiPsiOmegaChi1Chi2::calculateEnergy(AminoAcid& aa) {
         int n = sGetPropChiBin(aa.getChi(1));
         int o = sGetPropOmegaBin(aa.getOmega(true));
 
-        return -log((static_cast<double> ((*(*(*(*(*propensities[table_entry])[x])[y])[z])[n])[o])
-                / (*(*(*(*all_propensities[x])[y])[z])[n])[o]) / (static_cast<double>
-                (amino_count[table_entry]) / total));
+        return energies[pGetIndex(table_entry, x, y, z, n, o)];
     }
     if (a < 0)
         ERROR("Chi Propension ERROR. Check Chi angles.", exception);
@@ -358,7 +238,7 @@ inline int PhiPsiOmegaChi1Chi2::sGetPropChiBin(double p) {
  * @return    changes the object internally (void)  
  */
 inline void PhiPsiOmegaChi1Chi2::sAddProp(int code, int x, int y, int z, int m, int n) {
-    (*(*(*(*(*propensities[code])[x])[y])[z])[m])[n]++;
+    propensities[pGetIndex(code, x, y, z, m, n)]++;
     amino_count[code]++;
 }
 
@@ -518,8 +398,8 @@ double PhiPsiOmegaChi1Chi2::pGetMaxPropensities(int amino) {
             for (int l = 0; l < CHI_RANGE; l++) {
                 for (int m = 0; m < CHI_RANGE; m++) {
                     for (int x = 0; x < RANGE_OMEGA; x++) {
-                        int tmp = (*(*(*(*all_propensities[j])[k])[l])[m])[x];
-                        int tmp2 = (*(*(*(*(*propensities[amino])[j])[k])[l])[m])[x];
+                        int tmp = all_propensities[pGetIndex(0, j, k, l, m, x)];
+                        int tmp2 = propensities[pGetIndex(amino, j, k, l, m, x)];
                         double propensities = ((static_cast<double> (tmp2) / tmp)
                                 / ((static_cast<double> (amino_count[amino])) / total));
                         if (propensities > max) {
@@ -546,8 +426,8 @@ double PhiPsiOmegaChi1Chi2::pGetMinPropensities(int amino) {
             for (int l = 0; l < CHI_RANGE; l++) {
                 for (int m = 0; m < CHI_RANGE; m++) {
                     for (int x = 0; x < RANGE_OMEGA; x++) {
-                        int tmp = (*(*(*(*all_propensities[j])[k])[l])[m])[x];
-                        int tmp2 = (*(*(*(*(*propensities[amino])[j])[k])[l])[m])[x];
+                        int tmp = all_propensities[pGetIndex(0, j, k, l, m, x)];
+                        int tmp2 = propensities[pGetIndex(amino, j, k, l, m, x)];
                         double propensities = ((static_cast<double> (tmp2) / tmp)
                                 / ((static_cast<double> (amino_count[amino])) / total));
                         if (propensities < min) {
@@ -37,6 +37,8 @@ namespace Victor { namespace Energy {
      *   This class implements a simple torsion potential based on the 
      *    statistical preference of aminoacid types for certain
      *    phi, psi, chi1, chi2 and omega angles. 
+     *    The energies are tabulated per amino acid and bin when the knowledge
+     *    is loaded, lookups only read them.
      * */
     class PhiPsiOmegaChi1Chi2 : public TorsionPotential {
     public:
@@ -82,6 +84,7 @@ namespace Victor { namespace Energy {
             ERROR("ERROR. NOT IMPLEMENTED FOR THIS CLASS.", exception)
         }
         virtual void sAddProp(int code, int x, int y, int z, int m, int n);
+        int pGetIndex(int code, int x, int y, int chi1, int chi2, int omega) const;
         virtual int sGetPropChiBin(double p);
         virtual int sGetPropBin(double p);
         virtual int sGetPropOmegaBin(double p);
@@ -97,8 +100,9 @@ namespace Victor { namespace Energy {
         int ARC_STEP; // important: must be a divisior of 360 !!!!
         int SIZE_OF_TABLE; // "granularity" props
         int amino_count[AminoAcid_CODE_SIZE]; // total number of entries for all amino acids
-        vector<vector<vector<vector<vector<vector<int>* >* >* >* >* > propensities; // the propensities table.
-        vector<vector<vector<vector<vector<int>* >* >* >* > all_propensities; // the sum of propropensities table.
+        vector<int> propensities; // the propensities table, [aa][phi][psi][chi1][chi2][omega].
+        vector<int> all_propensities; // the sum of propropensities table, [phi][psi][chi1][chi2][omega].
+        vector<double> energies; // -log of the propensities, [aa][phi][psi][chi1][chi2][omega].
         double total; //total numer of ammino considered.
         vector<double> amino_max_propensities; //vector with max amino propensities
         // according to knowledge.
@@ -106,6 +110,21 @@ namespace Victor { namespace Energy {
         // according to knowledge.
     };
 
+    // ---------------------------------------------------------------------------
+    //                            PhiPsiOmegaChi1Chi2
+    // -----------------x-------------------x-------------------x-----------------
+
+    /**
+     *    Position of a bin in the flat tables
+     * @param   amino acid code (int), phi, psi, chi1, chi2 and omega bins (int)
+     * @return  index into propensities and energies (int)
+     */
+    inline int PhiPsiOmegaChi1Chi2::pGetIndex(int code, int x, int y, int chi1,
+            int chi2, int omega) const {
+        return ((((code * SIZE_OF_TABLE + x) * SIZE_OF_TABLE + y) * CHI_RANGE
+                + chi1) * CHI_RANGE + chi2) * RANGE_OMEGA + omega;
+    }
+
 }} // namespace
 #endif// _PHIPSIOMEGACHI1CHI2_H_
 
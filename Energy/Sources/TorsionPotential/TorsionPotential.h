@@ -99,6 +99,9 @@ using namespace Victor;
         // HELPERS:
         virtual void pConstructData() = 0;
         virtual void pResetData() = 0;
+        void pConstructEnergyTable(const vector<int>& props,
+                const vector<int>& allProps, const int* aminoCount,
+                double total, vector<double>& energies);
 
         virtual double getOmegaAngle(int prop, long RANGE_OMEGA) {
             ERROR("ERROR. NOT IMPLEMENTED FOR THIS CLASS.", exception)
@@ -160,6 +163,28 @@ using namespace Victor;
         return tmp;
     }
 
+    /**
+     *   Converts the propensity counts into energies once, so that an energy
+     *   lookup is a single indexed load. props holds one row of 
+     *   allProps.size() cells per amino acid type.
+     * @param  counts per amino acid and cell (const vector<int>&), counts per 
+     *   cell summed over all types (const vector<int>&), counts per amino 
+     *   acid type (const int*), total count (double), table to fill 
+     *   (vector<double>&)
+     * @return  changes the object internally (void)
+     */
+    inline void TorsionPotential::pConstructEnergyTable(const vector<int>& props,
+            const vector<int>& allProps, const int* aminoCount, double total,
+            vector<double>& energies) {
+        const unsigned int cells = allProps.size();
+        energies.resize(props.size());
+        for (unsigned int i = 0; i < props.size(); i++) {
+            unsigned int code = i / cells;
+            energies[i] = -log((static_cast<double> (props[i]) / allProps[i % cells])
+                    / (static_cast<double> (aminoCount[code]) / total));
+        }
+    }
+
 
 }} // namespace
 #endif// _TORSIONPOTENTIAL_H_
@@ -0,0 +1,153 @@
+/*
+ * TestEffectiveSolvationPotential.h
+ *
+ *  Checks the burial profile against a direct evaluation of the buried
+ *  fractions and its cache against a fresh potential.
+ */
+
+#include <iostream>
+#include <cmath>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <PdbLoader.h>
+#include <Protein.h>
+#include <EffectiveSolvationPotential.h>
+
+using namespace std;
+using namespace Biopool;
+
+class TestEffectiveSolvationPotential : public CppUnit::TestFixture {
+private:
+        string path;
+public:
+	TestEffectiveSolvationPotential() : path(getenv("VICTOR_ROOT")) {}
+	virtual ~TestEffectiveSolvationPotential() {}
+
+	static CppUnit::Test *suite() {
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestEffectiveSolvationPotential");
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestEffectiveSolvationPotential>("Test1 - residue terms add up to the chain energy.",
+				&TestEffectiveSolvationPotential::testEffectiveSolvationPotential_residueTerms ));
+
+                suiteOfTests->addTest(new CppUnit::TestCaller<TestEffectiveSolvationPotential>("Test2 - buried fractions follow moved atoms.",
+				&TestEffectiveSolvationPotential::testEffectiveSolvationPotential_movedAtoms ));
+
+                suiteOfTests->addTest(new CppUnit::TestCaller<TestEffectiveSolvationPotential>("Test3 - energy follows mutated residues.",
+				&TestEffectiveSolvationPotential::testEffectiveSolvationPotential_mutated ));
+
+		return suiteOfTests;
+	}
+
+	/// Setup method
+	void setUp() {}
+
+	/// Teardown method
+	void tearDown() {}
+
+protected:
+
+        /// direct evaluation of the buried fraction of residue index
+        static double sFracBuried(unsigned int index, Spacer& sp) {
+                double barea = 0.0;
+                double fneb = 0.0;
+                for (unsigned int j = 0; j < sp.sizeAmino(); j++)
+                    if ((j > index + 1) || (j < index - 1)) {
+                        fneb += 4.0 / sp.getAmino(index)[CA].distance(sp.getAmino(j)[CA]);
+                        for (unsigned int k = 0; k < sp.sizeAmino(); k++)
+                            if ((k > index + 1) || (k < index - 1)) {
+                                double scheck = sp.getAmino(index)[CA].distance(sp.getAmino(j)[CA])
+                                        / (sp.getAmino(index)[CA].distance(sp.getAmino(k)[CA])
+                                        + sp.getAmino(j)[CA].distance(sp.getAmino(k)[CA]));
+                                if (scheck > 0.7)
+                                    fneb *= (1 - scheck);
+                            }
+                        barea += fneb;
+                    }
+                return (barea > 10.0 ? 10.0 : barea);
+        }
+
+        static bool sSameFracBuried(EffectiveSolvationPotential& pot, Spacer& sp) {
+                vector<double> frac = pot.calculateFracBuried(sp);
+                if (frac.size() != sp.sizeAmino())
+                    return false;
+                for (unsigned int i = 1; i + 1 < sp.sizeAmino(); i++)
+                    if (fabs(frac[i] - sFracBuried(i, sp)) > 1e-9)
+                        return false;
+                return true;
+        }
+
+        /// loads 3DFR with the CA of residue 40 placed on top of the CA of
+        /// residue 2, which makes both buried and the energy non-zero
+        void load(Protein& prot) {
+                string p = path + "Biopool/Tests/data/3DFR.pdb";
+                ifstream inFile(p.c_str());
+                if (!inFile)
+                  ERROR("File not found.", exception);
+                PdbLoader pl(inFile);
+                pl.setNoHAtoms();
+                pl.setNoVerbose();
+                prot.load(pl);
+                Spacer &sp = *prot.getSpacer(0u);
+                sp.getAmino(40)[CA].setCoords(sp.getAmino(2)[CA].getCoords());
+        }
+
+	void testEffectiveSolvationPotential_residueTerms() {
+                Protein prot;
+                load(prot);
+                Spacer &sp = *prot.getSpacer(0u);
+
+                EffectiveSolvationPotential pot;
+                long double chain = pot.calculateEnergy(sp.getAmino(0), sp);
+                long double sum = 0.0;
+                for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+                    sum += pot.calculateResidueEnergy(i, sp);
+
+		CPPUNIT_ASSERT( fabs(chain) > 1.0 );
+		CPPUNIT_ASSERT( fabs(sum - chain) < 1e-9 );
+		CPPUNIT_ASSERT( fabs(pot.calculateEnergy(sp) - sp.sizeAmino() * chain) < 1e-6 );
+		CPPUNIT_ASSERT( fabs(pot.calculateEnergy(sp, 10, 20) - 10 * chain) < 1e-9 );
+		CPPUNIT_ASSERT( pot.calculateEnergy(sp, 20, 10) == 0.0 );
+		CPPUNIT_ASSERT( sSameFracBuried(pot, sp) );
+	}
+
+	void testEffectiveSolvationPotential_movedAtoms() {
+                Protein prot;
+                load(prot);
+                Spacer &sp = *prot.getSpacer(0u);
+
+                EffectiveSolvationPotential pot;
+                long double before = pot.calculateEnergy(sp.getAmino(0), sp);
+
+                sp.getAmino(60)[CA].setCoords(sp.getAmino(20)[CA].getCoords());
+                long double after = pot.calculateEnergy(sp.getAmino(0), sp);
+                EffectiveSolvationPotential fresh;
+
+		CPPUNIT_ASSERT( after != before );
+		CPPUNIT_ASSERT( fabs(after - fresh.calculateEnergy(sp.getAmino(0), sp)) < 1e-9 );
+		CPPUNIT_ASSERT( sSameFracBuried(pot, sp) );
+	}
+
+	void testEffectiveSolvationPotential_mutated() {
+                Protein prot;
+                load(prot);
+                Spacer &sp = *prot.getSpacer(0u);
+
+                EffectiveSolvationPotential pot;
+                long double before = pot.calculateEnergy(sp.getAmino(0), sp);
+
+                // same CA coordinates, the cached profile must not be used
+                sp.getAmino(2).setType("ASP");
+                long double after = pot.calculateEnergy(sp.getAmino(0), sp);
+                EffectiveSolvationPotential fresh;
+
+		CPPUNIT_ASSERT( after != before );
+		CPPUNIT_ASSERT( fabs(after - fresh.calculateEnergy(sp.getAmino(0), sp)) < 1e-9 );
+		CPPUNIT_ASSERT( fabs(pot.calculateResidueEnergy(2, sp)
+                        - fresh.calculateResidueEnergy(2, sp)) < 1e-9 );
+	}
+
+};
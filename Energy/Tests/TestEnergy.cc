@@ -11,6 +11,8 @@
 
 #include <TestRapdfPotential.h>
 #include <TestSolvationPotential.h>
+#include <TestEffectiveSolvationPotential.h>
+#include <TestRapdfSegmentEnergy.h>
 using namespace std;
 using namespace Victor;
 using namespace Victor::Biopool;
@@ -22,6 +24,8 @@ int main() {
 	cout << "Creating Test Suites for Energy:" << endl;
         runner.addTest(TestRapdfPotential::suite());
         runner.addTest(TestSolvationPotential::suite());
+        runner.addTest(TestEffectiveSolvationPotential::suite());
+        runner.addTest(TestRapdfSegmentEnergy::suite());
 	cout<< "Running the unit tests."<<endl;
 	runner.run();
 
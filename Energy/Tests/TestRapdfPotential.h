@@ -16,6 +16,7 @@
 #include <XyzLoader.h>
 #include <Protein.h>
 #include <RapdfPotential.h>
+#include <EnergyBatch.h>
 
 using namespace std;
 using namespace Victor;
@@ -46,6 +47,15 @@ public:
                 
                 suiteOfTests->addTest(new CppUnit::TestCaller<TestRapdfPotential>("Test4 - energy aa vs aa.",
 				&TestRapdfPotential::testRapdfPotential_calcEnergyAA2AA ));
+                
+                suiteOfTests->addTest(new CppUnit::TestCaller<TestRapdfPotential>("Test5 - precomputed atom types.",
+				&TestRapdfPotential::testRapdfPotential_typeIndex ));
+                
+                suiteOfTests->addTest(new CppUnit::TestCaller<TestRapdfPotential>("Test6 - threaded and batch energies.",
+				&TestRapdfPotential::testRapdfPotential_threads ));
+
+                suiteOfTests->addTest(new CppUnit::TestCaller<TestRapdfPotential>("Test7 - built-in table vs ram.par.",
+				&TestRapdfPotential::testRapdfPotential_embeddedTable ));
 
 		return suiteOfTests;
 	}
@@ -139,4 +149,66 @@ protected:
 		CPPUNIT_ASSERT( r.calculateEnergy(aa0, aa1)
                         == r.calculateEnergy(aa0.getAtom(0), aa1.getAtom(0), "ALA", "ALA") * aa0.size() * aa1.size() );
 	}
+        
+        void testRapdfPotential_typeIndex() {
+                RapdfPotential r;
+                //indices as listed in ram.par
+		CPPUNIT_ASSERT( r.getTypeIndex(ALA, N) == 1 );
+		CPPUNIT_ASSERT( r.getTypeIndex(TYR, OH) == 167 );
+                //atoms which are not scored
+		CPPUNIT_ASSERT( r.getTypeIndex(GLY, CB) == RAPDF_IGNORE );
+		CPPUNIT_ASSERT( r.getTypeIndex(ALA, OXT) == RAPDF_IGNORE );
+		CPPUNIT_ASSERT( r.getTypeIndex(ALA, HA) == RAPDF_IGNORE );
+		CPPUNIT_ASSERT( r.getTypeIndex(XXX, CA) == RAPDF_IGNORE );
+	}
+        
+        void testRapdfPotential_threads() {
+                string p = path + "Energy/Tests/data/rapd.pdb";
+                ifstream inFile(p.c_str());
+                if (!inFile)
+                  ERROR("File not found.", exception);
+                PdbLoader pl(inFile);
+                pl.setNoHAtoms();
+                pl.setNoVerbose();
+                pl.setPermissive();
+                Protein prot;
+                prot.load(pl);
+                Spacer &sp = *prot.getSpacer((unsigned int)0);
+                
+                RapdfPotential r;
+                long double serial = r.calculateEnergy(sp);
+                r.setNumThreads(4);
+                //rows are summed in the same order, whatever the threads
+		CPPUNIT_ASSERT( r.calculateEnergy(sp) == serial );
+                
+                EnergyBatch batch(4);
+                batch.addPotential(&r);
+                vector<string> files;
+                files.push_back(p);
+                files.push_back(path + "Energy/Tests/data/missing.pdb");
+                files.push_back(p);
+                vector<vector<long double> > res = batch.calculateEnergy(files);
+		CPPUNIT_ASSERT( res.size() == 3 );
+		CPPUNIT_ASSERT( (res[0].size() == 1) && (res[0][0] == serial) );
+		CPPUNIT_ASSERT( res[1].empty() );
+		CPPUNIT_ASSERT( (res[2].size() == 1) && (res[2][0] == serial) );
+	}
+
+        void testRapdfPotential_embeddedTable() {
+                string p = path + "Energy/Tests/data/rapd.pdb";
+                ifstream inFile(p.c_str());
+                if (!inFile)
+                  ERROR("File not found.", exception);
+                PdbLoader pl(inFile);
+                pl.setNoHAtoms();
+                pl.setNoVerbose();
+                pl.setPermissive();
+                Protein prot;
+                prot.load(pl);
+                Spacer &sp = *prot.getSpacer((unsigned int)0);
+
+                RapdfPotential builtIn;
+                RapdfPotential fromFile(path + "data/ram.par");
+		CPPUNIT_ASSERT( builtIn.calculateEnergy(sp) == fromFile.calculateEnergy(sp) );
+	}
 };
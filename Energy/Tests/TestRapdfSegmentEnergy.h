@@ -0,0 +1,150 @@
+/*
+ * TestRapdfSegmentEnergy.h
+ *
+ *  Checks incremental segment energies against a full evaluation.
+ */
+
+#include <iostream>
+#include <cmath>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <PdbLoader.h>
+#include <Protein.h>
+#include <RapdfPotential.h>
+#include <RapdfSegmentEnergy.h>
+
+using namespace std;
+using namespace Victor;
+using namespace Victor::Biopool;
+using namespace Victor::Energy;
+
+class TestRapdfSegmentEnergy : public CppUnit::TestFixture {
+private:
+        string path;
+public:
+	TestRapdfSegmentEnergy() : path(getenv("VICTOR_ROOT")) {}
+	virtual ~TestRapdfSegmentEnergy() {}
+
+	static CppUnit::Test *suite() {
+		CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestRapdfSegmentEnergy");
+
+		suiteOfTests->addTest(new CppUnit::TestCaller<TestRapdfSegmentEnergy>("Test1 - segment energy vs. residue pairs.",
+				&TestRapdfSegmentEnergy::testRapdfSegmentEnergy_energy ));
+
+                suiteOfTests->addTest(new CppUnit::TestCaller<TestRapdfSegmentEnergy>("Test2 - trial moves, accept and reject.",
+				&TestRapdfSegmentEnergy::testRapdfSegmentEnergy_moves ));
+
+		return suiteOfTests;
+	}
+
+	/// Setup method
+	void setUp() {}
+
+	/// Teardown method
+	void tearDown() {}
+
+protected:
+
+        /// energy of seg in sp without residues index1 to index2, as in LoopModel
+        static long double sEnergy(RapdfPotential& r, Spacer& sp,
+                unsigned int index1, unsigned int index2, Spacer& seg) {
+                long double en = 0.0;
+                for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+                    if ((i < index1) || (i > index2))
+                        for (unsigned int j = 0; j < seg.sizeAmino(); j++)
+                            en += r.calculateEnergy(sp.getAmino(i), seg.getAmino(j));
+                for (unsigned int i = 0; i < seg.sizeAmino(); i++)
+                    for (unsigned int j = i; j < seg.sizeAmino(); j++)
+                        en += r.calculateEnergy(seg.getAmino(i), seg.getAmino(j));
+                return en;
+        }
+
+        static void sMove(Spacer& sp, unsigned int r, vgVector3<double> disp) {
+                sp.getAmino(r)[CA].setCoords(sp.getAmino(r)[CA].getCoords() + disp);
+                sp.getAmino(r)[C].setCoords(sp.getAmino(r)[C].getCoords() + disp);
+        }
+
+        void load(Protein& prot) {
+                string p = path + "Biopool/Tests/data/3DFR.pdb";
+                ifstream inFile(p.c_str());
+                if (!inFile)
+                  ERROR("File not found.", exception);
+                PdbLoader pl(inFile);
+                pl.setNoHAtoms();
+                pl.setNoVerbose();
+                prot.load(pl);
+        }
+
+	void testRapdfSegmentEnergy_energy() {
+                Protein prot, prot2;
+                load(prot);
+                load(prot2);
+                Spacer &sp = *prot.getSpacer(0u);
+                Spacer &seg = *prot2.getSpacer(0u);
+
+                RapdfPotential r;
+                RapdfSegmentEnergy segEnergy(r);
+                segEnergy.setEnvironment(sp, 20, 27);
+                segEnergy.setSegment(seg);
+		CPPUNIT_ASSERT( fabs(segEnergy.getEnergy() - sEnergy(r, sp, 20, 27, seg)) < 1e-6 );
+
+                // a new environment keeps the segment
+                segEnergy.setEnvironment(sp, 0, 10);
+		CPPUNIT_ASSERT( fabs(segEnergy.getEnergy() - sEnergy(r, sp, 0, 10, seg)) < 1e-6 );
+		CPPUNIT_ASSERT( !segEnergy.isMoving() );
+	}
+
+	void testRapdfSegmentEnergy_moves() {
+                Protein prot, prot2;
+                load(prot);
+                load(prot2);
+                Spacer &sp = *prot.getSpacer(0u);
+                Spacer &seg = *prot2.getSpacer(0u);
+
+                RapdfPotential r;
+                RapdfSegmentEnergy segEnergy(r);
+                segEnergy.setEnvironment(sp, 20, 27);
+                segEnergy.setSegment(seg);
+                long double start = segEnergy.getEnergy();
+                vgVector3<double> ca = seg.getAmino(5)[CA].getCoords();
+
+                // rejected move: energy and coordinates are restored
+                vgVector3<double> disp(1.5, -0.7, 0.4);
+                segEnergy.moveAtom(5, CA, disp);
+                segEnergy.moveAtom(5, C, disp);
+                segEnergy.moveAtom(6, CA, disp / 2);
+                segEnergy.moveAtom(6, C, disp / 2);
+		CPPUNIT_ASSERT( segEnergy.isMoving() );
+                long double trial = segEnergy.calculateTrialEnergy();
+                segEnergy.rejectMove();
+		CPPUNIT_ASSERT( segEnergy.getEnergy() == start );
+		CPPUNIT_ASSERT( (segEnergy.getCoords(5, CA) - ca).length() == 0.0 );
+
+                // the same move on the Spacer
+                sMove(seg, 5, disp);
+                sMove(seg, 6, disp / 2);
+		CPPUNIT_ASSERT( fabs(trial - sEnergy(r, sp, 20, 27, seg)) < 1e-6 );
+		CPPUNIT_ASSERT( trial != start );
+
+                // accepted moves add up
+                segEnergy.moveAtom(5, CA, disp);
+                segEnergy.moveAtom(5, C, disp);
+                segEnergy.moveAtom(6, CA, disp / 2);
+                segEnergy.moveAtom(6, C, disp / 2);
+                segEnergy.calculateTrialEnergy();
+                segEnergy.acceptMove();
+                segEnergy.moveAtom(40, CA, -disp);
+                segEnergy.moveAtom(40, C, -disp);
+                long double trial2 = segEnergy.calculateTrialEnergy();
+                segEnergy.acceptMove();
+                sMove(seg, 40, -disp);
+		CPPUNIT_ASSERT( fabs(trial2 - sEnergy(r, sp, 20, 27, seg)) < 1e-6 );
+		CPPUNIT_ASSERT( segEnergy.getEnergy() == trial2 );
+		CPPUNIT_ASSERT( !segEnergy.isMoving() );
+	}
+
+};
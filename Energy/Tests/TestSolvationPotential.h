@@ -42,6 +42,9 @@ public:
                 suiteOfTests->addTest(new CppUnit::TestCaller<TestSolvationPotential>("Test3 - energy propensity difference have to be positive.",
 				&TestSolvationPotential::testSolvationPotential_increasingPropensity ));
                 
+                suiteOfTests->addTest(new CppUnit::TestCaller<TestSolvationPotential>("Test4 - residue energies follow moved atoms.",
+				&TestSolvationPotential::testSolvationPotential_movedAtoms ));
+                
 		return suiteOfTests;
 	}
 
@@ -111,4 +114,36 @@ protected:
 		CPPUNIT_ASSERT( increasingEnergy );
 	}
         
+        void testSolvationPotential_movedAtoms() {
+                string p = path + "Biopool/Tests/data/3DFR.pdb";
+                ifstream inFile(p.c_str());
+                if (!inFile)
+                  ERROR("File not found.", exception);
+                PdbLoader pl(inFile);
+                pl.setNoHAtoms();
+                pl.setNoVerbose();
+                Protein prot;
+                prot.load(pl);
+                Spacer &sp = *prot.getSpacer(0u);
+
+                SolvationPotential pot;
+                long double before = 0.0;
+                for (unsigned int i = 0; i < sp.sizeAmino(); i++)
+                    before += pot.calculateSolvation(sp.getAmino(i), sp);
+                CPPUNIT_ASSERT( fabs(before - pot.calculateEnergy(sp)) < 1e-9 );
+
+                // a CB placed next to another one changes both counts
+                sp.getAmino(40).getSideChain()[CB].setCoords(
+                        sp.getAmino(2).getSideChain()[CB].getCoords()
+                        + vgVector3<double>(1.0, 0.0, 0.0));
+                SolvationPotential fresh;
+                long double after = 0.0;
+                for (unsigned int i = 0; i < sp.sizeAmino(); i++) {
+                    long double en = pot.calculateSolvation(sp.getAmino(i), sp);
+                    CPPUNIT_ASSERT( en == fresh.calculateSolvation(sp.getAmino(i), sp, 0, 9999) );
+                    after += en;
+                }
+		CPPUNIT_ASSERT( after != before );
+	}
+
 };
@@ -47,7 +47,7 @@ int main(int nArgs, char* argv[]) {
     string inputFile, outputFile, sequenceFile, scwrlFile, scatterFile,
             tableFile, chainID;
     vector<char> allCh;
-    unsigned int pdbIndex1, pdbIndex2, num, num2, maxWrite;
+    unsigned int pdbIndex1, pdbIndex2, num, num2, maxWrite, threads;
 
     getArg("i", inputFile, nArgs, argv, "!");
     getArg("o", outputFile, nArgs, argv, "target.pdb");
@@ -61,6 +61,7 @@ int main(int nArgs, char* argv[]) {
     getArg("-maxWrite", maxWrite, nArgs, argv, 9999);
     getArg("-scatter", scatterFile, nArgs, argv, "!");
     getArg("-table", tableFile, nArgs, argv, "!");
+    getArg("-threads", threads, nArgs, argv, 1);
 
     bool verbose = getArg("-verbose", nArgs, argv);
     bool test = getArg("-test", nArgs, argv);
@@ -78,6 +79,7 @@ int main(int nArgs, char* argv[]) {
         lm.setTableFileName(tableFile);
 
     lm.setVerbose(2);
+    lm.setNumThreads(threads);
 
     double tmpEW = lm.getENDRMS_WEIGHT();
     getOption(tmpEW, "-endrmsWeigth", nArgs, argv);
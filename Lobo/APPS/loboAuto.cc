@@ -54,7 +54,7 @@ int main(int nArgs, char* argv[]) {
 
     string inputFile, outputFile, sequenceFile, scwrlFile, scatterFile,
             tableFile, chainID;
-    unsigned int pdbIndex1, pdbIndex2, pdbLength, num, num2, maxWrite;
+    unsigned int pdbIndex1, pdbIndex2, pdbLength, num, num2, maxWrite, threads;
 
     getArg("i", inputFile, nArgs, argv, "!");
     getArg("c", chainID, nArgs, argv, "!");
@@ -68,6 +68,7 @@ int main(int nArgs, char* argv[]) {
     getArg("-maxWrite", maxWrite, nArgs, argv, 9999);
     getArg("-scatter", scatterFile, nArgs, argv, "!");
     getArg("-table", tableFile, nArgs, argv, "!");
+    getArg("-threads", threads, nArgs, argv, 1);
 
     pdbIndex2 = pdbIndex1 + pdbLength;
 
@@ -90,6 +91,7 @@ int main(int nArgs, char* argv[]) {
         lm.setTableFileName(tableFile);
 
     lm.setVerbose(2);
+    lm.setNumThreads(threads);
 
     double tmpEW = lm.getENDRMS_WEIGHT();
     getOption(tmpEW, "-endrmsWeigth", nArgs, argv);
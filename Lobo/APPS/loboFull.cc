@@ -42,7 +42,7 @@ int main(int nArgs, char* argv[]) {
 
     string inputFile, outputFile, scwrlFile, scatterFile, tableFile, chainID;
     vector<char> allCh;
-    unsigned int windowSize, num, num2, maxWrite;
+    unsigned int windowSize, num, num2, maxWrite, threads;
     getArg("i", inputFile, nArgs, argv, "!");
     getArg("o", outputFile, nArgs, argv, "null");
     getArg("s", windowSize, nArgs, argv, 5);
@@ -54,6 +54,7 @@ int main(int nArgs, char* argv[]) {
     getArg("-scatter", scatterFile, nArgs, argv, "!");
     getArg("-maxWrite", maxWrite, nArgs, argv, 9999);
     getArg("-table", tableFile, nArgs, argv, "!");
+    getArg("-threads", threads, nArgs, argv, 1);
 
     ofstream scatFile(scatterFile.c_str());
     if (!scatFile)
@@ -72,6 +73,7 @@ int main(int nArgs, char* argv[]) {
         lm.setTableFileName(tableFile);
 
     lm.setVerbose(2);
+    lm.setNumThreads(threads);
 
     double tmpEW = lm.getENDRMS_WEIGHT();
 
@@ -0,0 +1,87 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @Description This program converts a compressed LUT, as written by loboLUT,
+ * into the binary format that the lobo programs map into memory. The
+ * entries are rotated into the XY plane before saving, so that no further
+ * processing is needed at load time.
+ */
+#include <string>
+#include <ctime>
+#include <GetArg.h>
+#include <LoopTable.h>
+
+using namespace Victor;
+using namespace Victor::Lobo;
+
+/// seconds needed to read fileName and prepare it for ring closure
+double sLoadTime(const string& fileName) {
+    clock_t start = clock();
+    LoopTable lt;
+    lt.read(fileName);
+    if (!lt.isRotated())
+        lt.rotateIntoXYPlane();
+    return static_cast<double> (clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int nArgs, char* argv[]) {
+    char *victor = getenv("VICTOR_ROOT");
+    if (victor == NULL)
+        ERROR(" Environment variable VICTOR_ROOT was not found.\n Use the command:\n export VICTOR_ROOT=......", exception);
+    string dataPath = getenv("VICTOR_ROOT");
+    dataPath += "data/";
+
+    if (getArg("h", nArgs, argv)) {
+        cout << "This program converts a LUT into the memory mapped format"
+                << " used by the lobo programs.\n"
+                << " Options: \n"
+                << "\t -i <file> \t Name of the input file (eg. aa8.lt).\n"
+                << "\t -o <file> \t Name of the output file.\n"
+                << "\t [--table <name>]Path of LUT files (default = "
+                << dataPath << ") \n"
+                << "\t [-v] \t\t Verbose mode, compares load times.\n"
+                << endl;
+        return 1;
+    }
+
+    bool verbose = getArg("v", nArgs, argv);
+
+    string inputFile, outputFile, tableFile;
+    getArg("i", inputFile, nArgs, argv, "!");
+    getArg("o", outputFile, nArgs, argv, "!");
+    getArg("-table", tableFile, nArgs, argv, dataPath);
+
+    if ((inputFile == "!") || (outputFile == "!")) {
+        cout << "Missing file specification. Aborting. (-h for help)" << endl;
+        return -1;
+    }
+
+    LoopTable lt;
+    lt.read(tableFile + inputFile);
+    if (!lt.isRotated())
+        lt.rotateIntoXYPlane();
+    lt.writeMapped(tableFile + outputFile);
+
+    if (verbose)
+        cout << "entries:\t" << lt.size() << "\n"
+            << "load " << inputFile << " (s):\t"
+            << sLoadTime(tableFile + inputFile) << "\n"
+            << "load " << outputFile << " (s):\t"
+            << sLoadTime(tableFile + outputFile) << "\n";
+
+    return 0;
+}
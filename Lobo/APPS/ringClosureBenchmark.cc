@@ -0,0 +1,132 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @Description Measures the time needed by LoopModel to close loops of
+ * increasing length, eg. to compare the table search strategies or the
+ * number of threads. Times are wall clock times.
+ */
+#include <string>
+#include <ThreadTools.h>
+#include <GetArg.h>
+#include <LoopModel.h>
+#include <PdbLoader.h>
+
+#include <LoboTools.h>
+using namespace Victor;
+using namespace Victor::Lobo;
+using namespace Victor::Biopool;
+
+void sShowHelp() {
+    cout << "Ring Closure Benchmark\n"
+            << " Options: \n"
+            << "\t-i <filename> \t\t Input PDB file\n"
+            << "\t[-c <id>] \t\t Chain identifier (def = first chain)\n"
+            << "\t[-s <index>] \t\t Index of the N-terminal anchor (def = 10)\n"
+            << "\t[--min <length>] \t Shortest loop (def = 2)\n"
+            << "\t[--max <length>] \t Longest loop (def = 8)\n"
+            << "\t[-n <num>] \t\t Repetitions per loop (def = 3)\n"
+            << "\t[--sol1 <n-solutions>] \t Number of primary solutions (def = 50)\n"
+            << "\t[--sol2 <n-solutions>] \t Number of secondary solutions (def = 1)\n"
+            << "\t[--table <name>] \t Path and basename of LUT files\n"
+            << "\t[--kdTree] \t\t Search the tables with a k-d tree\n"
+            << "\t[--threads <num>] \t Threads, 0 = all processors (def = 1),"
+            << " more than one\n\t\t\t\t searches fixed tables\n"
+            << "\n";
+}
+
+int main(int nArgs, char* argv[]) {
+    if (getArg("h", nArgs, argv)) {
+        sShowHelp();
+        return 1;
+    };
+
+    string inputFile, chainID, tableFile;
+    unsigned int start, minLen, maxLen, num, sol1, sol2, threads;
+    getArg("i", inputFile, nArgs, argv, "!");
+    getArg("c", chainID, nArgs, argv, " ");
+    getArg("s", start, nArgs, argv, 10);
+    getArg("-min", minLen, nArgs, argv, 2);
+    getArg("-max", maxLen, nArgs, argv, 8);
+    getArg("n", num, nArgs, argv, 3);
+    getArg("-sol1", sol1, nArgs, argv, 50);
+    getArg("-sol2", sol2, nArgs, argv, 1);
+    getArg("-table", tableFile, nArgs, argv, "!");
+    getArg("-threads", threads, nArgs, argv, 1);
+    if (getArg("-kdTree", nArgs, argv))
+        LoopTable::USE_KD_TREE = true;
+
+    if (inputFile == "!") {
+        cout << "Missing file specification. Aborting. (-h for help)" << endl;
+        return -1;
+    }
+    if (minLen < 2)
+        minLen = 2;
+    if (num == 0)
+        num = 1;
+
+    ifstream inFile(inputFile.c_str());
+    if (!inFile)
+        ERROR("File not found.", exception);
+    PdbLoader pl(inFile);
+    pl.setNoVerbose();
+    pl.setNoHAtoms();
+    pl.setPermissive();
+    if (chainID != " ")
+        pl.setChain(chainID[0]);
+    Protein prot;
+    prot.load(pl);
+    Spacer* sp = prot.getSpacer(0u);
+
+    if (start + maxLen + 1 >= sp->sizeAmino())
+        ERROR("Loop exceeds the chain.", exception);
+
+    LoopModel lm;
+    lm.setQuiet();
+    lm.setNumThreads(threads);
+    if (tableFile != "!")
+        lm.setTableFileName(tableFile);
+
+    cout << "length\tsolutions\tload (s)\tring closure (ms)\n";
+    for (unsigned int len = minLen; len <= maxLen; len++) {
+        unsigned int index1 = start;
+        unsigned int index2 = start + len;
+        vector<string> typeVec;
+        for (unsigned int i = index1 + 1; i < index2 + 1; i++)
+            typeVec.push_back(sp->getAmino(i).getType());
+
+        // the first model also loads the tables
+        double t0 = getWallTime();
+        vector<Spacer> vsp = lm.createLoopModel(sp->getAmino(index1),
+                sp->getAmino(index1 + 1)[N].getCoords(), sp->getAmino(index2),
+                sp->getAmino(index2 + 1)[N].getCoords(), index1, index2, sol1,
+                sol2, typeVec);
+        double t1 = getWallTime();
+        for (unsigned int i = 0; i < num; i++)
+            vsp = lm.createLoopModel(sp->getAmino(index1),
+                sp->getAmino(index1 + 1)[N].getCoords(), sp->getAmino(index2),
+                sp->getAmino(index2 + 1)[N].getCoords(), index1, index2, sol1,
+                sol2, typeVec);
+        double t2 = getWallTime();
+
+        double ringClosure = (t2 - t1) / num;
+        double load = (t1 - t0) - ringClosure;
+        cout << len << "\t" << vsp.size() << "\t" << setprecision(4)
+                << (load > 0 ? load : 0.0) << "\t" << 1000 * ringClosure << "\n";
+    }
+
+    return 0;
+}
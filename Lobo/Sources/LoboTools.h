@@ -54,6 +54,11 @@ inline void showCommonOptions() {
             << "\t[--scwrl <filename>] \t Sequence output file for SCWRL (-s option)\n"
             << "\t[--table <name>] \t Path and basename of LUT files (default = "
             << getenv("VICTOR_ROOT") + path << ") \n"
+            << "\t[--threads <num>] \t Threads for ring closure, 0 = all"
+            << " processors (default = 1).\n\t\t\t\t More than one thread"
+            << " searches fixed tables with per-loop seeds:\n\t\t\t\t"
+            << " the same loops for any number of threads, other\n\t\t\t\t"
+            << " than with one thread\n"
             << "\t[--withOxygen] \t\t Include Oxygen atoms in RMSD calculation\n"
             << "\t[--verbose] \t\t Verbose mode\n"
             << "\t[--silent] \t\t Silent mode\n";
@@ -80,6 +85,8 @@ inline void showSpecialOptions() {
             << " (default= " << LoopTableEntry::LAMBDA_EP << ")\n"
             << "\t[--maxSearch] \t\t Choose max fraction of tables to search "
             << "for best result (default= " << LoopTable::MAX_FACTOR << ")\n"
+            << "\t[--kdTree] \t\t Search the whole tables for the closest "
+            << "entries with a k-d tree\n"
             << "\t[--vdwLimit] \t\t Choose threshold for VDW filter"
             << " (default= " << LoopModel::VDW_LIMIT << ")\n"
             << "\t[--energyLimit] \t Choose threshold for energy filter"
@@ -256,6 +263,8 @@ inline void treatSpecialOptions(int nArgs, char* argv[]) {
     getOption(LoopTableEntry::LAMBDA_ED, "-weigthED", nArgs, argv, true);
     getOption(LoopTableEntry::LAMBDA_EN, "-weigthEN", nArgs, argv, true);
     getOption(LoopTable::MAX_FACTOR, "-maxSearch", nArgs, argv, true);
+    if (getOption("-kdTree", nArgs, argv))
+        LoopTable::USE_KD_TREE = true;
     getOption(LoopModel::VDW_LIMIT, "-vdwLimit", nArgs, argv, true);
     getOption(LoopModel::ENERGY_LIMIT, "-energyLimit", nArgs, argv, true);
     getOption(LoopModel::SIM_LIMIT, "-simLimit", nArgs, argv, true);
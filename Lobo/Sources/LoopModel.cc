@@ -19,6 +19,7 @@
 #include <LoopTableEntry.h>
 #include <IntCoordConverter.h>
 #include <String2Number.h>
+#include <ThreadTools.h>
 #include <queue>
 //#include <EnergyCalculatorImpl.h>
 
@@ -59,10 +60,71 @@ static double sDistance(vgVector3<double> xv, vgVector3<double> yv) {
 }
 
 
+namespace Victor { namespace Lobo {
+
+    /**
+     * Closes the ring through one middle candidate and one alternative
+     * (item n = middle n / depth, alternative n % depth) of
+     * LoopModel::ringClosureBase(), into the item's own solution buffer.
+     * With several threads each item draws its bond geometry noise from
+     * its own seed and the tables are searched without moving entries (see
+     * LoopModel::loadTables()), so the result is the same for any number
+     * of threads above one. Without seeds (one thread) the items draw from
+     * rand() in order, as a single loop, on tables that move short loops.
+     */
+    class RingClosureTask : public ParallelTask {
+    public:
+
+        RingClosureTask(LoopModel& _lm, const vector<LoopTableEntry>& _middle,
+                const LoopTableEntry& _end, unsigned int _midAminoAcids,
+                unsigned int _nAminoAcids, double _offsetPhi,
+                const VectorTransformation& _vt, unsigned int _depth,
+                const vector<unsigned int>& _seed,
+                vector<vector<vgVector3<float> > >& _solution)
+        : lm(_lm), middle(_middle), end(_end), midAminoAcids(_midAminoAcids),
+        nAminoAcids(_nAminoAcids), offsetPhi(_offsetPhi), vt(_vt),
+        depth(_depth), seed(_seed), solution(_solution) {
+        }
+
+        virtual void run(unsigned int n) {
+            unsigned int i = n / depth;
+            unsigned int j = n % depth;
+            LoopTableEntry origin;
+            origin.endDirection = vgVector3<float>(0, 0, 0);
+            unsigned int itemSeed;
+            if (!seed.empty()) {
+                itemSeed = seed[n];
+                setThreadSeed(&itemSeed);
+            }
+
+            lm.ringClosure(origin, middle[i], 1, midAminoAcids, offsetPhi, vt,
+                    solution[n], j);
+            lm.ringClosure(middle[i], end, midAminoAcids + 1,
+                    (nAminoAcids / 2), 0, vt, solution[n], j);
+            setThreadSeed(NULL);
+        }
+
+    private:
+        LoopModel& lm;
+        const vector<LoopTableEntry>& middle;
+        const LoopTableEntry& end;
+        unsigned int midAminoAcids;
+        unsigned int nAminoAcids;
+        double offsetPhi;
+        const VectorTransformation& vt;
+        unsigned int depth;
+        const vector<unsigned int>& seed;
+        vector<vector<vgVector3<float> > >& solution;
+    };
+
+}} // namespace
+
+
 // CONSTRUCTORS/DESTRUCTOR:
 
 LoopModel::LoopModel() : pInter(false),
-pPlot(false), pVerbose(0), pScatter(&cout), table(), solution() {
+pPlot(false), pVerbose(0), pScatter(&cout), table(), solution(),
+numThreads(1) {
     string tableFile = getenv("VICTOR_ROOT");
     if (tableFile.length() < 3)
         ERROR("Environment variable VICTOR_ROOT was not found.", exception);
@@ -288,6 +350,35 @@ LoopModel::refineModel(Spacer& sp, unsigned int index1, unsigned int index2,
     }
 }
 
+/**
+ * Moves the backbone (N, CA, C) of a loop residue.
+ */
+void sMoveBackbone(Spacer& sp, unsigned int r, vgVector3<double> disp) {
+    sp.getAmino(r)[N].setCoords(sp.getAmino(r)[N].getCoords() + disp);
+    sp.getAmino(r)[CA].setCoords(sp.getAmino(r)[CA].getCoords() + disp);
+    sp.getAmino(r)[C].setCoords(sp.getAmino(r)[C].getCoords() + disp);
+}
+
+void sMoveBackbone(RapdfSegmentEnergy& seg, unsigned int r,
+        vgVector3<double> disp) {
+    seg.moveAtom(r, N, disp);
+    seg.moveAtom(r, CA, disp);
+    seg.moveAtom(r, C, disp);
+}
+
+/**
+ * Local modification of optimizeModel(): residue curr of a loop of max - 1
+ * residues is moved by disp, its neighbours by disp / 2.
+ */
+template <class T>
+void sLocalMove(T& loop, int curr, int max, vgVector3<double> disp) {
+    sMoveBackbone(loop, curr, disp);
+    if (curr > 1)
+        sMoveBackbone(loop, curr - 1, disp / 2);
+    if (curr < max - 2)
+        sMoveBackbone(loop, curr + 1, disp / 2);
+}
+
 void
 LoopModel::optimizeModel(Spacer& sp, unsigned int index1, unsigned int index2,
         vector<Spacer>& solVec, bool verbose) {
@@ -299,6 +390,11 @@ LoopModel::optimizeModel(Spacer& sp, unsigned int index1, unsigned int index2,
         cout << "Optimizing:\n";
     }
 
+    // trial moves are evaluated on a RapdfSegmentEnergy and rolled back,
+    // only the best one is applied to the solution
+    RapdfSegmentEnergy segEnergy(rapdf);
+    segEnergy.setEnvironment(sp, index1, index2);
+
     for (unsigned svOffset = 0; svOffset < (solVec.size() > OPT_NUM ? OPT_NUM :
             solVec.size()); svOffset++) {
         if (verbose) {
@@ -321,60 +417,38 @@ LoopModel::optimizeModel(Spacer& sp, unsigned int index1, unsigned int index2,
             cout << "Attempting local optimization:\n";
         }
 
-        Spacer bestSp = solVec[svOffset];
+        segEnergy.setSegment(solVec[svOffset]);
+        double startScore = getENDRMS_WEIGHT() * pCalculateRms(sp, index1,
+                index2, segEnergy) + ENERGY_WEIGTH * segEnergy.getEnergy();
+
+        int bestCurr = -1;
+        vgVector3<double> bestDisp(0.0, 0.0, 0.0);
 
         for (unsigned int i = 0; i < OPT_MAX1; i++)
             for (unsigned int j = 0; j < OPT_MAX2; j++) {
-                Spacer tmpSp = solVec[svOffset];
-                minScore = getENDRMS_WEIGHT() * calculateRms(sp, index1, index2,
-                        solVec[svOffset], false)
-                        + ENERGY_WEIGTH * calculateEnergy(sp, index1, index2,
-                        solVec[svOffset]);
+                minScore = startScore;
 
                 // attempt local modifications
 
                 int curr = rand() % (max - 1);
 
-                //  	cout << curr << "\t";
-
                 vgVector3<double> disp(0.0, 0.0, 0.0);
 
                 disp[0] += sRandom(curr, max - 1);
                 disp[1] += sRandom(curr, max - 1);
                 disp[2] += sRandom(curr, max - 1);
-                //  	cout << "\t" << disp[0] << "\t" << disp[1] << "\t" << disp[2] << "\n";
-
-                tmpSp.getAmino(curr)[N].setCoords(
-                        tmpSp.getAmino(curr)[N].getCoords() + disp);
-                tmpSp.getAmino(curr)[CA].setCoords(
-                        tmpSp.getAmino(curr)[CA].getCoords() + disp);
-                tmpSp.getAmino(curr)[C].setCoords(
-                        tmpSp.getAmino(curr)[C].getCoords() + disp);
-
-                if (curr > 1) {
-                    tmpSp.getAmino(curr - 1)[N].setCoords(
-                            tmpSp.getAmino(curr - 1)[N].getCoords() + disp / 2);
-                    tmpSp.getAmino(curr - 1)[CA].setCoords(
-                            tmpSp.getAmino(curr - 1)[CA].getCoords() + disp / 2);
-                    tmpSp.getAmino(curr - 1)[C].setCoords(
-                            tmpSp.getAmino(curr - 1)[C].getCoords() + disp / 2);
-                }
 
-                if (curr < max - 2) {
-                    tmpSp.getAmino(curr + 1)[N].setCoords(
-                            tmpSp.getAmino(curr + 1)[N].getCoords() + disp / 2);
-                    tmpSp.getAmino(curr + 1)[CA].setCoords(
-                            tmpSp.getAmino(curr + 1)[CA].getCoords() + disp / 2);
-                    tmpSp.getAmino(curr + 1)[C].setCoords(
-                            tmpSp.getAmino(curr + 1)[C].getCoords() + disp / 2);
-                }
+                sLocalMove(segEnergy, curr, max, disp);
 
-                double actEn = calculateEnergy(sp, index1, index2, tmpSp);
-                double actScore = getENDRMS_WEIGHT() * calculateRms(sp, index1, index2,
-                        tmpSp, false)
+                double actEn = segEnergy.calculateTrialEnergy();
+                double actScore = getENDRMS_WEIGHT() * pCalculateRms(sp,
+                        index1, index2, segEnergy)
                         + ENERGY_WEIGTH * actEn;
+                segEnergy.rejectMove();
                 if (actScore < minScore) {
                     if (verbose) {
+                        Spacer tmpSp = solVec[svOffset];
+                        sLocalMove(tmpSp, curr, max, disp);
                         cout << i << " " << j << " new minimum= " << actEn << "\t";
                         calculateRms(sp, index1, index2, tmpSp);
                     }
@@ -383,16 +457,18 @@ LoopModel::optimizeModel(Spacer& sp, unsigned int index1, unsigned int index2,
 
                     if (actScore < bestScore) {
                         bestScore = actScore;
-                        bestSp = tmpSp;
+                        bestCurr = curr;
+                        bestDisp = disp;
                     }
                 }
             }
-        solVec[svOffset] = bestSp;
+        if (bestCurr >= 0)
+            sLocalMove(solVec[svOffset], bestCurr, max, bestDisp);
         if (verbose) {
             cout << "-----------------------------------------\n";
-            cout << "selected = " << calculateEnergy(sp, index1, index2, bestSp)
-                    << "\t";
-            calculateRms(sp, index1, index2, bestSp);
+            cout << "selected = " << calculateEnergy(sp, index1, index2,
+                    solVec[svOffset]) << "\t";
+            calculateRms(sp, index1, index2, solVec[svOffset]);
         }
     }
     if (verbose) {
@@ -721,13 +797,17 @@ LoopModel::rankRawScore(Spacer& sp, unsigned int index1, unsigned int index2,
     unsigned int tmpIndex = 0;
     unsigned int numNotFiltered = 0;
 
+    // solutions are moved with Spacer::swap() instead of being copied;
+    // the reserve keeps tmpSolVec from copying them when it grows
+    tmpSolVec.reserve(solVec.size());
     while (solutionQueue.size() > 0) {
         if (((tmpIndex > 50) && (solutionQueue.top().dev > 1000))
                 || (tmpIndex > 1000))
             break;
 
         tmpIndex++;
-        tmpSolVec.push_back(solVec[solutionQueue.top().index1]);
+        tmpSolVec.push_back(Spacer());
+        tmpSolVec.back().swap(solVec[solutionQueue.top().index1]);
         tmpScore.push_back(solutionQueue.top().dev);
         if (solutionQueue.top().dev < 1000)
             numNotFiltered++;
@@ -740,10 +820,10 @@ LoopModel::rankRawScore(Spacer& sp, unsigned int index1, unsigned int index2,
             << " solutions survived the filtering procedure.\n";
     cout << "-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-\n";
 
-    solVec.clear();
-    solVec = tmpSolVec;
+    solVec.swap(tmpSolVec);
 
     tmpSolVec.clear();
+    tmpSolVec.reserve(solVec.size());
     while (solutionQueue.size() > 0)
         solutionQueue.pop();
     //******  
@@ -790,7 +870,8 @@ LoopModel::rankRawScore(Spacer& sp, unsigned int index1, unsigned int index2,
 
         tmpIndex++;
 
-        tmpSolVec.push_back(solVec[solutionQueue.top().index1]);
+        tmpSolVec.push_back(Spacer());
+        tmpSolVec.back().swap(solVec[solutionQueue.top().index1]);
         solutionQueue.pop();
 
         counter++;
@@ -801,10 +882,7 @@ LoopModel::rankRawScore(Spacer& sp, unsigned int index1, unsigned int index2,
     cout.precision(oldPrec);
     cout.flags(oldFlags);
 
-    solVec.clear();
-    solVec = tmpSolVec;
-
-    tmpSolVec.clear();
+    solVec.swap(tmpSolVec);
 }
 
 void
@@ -940,6 +1018,26 @@ LoopModel::calculateEndRms(const Spacer& sp, unsigned int index1,
     return sqrt(rmsE / 3);
 }
 
+/**
+ * Same as calculateRms() without output, ie. the RMS of the end residue, for
+ * the loop coordinates of a segment energy, eg. during a trial move.
+ */
+double
+LoopModel::pCalculateRms(const Spacer& sp, unsigned int index1,
+        unsigned int index2, const RapdfSegmentEnergy& seg) {
+    unsigned int offset = index2 - index1 - 1;
+    const AminoAcid& aa = sp.getAmino(index2);
+    double rmsE =
+            sqr(sDistance(const_cast<Atom&> (aa[N]).getCoords(),
+            seg.getCoords(offset, N)))
+            + sqr(sDistance(const_cast<Atom&> (aa[CA]).getCoords(),
+            seg.getCoords(offset, CA)))
+            + sqr(sDistance(const_cast<Atom&> (aa[C]).getCoords(),
+            seg.getCoords(offset, C)));
+
+    return sqrt(rmsE / 3);
+}
+
 double
 LoopModel::calculateRms(const Spacer& sp, unsigned int index1,
         unsigned int index2, const Spacer& sp2, bool output, bool withOxygen) {
@@ -1375,6 +1473,7 @@ LoopModel::copy(const LoopModel& orig) {
     pInter = orig.pInter;
     pVerbose = orig.pVerbose;
     pPlot = orig.pPlot;
+    numThreads = orig.numThreads;
     //    pScatter = const_cast<ostream&>(orig.pScatter);
 
     //  deep copy of: table = orig.table;
@@ -1430,7 +1529,10 @@ void
 LoopModel::clusterLoops(vector<Spacer>& solVec) {
     vector<Spacer> tmpSolVec;
 
-    tmpSolVec.push_back(solVec[0]);
+    // solutions are moved with Spacer::swap() instead of being copied
+    tmpSolVec.reserve(solVec.size());
+    tmpSolVec.push_back(Spacer());
+    tmpSolVec.back().swap(solVec[0]);
 
     for (unsigned int i = 1; i < solVec.size(); i++) {
         bool contained = false;
@@ -1441,8 +1543,10 @@ LoopModel::clusterLoops(vector<Spacer>& solVec) {
                 break;
             }
 
-        if (!contained)
-            tmpSolVec.push_back(solVec[i]);
+        if (!contained) {
+            tmpSolVec.push_back(Spacer());
+            tmpSolVec.back().swap(solVec[i]);
+        }
     }
 
     if (pVerbose > 1) {
@@ -1453,9 +1557,7 @@ LoopModel::clusterLoops(vector<Spacer>& solVec) {
         cout << "-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-x-\n";
     }
 
-    solVec.clear();
-    solVec = tmpSolVec;
-
+    solVec.swap(tmpSolVec);
 }
 
 
@@ -1730,24 +1832,25 @@ LoopModel::ringClosureBase(const LoopTableEntry& source,
     vector <LoopTableEntry> middle;
     middle = table[nAminoAcids]->getNClosest(tmpEnd, num, nAminoAcids);
 
-    // define the origin:
-    LoopTableEntry origin;
-    origin.endDirection = refNull;
-
     for (unsigned int i = 0; i < middle.size(); i++) {
         middle[i].endPoint = middle[i].midPoint;
         middle[i].endDirection = middle[i].midDirection;
         middle[i].endNormal = middle[i].midNormal;
-
-        // ... & conquer:
-
-        for (unsigned int j = 0; j < depth; j++) {
-            ringClosure(origin, middle[i], 1, midAminoAcids, offsetPhi + phi,
-                    vt, partialSolution, j);
-            ringClosure(middle[i], tmpEnd, midAminoAcids + 1, (nAminoAcids / 2),
-                    0, vt, partialSolution, j);
-        }
     }
+
+    // ... & conquer, each middle and alternative into its own buffer:
+    vector<unsigned int> seed;
+    if (numThreads != 1)
+        for (unsigned int n = 0; n < middle.size() * depth; n++)
+            seed.push_back(rand());
+    vector<vector<vgVector3<float> > > taskSolution(middle.size() * depth);
+    RingClosureTask task(*this, middle, tmpEnd, midAminoAcids, nAminoAcids,
+            offsetPhi + phi, vt, depth, seed, taskSolution);
+    runParallel(task, taskSolution.size(), numThreads);
+
+    for (unsigned int n = 0; n < taskSolution.size(); n++)
+        partialSolution.insert(partialSolution.end(), taskSolution[n].begin(),
+            taskSolution[n].end());
     return 0;
 }
 
@@ -1772,13 +1875,16 @@ LoopModel::calculateLoop(const vgVector3<float>& startN, unsigned int length,
     if (length != typeVec.size())
         ERROR("typeVec does not match number of aminoacids.", exception);
 
+    // the spacers are built in place, growing result would copy them
+    result.reserve(num);
     for (unsigned int i = 0; i < num; i++) {
         // determine rough ''quality'' of loop to store in B-factors:
         double bfac = 50.0;
 
         unsigned int offset = i * (length * 3);
 
-        Spacer sp;
+        result.push_back(Spacer());
+        Spacer& sp = result.back();
 
         sp.setType("Loop Model");
 
@@ -1816,8 +1922,6 @@ LoopModel::calculateLoop(const vgVector3<float>& startN, unsigned int length,
             sp.insertComponent(aa);
             prev = aa;
         }
-
-        result.push_back(sp);
     }
 
     return result;
@@ -1826,7 +1930,10 @@ LoopModel::calculateLoop(const vgVector3<float>& startN, unsigned int length,
 
 
 /**
- * Load tables which are really used.
+ * Load tables which are really used, and select their search mode for the
+ * current number of threads: with one thread getNClosest() moves short
+ * loops in the tables, with several threads the tables stay fixed so that
+ * they can be searched concurrently.
  * @param nAmino
  */
 void
@@ -1858,13 +1965,16 @@ LoopModel::loadTables(unsigned int nAmino) {
             LoopTable* lt = new LoopTable;
             lt->read(tableFileName[index[i]]);
 
-            VectorTransformation vt;
-
-            for (unsigned int j = 0; j < lt->size(); j++)
-                (*lt)[j].rotateIntoXYPlane(vt);
+            // tables converted with loopTableConvert are already rotated
+            if (!lt->isRotated())
+                lt->rotateIntoXYPlane();
 
             table[index[i]] = lt;
         }
+
+    for (unsigned int i = 0; i < table.size(); i++)
+        if (table[i] != NULL)
+            table[i]->prepareSearch(numThreads != 1);
 }
 
 void
@@ -29,6 +29,7 @@
 #include <ranking_helper2.h>
 #include <SolvationPotential.h>
 #include <RapdfPotential.h>
+#include <RapdfSegmentEnergy.h>
 #include <PhiPsi.h>
 #include <ctype.h>
 using namespace Victor;
@@ -38,6 +39,7 @@ using namespace Victor::Energy;
 namespace Victor { namespace Lobo {
 
     // Global constants, typedefs, etc. (to avoid):
+    class RingClosureTask;
 
     class LoopModel {
     public:
@@ -89,6 +91,11 @@ namespace Victor { namespace Lobo {
                 unsigned int index2, Spacer& sp2);
 
         double getENDRMS_WEIGHT(unsigned int len = 0);
+
+        unsigned int getNumThreads() const {
+            return numThreads;
+        }
+
         void saveENDRMS_WEIGHT(ostream& output);
 
         static string getSCWRLConservedSequence(const Spacer& sp,
@@ -125,6 +132,11 @@ namespace Victor { namespace Lobo {
             pScatter = _sc;
         }
 
+        /// threads used for ring closure (0 = all processors)
+        void setNumThreads(unsigned int n) {
+            numThreads = n;
+        }
+
         void releaseTables(unsigned int index = 0); // releases memory occupied by loop tables
         void setTableFileName(string basename, string ending = ".lt");
         void setTableFileName(vector<string>& _tFN);
@@ -187,6 +199,8 @@ namespace Victor { namespace Lobo {
         static PhiPsi tor;
 
     protected:
+        friend class RingClosureTask;
+
         // HELPERS: 
         // converts the input coords to something processable:
         void convertCoords(AminoAcid start, vgVector3<float> startN, AminoAcid end,
@@ -219,6 +233,8 @@ namespace Victor { namespace Lobo {
         void pAminoAcidSetup(AminoAcid* aa, string type, double bfac = 90.0);
         void pSetSideChain(AminoAcid& aa);
         double pCalculateLoopRms(Spacer& sp1, Spacer& sp2);
+        double pCalculateRms(const Spacer& sp, unsigned int index1,
+                unsigned int index2, const RapdfSegmentEnergy& seg);
 
         int loop_loop_vdw(Spacer& sp, unsigned int index1);
         int loop_spacer_vdw(Spacer& loop, unsigned int index1, unsigned int index2,
@@ -236,6 +252,7 @@ namespace Victor { namespace Lobo {
         vector<LoopTable*> table;
         vector<string> tableFileName;
         vector<vgVector3<float> > solution;
+        unsigned int numThreads; // threads used by ringClosureBase()
         static unsigned int MAX_CHAIN_LENGTH;
         static double BOND_ANGLE_N_TO_CB;
         static double BOND_ANGLE_CB_TO_C;
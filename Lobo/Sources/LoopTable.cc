@@ -20,6 +20,7 @@
 #include <LoopTableEntry.h>
 #include <IntCoordConverter.h>
 #include <VectorTransformation.h>
+#include <cstring>
 
 // Global constants, typedefs, etc. (to avoid):
 
@@ -29,10 +30,13 @@ using namespace Victor::Biopool;
 
 unsigned int LoopTable::MAX_BINS = 128;
 unsigned int LoopTable::MAX_FACTOR = 5; // ie. applied as / MAX_FACTOR 
+bool LoopTable::USE_KD_TREE = false;
 double LoopTable::BOND_ANGLE_AT_CPRIME_TO_N = 112.7;
 
 double LoopTable::BOND_LENGTH_N_TO_CALPHA = 1.46;
 double LoopTable::BOND_ANGLE_AT_N_TO_CALPHA = 121.0;
+const char LoopTable::MAPPED_MAGIC[8] = "VLOOPTB";
+const unsigned int LoopTable::MAPPED_VERSION = 1;
 
 const double SIM_WEIGTH = 0.0001;
 
@@ -61,7 +65,9 @@ static double sDistance(vgVector3<float> xv, vgVector3<float> yv) {
  *@Description basic constructor
  */
 LoopTable::LoopTable() : rama(NULL), nAminoAcid(1), lowerLimit(1000.0),
-upperLimit(-1000.0), stepLimit(0), nextIndex(0), stepWidth(1) {
+upperLimit(-1000.0), stepLimit(0), mapped(NULL), mappedEntry(NULL),
+mappedBin(NULL), rotated(false), kdTree(NULL), searchOnly(false),
+nextIndex(0), stepWidth(1) {
     vgVector3<float> tmp(1000, 1000, 1000);
     for (unsigned int i = 0; i < 6; i++) {
         max[i] = -tmp;
@@ -82,7 +88,8 @@ upperLimit(-1000.0), stepLimit(0), nextIndex(0), stepWidth(1) {
  *@Description constructor base from the copy of another object
  *@param reference to the original object (const LoopTable&)
  */
-LoopTable::LoopTable(const LoopTable& orig) {
+LoopTable::LoopTable(const LoopTable& orig) : mapped(NULL), kdTree(NULL),
+searchOnly(false) {
     this->copy(orig);
 }
 
@@ -91,6 +98,8 @@ LoopTable::LoopTable(const LoopTable& orig) {
  */
 LoopTable::~LoopTable() {
     PRINT_NAME;
+    delete kdTree;
+    delete mapped;
 }
 
 
@@ -102,7 +111,7 @@ LoopTable::~LoopTable() {
  */
 void LoopTable::showDistribution() {
     for (unsigned int i = 0; i < entry.size(); i++) {
-        cout << " " << entry[i].size() << "\t";
+        cout << " " << pBinSize(i) << "\t";
         if ((i + 1) % 5 == 0)
             cout << "\n";
     }
@@ -119,6 +128,15 @@ LoopTableEntry LoopTable::getClosest(const LoopTableEntry& dest,
         unsigned int currentSelection) {
     PRECOND((entry.size() > 0), exception);
 
+    if (USE_KD_TREE) {
+        vector<solutionQueueElem> best;
+        pGetKdTree().getNClosest(dest, currentSelection + 1, nAminoAcid, best);
+        if (best.size() == 0)
+            ERROR("No valid entries found.", exception);
+        unsigned int k = (best.size() > currentSelection) ? currentSelection : 0;
+        return entry[best[k].index1][best[k].index2];
+    }
+
     priority_queue<solutionQueueElem> solutionQueue;
     unsigned int index = pGetBin(dest.endPoint);
     unsigned int max = size() / MAX_FACTOR;
@@ -142,7 +160,10 @@ LoopTableEntry LoopTable::getClosest(const LoopTableEntry& dest,
 }
 
 /**
- *@Description Gets the closest N 
+ *@Description Gets the closest N. For short loops (nAmino <= 5) the entries
+ *    are moved onto the destination: in the table itself with the binned
+ *    search, which later searches then see, or only in the returned copies
+ *    with USE_KD_TREE and after prepareSearch(), which need a fixed table.
  *@param  reference to the table( LoopTableEntry&), value of N(unsigned int ), number of amino acids (unsigned int )
  *@return  vector containing the loop entry tables(vector<LoopTableEntry> )
  */
@@ -150,44 +171,54 @@ vector<LoopTableEntry> LoopTable::getNClosest(const LoopTableEntry& dest, unsign
         unsigned int nAmino) {
     PRECOND((entry.size() > 0), exception);
 
-    vector<LoopTableEntry> result;
-    priority_queue<solutionQueueElem> solutionQueue;
-    unsigned int index = pGetBin(dest.endPoint);
-    unsigned int max = size() / MAX_FACTOR;
+    vector<solutionQueueElem> best;
 
-    pAddToSolutionQueue(index, solutionQueue, dest);
+    if (USE_KD_TREE)
+        pGetKdTree().getNClosest(dest, num, nAminoAcid, best);
+    else {
+        priority_queue<solutionQueueElem> solutionQueue;
+        unsigned int index = pGetBin(dest.endPoint);
+        unsigned int max = size() / MAX_FACTOR;
 
-    unsigned int offset = 0;
-    while ((solutionQueue.size() < max) || (offset > MAX_BINS / 2)) {
-        offset++;
-        if (index >= offset)
-            pAddToSolutionQueue(index - offset, solutionQueue, dest);
-        if (index + offset < MAX_BINS)
-            pAddToSolutionQueue(index + offset, solutionQueue, dest);
+        pAddToSolutionQueue(index, solutionQueue, dest);
+
+        unsigned int offset = 0;
+        while ((solutionQueue.size() < max) || (offset > MAX_BINS / 2)) {
+            offset++;
+            if (index >= offset)
+                pAddToSolutionQueue(index - offset, solutionQueue, dest);
+            if (index + offset < MAX_BINS)
+                pAddToSolutionQueue(index + offset, solutionQueue, dest);
+        }
+
+        while ((solutionQueue.size() > 0) && (best.size() < num)) {
+            best.push_back(solutionQueue.top());
+            solutionQueue.pop();
+        }
     }
 
-    if (solutionQueue.size() == 0)
+    if (best.size() == 0)
         ERROR("No valid entries found.", exception);
 
-    double maxDev = 20 * solutionQueue.top().dev;
+    vector<LoopTableEntry> result;
+    double maxDev = 20 * best[0].dev;
 
-    while ((solutionQueue.size() > 0) && (result.size() < num)) {
-        if (solutionQueue.top().dev > maxDev)
+    for (unsigned int i = 0; i < best.size(); i++) {
+        if (best[i].dev > maxDev)
             break;
 
+        LoopTableEntry& closest = entry[best[i].index1][best[i].index2];
+        result.push_back(closest);
 
         if (nAmino <= 5) {
-            vgVector3<float> offsetEP = dest.endPoint -
-                    entry[solutionQueue.top().index1][solutionQueue.top().index2].endPoint;
-            entry[solutionQueue.top().index1][solutionQueue.top().index2].midPoint
-                    += (offsetEP / 2);
-            entry[solutionQueue.top().index1][solutionQueue.top().index2].endPoint
-                    = dest.endPoint;
+            vgVector3<float> offsetEP = dest.endPoint - closest.endPoint;
+            result.back().midPoint += (offsetEP / 2);
+            result.back().endPoint = dest.endPoint;
+            if (!USE_KD_TREE && !searchOnly) {
+                closest = result.back();
+                pInvalidateKdTree();
+            }
         }
-
-        result.push_back(entry[solutionQueue.top().index1]
-                [solutionQueue.top().index2]);
-        solutionQueue.pop();
     }
 
     return result;
@@ -207,6 +238,13 @@ void LoopTable::copy(const LoopTable& orig) {
     rama = orig.rama;
     nAminoAcid = orig.nAminoAcid;
 
+    pInvalidateKdTree();
+    delete mapped;
+    mapped = NULL;
+    binLoaded.clear();
+    orig.pLoadAll();
+    rotated = orig.rotated;
+
     entry.clear();
     entry.resize(orig.entry.size());
     for (unsigned int i = 0; i < orig.entry.size(); i++)
@@ -220,6 +258,7 @@ void LoopTable::copy(const LoopTable& orig) {
     min = orig.min;
     max = orig.max;
     psiNormal = orig.psiNormal;
+    searchOnly = orig.searchOnly;
     nextIndex = orig.nextIndex;
     stepWidth = orig.stepWidth;
 }
@@ -230,6 +269,8 @@ void LoopTable::copy(const LoopTable& orig) {
  *@return   changes are made internally(void)
  */
 void LoopTable::setToSingleAminoAcid() {
+    pReleaseMapping();
+    pInvalidateKdTree();
     nAminoAcid = 1;
     LoopTableEntry tmpEntry;
     tmpEntry.setToSingleAminoAcid();
@@ -246,6 +287,9 @@ void LoopTable::setToSingleAminoAcid() {
  */
 void LoopTable::concatenate(LoopTable& src1, LoopTable& src2,
         unsigned long nSrc1, unsigned long nSrc2) {
+    pReleaseMapping();
+    pInvalidateKdTree();
+    rotated = false;
     src1.initOccurrence(nSrc1);
 
     // nSrc1 statistical cases of src1:
@@ -274,6 +318,8 @@ void LoopTable::concatenate(LoopTable& src1, LoopTable& src2,
  *@return   changes are made internally(void)
  */
 void LoopTable::adjustTable() { // adjusts the internal hash table 
+    pReleaseMapping();
+    pInvalidateKdTree();
 
     vector<vector<LoopTableEntry> > tmpEntry;
     tmpEntry.resize(MAX_BINS);
@@ -290,7 +336,8 @@ void LoopTable::adjustTable() { // adjusts the internal hash table
 }
 
 /**
- *@Description Reads the table contents from a file.
+ *@Description Reads the table contents from a file, either in the compressed
+ *    format or in the binary format written by writeMapped().
  *@param  reference to the file name(const string&)
  *@return   changes are made internally(void)
  */
@@ -302,6 +349,22 @@ void LoopTable::read(const string& filename) {
         ERROR("Table data file " + filename + " not found.", exception);
     }
 
+    pInvalidateKdTree();
+    delete mapped;
+    mapped = NULL;
+    binLoaded.clear();
+    rotated = false;
+
+    char magic[sizeof (MAPPED_MAGIC)];
+    if (is.read(magic, sizeof (magic))
+            && (memcmp(magic, MAPPED_MAGIC, sizeof (magic)) == 0)) {
+        is.close();
+        pReadMapped(filename);
+        return;
+    }
+    is.clear();
+    is.seekg(0);
+
     // first read the global table parameters
     is.read((char*) &nAminoAcid, sizeof (unsigned int));
 
@@ -329,14 +392,19 @@ void LoopTable::read(const string& filename) {
     is.read((char*) &upperLimit, sizeof (double));
     stepLimit = (upperLimit - lowerLimit) / (nBins - 1);
 
-    // then read the max and min values:
+    // then read the max and min values, each float in a double wide field:
+    char field[sizeof (double)];
     for (unsigned int i = 0; i < 6; i++)
-        for (unsigned int j = 0; j < 3; j++)
-            is.read((char*) &max[i][j], sizeof (double));
+        for (unsigned int j = 0; j < 3; j++) {
+            is.read(field, sizeof (double));
+            memcpy(&max[i][j], field, sizeof (float));
+        }
 
     for (unsigned int i = 0; i < 6; i++)
-        for (unsigned int j = 0; j < 3; j++)
-            is.read((char*) &min[i][j], sizeof (double));
+        for (unsigned int j = 0; j < 3; j++) {
+            is.read(field, sizeof (double));
+            memcpy(&min[i][j], field, sizeof (float));
+        }
 
     // load the complete table into the heap because it's faster
     CompressedLoopTableEntry* compTable = new CompressedLoopTableEntry[nEntry];
@@ -355,8 +423,8 @@ void LoopTable::read(const string& filename) {
         }
     }
 
-    delete tmpBin;
-    delete compTable;
+    delete [] tmpBin;
+    delete [] compTable;
     is.close();
 }
 
@@ -366,6 +434,8 @@ void LoopTable::read(const string& filename) {
  *@return   changes are made internally(void)
  */
 void LoopTable::cluster(double cutoff) {
+    pReleaseMapping();
+    pInvalidateKdTree();
 
     if (entry.size() == 0)
         return;
@@ -409,6 +479,7 @@ void LoopTable::write(const string& filename) {
     ofstream os(filename.c_str(), ios::out | ios::binary);
 
     PRECOND(os, exception);
+    pLoadAll();
 
     // first write the global table parameters:
     os.write((char*) &nAminoAcid, sizeof (unsigned int));
@@ -424,13 +495,20 @@ void LoopTable::write(const string& filename) {
     os.write((char*) &lowerLimit, sizeof (double));
     os.write((char*) &upperLimit, sizeof (double));
 
+    // max and min are floats, each stored in a double wide field:
+    char field[sizeof (double)];
+    memset(field, 0, sizeof (double));
     for (unsigned int i = 0; i < 6; i++)
-        for (unsigned int j = 0; j < 3; j++)
-            os.write((char*) &max[i][j], sizeof (double));
+        for (unsigned int j = 0; j < 3; j++) {
+            memcpy(field, &max[i][j], sizeof (float));
+            os.write(field, sizeof (double));
+        }
 
     for (unsigned int i = 0; i < 6; i++)
-        for (unsigned int j = 0; j < 3; j++)
-            os.write((char*) &min[i][j], sizeof (double));
+        for (unsigned int j = 0; j < 3; j++) {
+            memcpy(field, &min[i][j], sizeof (float));
+            os.write(field, sizeof (double));
+        }
 
     // next write the table itself, compressing it on the fly:
 
@@ -447,6 +525,88 @@ void LoopTable::write(const string& filename) {
     os.close();
 }
 
+/**
+ *@Description Writes the table contents to file in the binary format, which
+ *    read() maps into memory and decodes lazily, bin by bin.
+ *@param  reference to the file name(const string& )
+ *@return   changes are made internally(void)
+ */
+void LoopTable::writeMapped(const string& filename) {
+    ofstream os(filename.c_str(), ios::out | ios::binary);
+    if (!os)
+        ERROR("LoopTable::writeMapped() : could not open " + filename, exception);
+    pLoadAll();
+
+    MappedLoopTableHeader header;
+    memset(&header, 0, sizeof (header));
+    memcpy(header.magic, MAPPED_MAGIC, sizeof (MAPPED_MAGIC));
+    header.version = MAPPED_VERSION;
+    header.nAminoAcid = nAminoAcid;
+    header.nBins = entry.size();
+    header.rotated = rotated;
+    header.lowerLimit = lowerLimit;
+    header.upperLimit = upperLimit;
+    for (unsigned int i = 0; i < 6; i++)
+        for (unsigned int j = 0; j < 3; j++) {
+            header.min[3 * i + j] = min[i][j];
+            header.max[3 * i + j] = max[i][j];
+        }
+    os.write((char*) &header, sizeof (header));
+
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i <= entry.size(); i++) {
+        os.write((char*) &offset, sizeof (unsigned int));
+        if (i < entry.size())
+            offset += entry[i].size();
+    }
+
+    for (unsigned int index = 0; index < entry.size(); index++)
+        for (unsigned int i = 0; i < entry[index].size(); i++)
+            for (unsigned int j = 0; j < 6; j++)
+                os.write((char*) &(entry[index][i])[j].x, 3 * sizeof (float));
+
+    os.close();
+    if (!os)
+        ERROR("LoopTable::writeMapped() : could not write " + filename, exception);
+}
+
+/**
+ *@Description Rotates every entry into the XY plane, as required by the
+ *    ring closure of LoopModel. Tables saved after rotation need no
+ *    further processing when loaded.
+ *@param  none
+ *@return   changes are made internally(void)
+ */
+void LoopTable::rotateIntoXYPlane() {
+    pReleaseMapping();
+    pInvalidateKdTree();
+    for (unsigned int i = 0; i < entry.size(); i++)
+        for (unsigned int j = 0; j < entry[i].size(); j++) {
+            VectorTransformation vt;
+            entry[i][j].rotateIntoXYPlane(vt);
+        }
+    rotated = true;
+}
+
+/**
+ *@Description Selects the search mode. With fixed set, decodes all bins and
+ *    builds the search index, if selected. Afterwards getClosest() and
+ *    getNClosest() only read the table, short loops being moved in the
+ *    returned entries only, and can be called from several threads at
+ *    once. With fixed unset, getNClosest() moves short loops in the table
+ *    again (the default).
+ *@param  fixed table search (bool)
+ *@return   changes are made internally(void)
+ */
+void LoopTable::prepareSearch(bool fixed) {
+    if (fixed) {
+        pLoadAll();
+        if (USE_KD_TREE)
+            pGetKdTree();
+    }
+    searchOnly = fixed;
+}
+
 /**
  *@Description Writes the table contents to file in ASCII format.
 //    (Useful for viewing with GNU Plot)
@@ -505,6 +665,111 @@ LoopTable& LoopTable::operator=(const LoopTable& orig) {
 
 // HELPERS:
 
+/**
+ *@Description Maps a table in the binary format. Only the header is
+ *    checked here, bins are decoded by pLoadBin() when first used.
+ *@param  reference to the file name(const string&)
+ *@return   changes are made internally(void)
+ */
+void LoopTable::pReadMapped(const string& filename) {
+    mapped = new MappedFile;
+    if (!mapped->open(filename))
+        ERROR("Table data file " + filename + " could not be mapped.", exception);
+
+    if (mapped->size() < sizeof (MappedLoopTableHeader))
+        ERROR("LoopTable::read() : truncated table " + filename, exception);
+    const MappedLoopTableHeader* header =
+            reinterpret_cast<const MappedLoopTableHeader*> (mapped->getData());
+    if (header->version != MAPPED_VERSION)
+        ERROR("LoopTable::read() : unsupported table version in " + filename,
+            exception);
+    if (header->nBins != MAX_BINS)
+        ERROR("LoopTable::read() : nBins out of scope.", exception);
+
+    size_t entryStart = sizeof (MappedLoopTableHeader)
+            + (MAX_BINS + 1) * sizeof (unsigned int);
+    if (mapped->size() < entryStart)
+        ERROR("LoopTable::read() : truncated table " + filename, exception);
+    mappedBin = reinterpret_cast<const unsigned int*> (mapped->getData()
+            + sizeof (MappedLoopTableHeader));
+    mappedEntry = reinterpret_cast<const float*> (mappedBin + MAX_BINS + 1);
+
+    // bin offsets must start at 0, never decrease and end within the file
+    if (mappedBin[0] != 0)
+        ERROR("LoopTable::read() : corrupt bin offsets in " + filename,
+            exception);
+    for (unsigned int i = 0; i < MAX_BINS; i++)
+        if (mappedBin[i + 1] < mappedBin[i])
+            ERROR("LoopTable::read() : corrupt bin offsets in " + filename,
+                exception);
+    if ((mapped->size() - entryStart) / (18 * sizeof (float))
+            < static_cast<size_t> (mappedBin[MAX_BINS]))
+        ERROR("LoopTable::read() : truncated table " + filename, exception);
+
+    nAminoAcid = header->nAminoAcid;
+    rotated = (header->rotated != 0);
+    lowerLimit = header->lowerLimit;
+    upperLimit = header->upperLimit;
+    stepLimit = (upperLimit - lowerLimit) / (MAX_BINS - 1);
+    for (unsigned int i = 0; i < 6; i++)
+        for (unsigned int j = 0; j < 3; j++) {
+            min[i][j] = header->min[3 * i + j];
+            max[i][j] = header->max[3 * i + j];
+        }
+
+    entry.clear();
+    entry.resize(MAX_BINS);
+    binLoaded.assign(MAX_BINS, false);
+}
+
+/**
+ *@Description Returns the k-d tree over the table, building it if needed.
+ *@param  none
+ *@return  reference to the tree(const LoopTableKdTree&)
+ */
+const LoopTableKdTree& LoopTable::pGetKdTree() {
+    if (kdTree == NULL) {
+        pLoadAll();
+        kdTree = new LoopTableKdTree(entry);
+    }
+    return *kdTree;
+}
+
+/**
+ *@Description Discards the k-d tree, before the table is modified.
+ *@param  none
+ *@return   changes are made internally(void)
+ */
+void LoopTable::pInvalidateKdTree() {
+    delete kdTree;
+    kdTree = NULL;
+}
+
+/**
+ *@Description Decodes all bins of a mapped table.
+ *@param  none
+ *@return   changes are made internally(void)
+ */
+void LoopTable::pLoadAll() const {
+    for (unsigned int i = 0; (mapped != NULL) && (i < entry.size()); i++)
+        pLoadBin(i);
+}
+
+/**
+ *@Description Decodes all bins and releases the mapped file, before the
+ *    table is modified.
+ *@param  none
+ *@return   changes are made internally(void)
+ */
+void LoopTable::pReleaseMapping() {
+    if (mapped == NULL)
+        return;
+    pLoadAll();
+    delete mapped;
+    mapped = NULL;
+    binLoaded.clear();
+}
+
 /**
  *@Description calculates the esptimate similarity cutoff
  *@param reference to the loop table entry (const LoopTableEntry& ),value to consider (unsigned int)
@@ -533,6 +798,7 @@ double LoopTable::pEstimateSimilarityCutoff(const LoopTableEntry& le,
  *@return   changes are made internally(void)
  */
 void LoopTable::store(const LoopTableEntry& src) {
+    pInvalidateKdTree();
     entry[0].push_back(src);
 
     double tmp = sqrt(sqr(src.endPoint.x)
@@ -25,6 +25,8 @@
 #include <Debug.h>
 #include <RamachandranData.h>
 #include <LoopTableEntry.h>
+#include <LoopTableKdTree.h>
+#include <MappedFile.h>
 #include <queue>
 using namespace Victor;
 using namespace Victor::Lobo;
@@ -45,10 +47,35 @@ namespace Victor { namespace Lobo {
         }
     };
 
+    /**@brief  Header of the binary (memory mapped) loop table format.
+     * 
+     *@Description The header is followed by nBins + 1 bin offsets (unsigned int)
+     *      and then by the entries, bin by bin, each as 18 floats in the
+     *      order of LoopTableEntry::operator[]. All values are stored
+     *      uncompressed in native byte order.
+     * */
+    struct MappedLoopTableHeader {
+        char magic[8]; // MAPPED_MAGIC
+        unsigned int version; // MAPPED_VERSION
+        unsigned int nAminoAcid;
+        unsigned int nBins;
+        unsigned int rotated; // entries already rotated into the XY plane
+        double lowerLimit;
+        double upperLimit;
+        float min[18];
+        float max[18];
+    };
+
     /**
      * @brief  Defines a table of possible amino chain end points and end directions 
      *  after k amino acids have been concatenated. 
      * 
+     *@Description Tables are read either from the compressed format written
+     *      by write() or from the binary format written by writeMapped().
+     *      The latter is memory mapped and its bins are only decoded when
+     *      first used.
+     *      Closest entries are searched either in the bins around the
+     *      destination, or with USE_KD_TREE exactly over the whole table.
      * */
     class LoopTable {
     public:
@@ -65,6 +92,8 @@ namespace Victor { namespace Lobo {
         virtual unsigned int size();
         unsigned int getLength();
         unsigned int getMaxBins();
+        bool isMapped();
+        bool isRotated();
         void showDistribution();
         virtual LoopTableEntry getClosest(const LoopTableEntry& le,
                 unsigned int currentSelection = 1);
@@ -88,6 +117,9 @@ namespace Victor { namespace Lobo {
         virtual void read(const string&);
         virtual void cluster(double cutoff);
         virtual void write(const string&);
+        void writeMapped(const string&);
+        void rotateIntoXYPlane();
+        void prepareSearch(bool fixed = true);
         void writeASCII(const string&, unsigned long num = 0,
                 unsigned int wEntry = 0, unsigned int wDim = 0);
 
@@ -101,6 +133,7 @@ namespace Victor { namespace Lobo {
         void printTable(unsigned int);
 
         static unsigned int MAX_FACTOR;
+        static bool USE_KD_TREE; // exact k-d tree search in getClosest()
 
     protected:
 
@@ -109,6 +142,13 @@ namespace Victor { namespace Lobo {
                 unsigned int num);
 
         virtual void store(const LoopTableEntry&);
+        void pReadMapped(const string& filename);
+        void pReleaseMapping();
+        void pLoadBin(unsigned int bin) const;
+        void pLoadAll() const;
+        unsigned int pBinSize(unsigned int bin) const;
+        const LoopTableKdTree& pGetKdTree();
+        void pInvalidateKdTree();
         void pInsertElem(LoopTableEntry& elem,
                 vector<vector<LoopTableEntry> >& table);
         unsigned int pGetBin(const vgVector3<float>& e);
@@ -134,8 +174,17 @@ namespace Victor { namespace Lobo {
         unsigned int nAminoAcid;
         
 
-        // table of (sorted) bins containing the chain information
-        vector<vector<LoopTableEntry> > entry;
+        // table of (sorted) bins containing the chain information;
+        // bins of a mapped table are decoded on first use
+        mutable vector<vector<LoopTableEntry> > entry;
+
+        MappedFile* mapped; // binary table file, NULL if fully in memory
+        const float* mappedEntry; // first value of the mapped entries
+        const unsigned int* mappedBin; // nBins + 1 offsets into mappedEntry
+        mutable vector<bool> binLoaded; // bins already decoded into entry
+        bool rotated; // entries already rotated into the XY plane
+        LoopTableKdTree* kdTree; // built on first use, NULL if outdated
+        bool searchOnly; // set by prepareSearch(), getNClosest() leaves entries
         
 
         double lowerLimit; // information about the lower and 
@@ -151,6 +200,8 @@ namespace Victor { namespace Lobo {
         unsigned long stepWidth; // next occurrence
 
         static unsigned int MAX_BINS;
+        static const char MAPPED_MAGIC[8];
+        static const unsigned int MAPPED_VERSION;
         static double BOND_ANGLE_AT_CPRIME_TO_N;
         static double BOND_LENGTH_N_TO_CALPHA;
         static double BOND_ANGLE_AT_N_TO_CALPHA;
@@ -199,6 +250,8 @@ namespace Victor { namespace Lobo {
      *@return  corresponding value ( unsigned int)
      */
     inline unsigned int LoopTable::size() {
+        if (mapped != NULL)
+            return mappedBin[entry.size()];
         unsigned int count = 0;
         for (unsigned int i = 0; i < entry.size(); i++)
             count += entry[i].size();
@@ -223,6 +276,24 @@ namespace Victor { namespace Lobo {
         return MAX_BINS;
     }
 
+    /**
+     *@Description returns whether the table is read from a memory mapped file
+     *@param  none
+     *@return  corresponding value ( bool)
+     */
+    inline bool LoopTable::isMapped() {
+        return mapped != NULL;
+    }
+
+    /**
+     *@Description returns whether the entries were rotated into the XY plane
+     *@param  none
+     *@return  corresponding value ( bool)
+     */
+    inline bool LoopTable::isRotated() {
+        return rotated;
+    }
+
     // MODIFIERS:
 
     /**
@@ -254,8 +325,8 @@ namespace Victor { namespace Lobo {
 
         unsigned int count = MAX_BINS + 1;
         for (unsigned int i = 0; i < entry.size(); i++) {
-            if (n >= entry[i].size())
-                n -= entry[i].size();
+            if (n >= pBinSize(i))
+                n -= pBinSize(i);
             else {
                 count = i;
                 break;
@@ -265,6 +336,7 @@ namespace Victor { namespace Lobo {
         if ((count >= MAX_BINS + 1) || (entry.size() == 0))
             ERROR("LoopTable::operator[] : Argument out of scope.", exception);
 
+        pLoadBin(count);
         return entry[count][n];
     }
     /**
@@ -275,8 +347,8 @@ namespace Victor { namespace Lobo {
     inline const LoopTableEntry& LoopTable::operator[](unsigned int n) const {
         unsigned int count = MAX_BINS + 1;
         for (unsigned int i = 0; i < entry.size(); i++) {
-            if (n >= entry[i].size())
-                n -= entry[i].size();
+            if (n >= pBinSize(i))
+                n -= pBinSize(i);
             else {
                 count = i;
                 break;
@@ -284,6 +356,7 @@ namespace Victor { namespace Lobo {
         }
         if ((count >= MAX_BINS + 1) || (entry.size() == 0))
             ERROR("LoopTable::operator[] : Argument out of scope.", exception);
+        pLoadBin(count);
         return entry[count][n];
     }
 
@@ -318,6 +391,35 @@ namespace Victor { namespace Lobo {
         return static_cast<unsigned int> ((dist - lowerLimit) / stepLimit);
     }
 
+    /**
+     *@Description returns the number of entries in a bin, decoded or not
+     *@param  bin index(unsigned int)
+     *@return  corresponding value( unsigned int)
+     */
+    inline unsigned int LoopTable::pBinSize(unsigned int bin) const {
+        if (mapped != NULL)
+            return mappedBin[bin + 1] - mappedBin[bin];
+        return entry[bin].size();
+    }
+
+    /**
+     *@Description decodes a bin of a mapped table, if not done yet
+     *@param  bin index(unsigned int)
+     *@return   changes are made internally(void)
+     */
+    inline void LoopTable::pLoadBin(unsigned int bin) const {
+        if ((mapped == NULL) || (binLoaded[bin]))
+            return;
+        unsigned int n = mappedBin[bin + 1] - mappedBin[bin];
+        const float* src = mappedEntry + 18 * mappedBin[bin];
+        entry[bin].resize(n);
+        for (unsigned int i = 0; i < n; i++)
+            for (unsigned int j = 0; j < 6; j++)
+                for (unsigned int k = 0; k < 3; k++)
+                    entry[bin][i][j][k] = *src++;
+        binLoaded[bin] = true;
+    }
+
     /**
      *@Description Adds the data into the solution queue
      *@param  offset(unsigned int),reference to the solutions 
@@ -326,6 +428,7 @@ namespace Victor { namespace Lobo {
      */
     inline void LoopTable::pAddToSolutionQueue(unsigned int offset,
             priority_queue<solutionQueueElem>& solutionQueue, const LoopTableEntry& dest) {
+        pLoadBin(offset);
         solutionQueueElem sqe;
         for (unsigned int i = 0; i < entry[offset].size(); i++) {
             sqe.dev = entry[offset][i].calculateDeviation(dest, nAminoAcid);
@@ -350,8 +350,15 @@ namespace Victor { namespace Lobo {
      *@return  corresponding value
      */
     float LoopTableEntry::rotateIntoXYPlane(VectorTransformation& vt) {
-        double angle = -acos(endPoint.x
-                / sqrt(endPoint.x * endPoint.x + endPoint.z * endPoint.z));
+        float cosAngle = endPoint.x
+                / sqrt(endPoint.x * endPoint.x + endPoint.z * endPoint.z);
+
+        // rounding may leave |cos| just above 1 for z close to 0 (acos: nan)
+        if (cosAngle > 1.0)
+            cosAngle = 1.0;
+        else if (cosAngle < -1.0)
+            cosAngle = -1.0;
+        double angle = -acos(cosAngle);
 
         // NB: this formula is correct (!) because we are using the y-axis as normal
         // the problem is hence reduced to the 2-D case of rotating (x,z) to (x,0)
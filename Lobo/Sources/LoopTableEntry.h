@@ -22,6 +22,7 @@
 #include <vector3.h>
 #include <matrix3.h>
 #include <Debug.h>
+#include <ThreadTools.h>
 using namespace Victor;
 using namespace Victor::Lobo;
 using namespace Victor::Biopool; 
@@ -181,7 +182,7 @@ namespace Victor { namespace Lobo {
     inline double LoopTableEntry::pGetRand() {
         double tmp = 0.0;
         for (unsigned int i = 0; i < 12; i++)
-            tmp += static_cast<double> (rand()) / RAND_MAX;
+            tmp += static_cast<double> (threadRand()) / RAND_MAX;
 
         return tmp - 6;
     }
@@ -0,0 +1,261 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+// Includes:
+#include <LoopTableKdTree.h>
+#include <LoopTable.h>
+#include <algorithm>
+#include <cstring>
+
+// Global constants, typedefs, etc. (to avoid):
+
+using namespace Victor;
+using namespace Victor::Lobo;
+
+/// orders points along one dimension
+struct KdCoordLess {
+    const float* coord;
+    unsigned int dim;
+
+    bool operator()(unsigned int a, unsigned int b) const {
+        return coord[LoopTableKdTree::DIM * a + dim]
+                < coord[LoopTableKdTree::DIM * b + dim];
+    }
+};
+
+/// false for NaN and infinity; tests the bits, as -ffast-math drops isnan()
+static bool sIsFinite(float f) {
+    unsigned int bits;
+    memcpy(&bits, &f, sizeof (bits));
+    return (bits & 0x7f800000) != 0x7f800000;
+}
+
+/// orders candidates by deviation, ties by table position
+static bool sDevLess(const solutionQueueElem& a, const solutionQueueElem& b) {
+    if (a.dev != b.dev)
+        return a.dev < b.dev;
+    if (a.index1 != b.index1)
+        return a.index1 < b.index1;
+    return a.index2 < b.index2;
+}
+
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+/**
+ *@Description builds the tree over all entries of a table, leaving out
+ *    degenerate entries with undefined coordinates
+ *@param  table bins (const vector<vector<LoopTableEntry> >&)
+ */
+LoopTableKdTree::LoopTableKdTree(const vector<vector<LoopTableEntry> >& entry)
+: table(entry) {
+    vector<float> tmpCoord;
+    for (unsigned int i = 0; i < entry.size(); i++)
+        for (unsigned int j = 0; j < entry[i].size(); j++) {
+            bool valid = true;
+            for (unsigned int k = 0; k < 3; k++)
+                valid = valid && sIsFinite(entry[i][j].endPoint[k])
+                    && sIsFinite(entry[i][j].endDirection[k])
+                    && sIsFinite(entry[i][j].endNormal[k]);
+            if (!valid)
+                continue;
+
+            for (unsigned int k = 0; k < 3; k++) {
+                tmpCoord.push_back(entry[i][j].endPoint[k]);
+                tmpCoord.push_back(entry[i][j].endDirection[k]);
+                tmpCoord.push_back(entry[i][j].endNormal[k]);
+            }
+            bin.push_back(i);
+            pos.push_back(j);
+        }
+
+    coord.swap(tmpCoord);
+    vector<unsigned int> order(bin.size());
+    for (unsigned int i = 0; i < order.size(); i++)
+        order[i] = i;
+    splitDim.resize(bin.size(), 0);
+    pBuild(0, order.size(), order);
+
+    // store the points in tree order, for locality during searches:
+    vector<float> treeCoord(coord.size());
+    vector<unsigned int> treeBin(bin.size()), treePos(pos.size());
+    for (unsigned int i = 0; i < order.size(); i++) {
+        for (unsigned int k = 0; k < DIM; k++)
+            treeCoord[DIM * i + k] = coord[DIM * order[i] + k];
+        treeBin[i] = bin[order[i]];
+        treePos[i] = pos[order[i]];
+    }
+    coord.swap(treeCoord);
+    bin.swap(treeBin);
+    pos.swap(treePos);
+}
+
+
+// PREDICATES:
+
+/**
+ *@Description Finds the num entries with smallest deviation from dest.
+ *@param  destination(const LoopTableEntry&), number of entries(unsigned int),
+ *      number of amino acids (unsigned int), table positions and deviations
+ *      of the result, sorted by increasing deviation (vector<solutionQueueElem>&)
+ *@return  changes are made to result(void)
+ */
+void LoopTableKdTree::getNClosest(const LoopTableEntry& dest, unsigned int num,
+        unsigned int nAmino, vector<solutionQueueElem>& result) const {
+    result.clear();
+    if ((num == 0) || (size() == 0))
+        return;
+
+    float q[DIM];
+    for (unsigned int k = 0; k < 3; k++) {
+        q[3 * k] = dest.endPoint[k];
+        q[3 * k + 1] = dest.endDirection[k];
+        q[3 * k + 2] = dest.endNormal[k];
+    }
+
+    result.reserve(num);
+    pSearch(0, size(), q, dest, nAmino, num, result);
+    sort(result.begin(), result.end(), sDevLess);
+}
+
+
+// HELPERS:
+
+/**
+ *@Description weight of a dimension in the deviation metric
+ *@param  dimension, interleaved as EP, ED, EN per coordinate(unsigned int)
+ *@return  corresponding value(double)
+ */
+double LoopTableKdTree::pWeight(unsigned int dim) {
+    switch (dim % 3) {
+        case 0: return LoopTableEntry::LAMBDA_EP;
+        case 1: return LoopTableEntry::LAMBDA_ED;
+    }
+    return LoopTableEntry::LAMBDA_EN;
+}
+
+/**
+ *@Description Builds the subtree of points order[lo, hi): the median along
+ *    the dimension of largest weighted spread becomes the node at the
+ *    middle of the range.
+ *@param  range(unsigned int, unsigned int), point permutation(vector<unsigned int>&)
+ *@return   changes are made internally(void)
+ */
+void LoopTableKdTree::pBuild(unsigned int lo, unsigned int hi,
+        vector<unsigned int>& order) {
+    if (hi - lo <= LEAF_SIZE)
+        return;
+
+    float minC[DIM], maxC[DIM];
+    for (unsigned int k = 0; k < DIM; k++)
+        minC[k] = maxC[k] = coord[DIM * order[lo] + k];
+    for (unsigned int i = lo + 1; i < hi; i++)
+        for (unsigned int k = 0; k < DIM; k++) {
+            float c = coord[DIM * order[i] + k];
+            if (c < minC[k])
+                minC[k] = c;
+            else if (c > maxC[k])
+                maxC[k] = c;
+        }
+
+    unsigned int dim = 0;
+    double maxSpread = -1.0;
+    for (unsigned int k = 0; k < DIM; k++) {
+        double spread = pWeight(k) * (maxC[k] - minC[k]) * (maxC[k] - minC[k]);
+        if (spread > maxSpread) {
+            maxSpread = spread;
+            dim = k;
+        }
+    }
+
+    unsigned int mid = (lo + hi) / 2;
+    KdCoordLess less;
+    less.coord = &coord[0];
+    less.dim = dim;
+    nth_element(order.begin() + lo, order.begin() + mid, order.begin() + hi,
+            less);
+    splitDim[mid] = dim;
+
+    pBuild(lo, mid, order);
+    pBuild(mid + 1, hi, order);
+}
+
+/**
+ *@Description Searches the subtree [lo, hi), skipping the far side of a node
+ *    whenever its split plane is farther than the worst candidate so far.
+ *@param  range(unsigned int, unsigned int), query point(const float*),
+ *      destination(const LoopTableEntry&), number of amino acids(unsigned int),
+ *      number of entries(unsigned int), candidates as a max heap
+ *      (vector<solutionQueueElem>&)
+ *@return   changes are made to heap(void)
+ */
+void LoopTableKdTree::pSearch(unsigned int lo, unsigned int hi, const float* q,
+        const LoopTableEntry& dest, unsigned int nAmino, unsigned int num,
+        vector<solutionQueueElem>& heap) const {
+    if (hi - lo <= LEAF_SIZE) {
+        for (unsigned int i = lo; i < hi; i++)
+            pConsider(i, dest, nAmino, num, heap);
+        return;
+    }
+
+    unsigned int mid = (lo + hi) / 2;
+    unsigned int dim = splitDim[mid];
+    double diff = q[dim] - coord[DIM * mid + dim];
+
+    pConsider(mid, dest, nAmino, num, heap);
+
+    unsigned int nearLo = lo, nearHi = mid, farLo = mid + 1, farHi = hi;
+    if (diff >= 0) {
+        nearLo = mid + 1;
+        nearHi = hi;
+        farLo = lo;
+        farHi = mid;
+    }
+
+    pSearch(nearLo, nearHi, q, dest, nAmino, num, heap);
+
+    // small tolerance: the deviation itself is summed in single precision
+    if ((heap.size() < num) || (pWeight(dim) * diff * diff
+            <= heap.front().dev * (1.0 + 1e-5)))
+        pSearch(farLo, farHi, q, dest, nAmino, num, heap);
+}
+
+/**
+ *@Description Adds a point to the candidates if it is among the best num.
+ *@param  point in tree order(unsigned int), destination(const LoopTableEntry&),
+ *      number of amino acids(unsigned int), number of entries(unsigned int),
+ *      candidates as a max heap(vector<solutionQueueElem>&)
+ *@return   changes are made to heap(void)
+ */
+void LoopTableKdTree::pConsider(unsigned int n, const LoopTableEntry& dest,
+        unsigned int nAmino, unsigned int num,
+        vector<solutionQueueElem>& heap) const {
+    solutionQueueElem sqe;
+    sqe.dev = table[bin[n]][pos[n]].calculateDeviation(dest, nAmino);
+    sqe.index1 = bin[n];
+    sqe.index2 = pos[n];
+
+    if (heap.size() < num) {
+        heap.push_back(sqe);
+        push_heap(heap.begin(), heap.end(), sDevLess);
+    } else if (sDevLess(sqe, heap.front())) {
+        pop_heap(heap.begin(), heap.end(), sDevLess);
+        heap.back() = sqe;
+        push_heap(heap.begin(), heap.end(), sDevLess);
+    }
+}
@@ -0,0 +1,83 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef _LOOPTABLEKDTREE_H_
+#define _LOOPTABLEKDTREE_H_
+
+// Includes:
+#include <vector>
+#include <LoopTableEntry.h>
+
+namespace Victor { namespace Lobo {
+
+    // Global constants, typedefs, etc. (to avoid):
+    struct solutionQueueElem;
+
+    /**
+     * @brief k-d tree over the end point, end direction and end normal of
+     *  the entries of a LoopTable.
+     * 
+     *@Description Answers exact k nearest neighbour queries for the
+     *      deviation metric of LoopTableEntry::calculateDeviation(). The
+     *      tree refers to the entries of the table it was built from, so it
+     *      has to be rebuilt whenever the table changes.
+     * */
+    class LoopTableKdTree {
+    public:
+
+        // CONSTRUCTORS/DESTRUCTOR:
+        LoopTableKdTree(const vector<vector<LoopTableEntry> >& entry);
+
+        // PREDICATES:
+
+        unsigned int size() const {
+            return bin.size();
+        }
+
+        void getNClosest(const LoopTableEntry& dest, unsigned int num,
+                unsigned int nAmino, vector<solutionQueueElem>& result) const;
+
+        static const unsigned int DIM = 9;
+
+    protected:
+
+        // HELPERS:
+        void pBuild(unsigned int lo, unsigned int hi, vector<unsigned int>& order);
+        void pSearch(unsigned int lo, unsigned int hi, const float* q,
+                const LoopTableEntry& dest, unsigned int nAmino,
+                unsigned int num, vector<solutionQueueElem>& heap) const;
+        void pConsider(unsigned int n, const LoopTableEntry& dest,
+                unsigned int nAmino, unsigned int num,
+                vector<solutionQueueElem>& heap) const;
+        static double pWeight(unsigned int dim);
+
+    private:
+
+        // ATTRIBUTES:
+        const vector<vector<LoopTableEntry> >& table;
+        vector<float> coord; // DIM values per point, in tree order
+        vector<unsigned int> bin; // table position of each point
+        vector<unsigned int> pos;
+        vector<unsigned char> splitDim; // split dimension of inner nodes
+
+        static const unsigned int LEAF_SIZE = 8;
+    };
+
+}} // namespace
+
+#endif //_LOOPTABLEKDTREE_H_
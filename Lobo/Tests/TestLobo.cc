@@ -10,6 +10,7 @@
 #include <cppunit/ui/text/TestRunner.h>
 #include <TestVectorTransformation.h>
 #include <TestLoopModel.h>
+#include <TestLoopTable.h>
 using namespace std;
 
 
@@ -19,6 +20,7 @@ int main() {
 	cout << "Creating Test Suites:" << endl;
         runner.addTest(TestLoopModel::suite());
          runner.addTest(TestVectorTransformation::suite());
+         runner.addTest(TestLoopTable::suite());
 	cout<< "Running the unit tests."<<endl;
 	runner.run();
 
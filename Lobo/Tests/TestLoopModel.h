@@ -40,6 +40,9 @@ public:
         suiteOfTests->addTest(new CppUnit::TestCaller<TestLoopModel>("Test2 - verifies the initialized values.",
                 &TestLoopModel::testTestLoopModel_B));
 
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestLoopModel>("Test3 - same loops with 2 and 4 threads.",
+                &TestLoopModel::testTestLoopModel_C));
+
 
         return suiteOfTests;
     }
@@ -90,4 +93,45 @@ protected:
         double EndRmsFromConst = lm.getENDRMS_WEIGHT(0);
         CPPUNIT_ASSERT((EndRmsFromConst==125 )&& (tableFileFromConstructor==tableFile));
     }
+
+    void testTestLoopModel_C() {
+        // models the same loop with 2 and 4 threads
+        string path = getenv("VICTOR_ROOT");
+        string inputFile = path + "Biopool/Tests/data/3DFR.pdb";
+
+        ifstream inFile(inputFile.c_str());
+        if (!inFile)
+            ERROR("File not found.", exception);
+        PdbLoader pl(inFile);
+        Protein prot;
+        pl.setNoVerbose();
+        pl.setNoHAtoms();
+        prot.load(pl);
+        Spacer* sp = prot.getSpacer('A');
+        sp->setStateFromTorsionAngles();
+        unsigned int index1 = sp->getIndexFromPdbNumber(60);
+        unsigned int index2 = sp->getIndexFromPdbNumber(63);
+        vector<string> typeVec;
+        for (unsigned int i = index1 + 1; i < index2 + 1; i++)
+            typeVec.push_back(sp->getAmino(i).getType());
+
+        vector<Spacer> vsp[2];
+        for (unsigned int t = 0; t < 2; t++) {
+            srand(1); // the state of a new process, as for lobo
+            LoopModel lm;
+            lm.setQuiet();
+            lm.setNumThreads(2 * (t + 1));
+            vsp[t] = lm.createLoopModel(sp->getAmino(index1),
+                    sp->getAmino(index1 + 1)[N].getCoords(), sp->getAmino(index2),
+                    sp->getAmino(index2 + 1)[N].getCoords(), index1, index2, 20,
+                    1, typeVec);
+        }
+
+        CPPUNIT_ASSERT((vsp[0].size() > 0) && (vsp[0].size() == vsp[1].size()));
+        for (unsigned int i = 0; i < vsp[0].size(); i++)
+            for (unsigned int j = 0; j < vsp[0][i].sizeAmino(); j++)
+                for (unsigned int k = 0; k < vsp[0][i].getAmino(j).size(); k++)
+                    CPPUNIT_ASSERT(vsp[0][i].getAmino(j)[k].getCoords()
+                        == vsp[1][i].getAmino(j)[k].getCoords());
+    }
 };
@@ -0,0 +1,164 @@
+/*
+ * TestLoopTable.h
+ *
+ * Compressed and memory mapped loop table formats.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <algorithm>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCase.h>
+
+#include <LoopTable.h>
+
+using namespace std;
+using namespace Victor::Lobo;
+
+class TestLoopTable : public CppUnit::TestFixture {
+private:
+    RamachandranData rama;
+    LoopTable table; // 2 amino acid table
+    string path;
+public:
+
+    TestLoopTable() {
+    }
+
+    virtual ~TestLoopTable() {
+    }
+
+    static CppUnit::Test *suite() {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("TestLoopTable");
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestLoopTable>("Test1 - compressed table round trip.",
+                &TestLoopTable::testLoopTable_compressed));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestLoopTable>("Test2 - mapped table equals the rotated table.",
+                &TestLoopTable::testLoopTable_mapped));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestLoopTable>("Test3 - k-d tree search is exact.",
+                &TestLoopTable::testLoopTable_kdTree));
+
+        suiteOfTests->addTest(new CppUnit::TestCaller<TestLoopTable>("Test4 - short loops moved onto the destination.",
+                &TestLoopTable::testLoopTable_moved));
+
+        return suiteOfTests;
+    }
+
+    /// Setup method
+
+    void setUp() {
+        path = getenv("VICTOR_ROOT");
+        path += "Lobo/Tests/data/";
+
+        istringstream ramaIn("4\n-63 -42 ALA\n-57 -47 ALA\n-120 130 ALA\n-139 135 ALA\n");
+        rama.load(ramaIn);
+
+        LoopTable single;
+        single.setRama(&rama);
+        single.setToSingleAminoAcid();
+        table.setRama(&rama);
+        table.concatenate(single, single, 256, 1);
+    }
+
+    /// Teardown method
+
+    void tearDown() {
+        remove((path + "testTable.lt").c_str());
+        remove((path + "testTable.ltb").c_str());
+    }
+
+protected:
+
+    void testLoopTable_compressed() {
+        table.write(path + "testTable.lt");
+        LoopTable lt;
+        lt.read(path + "testTable.lt");
+        CPPUNIT_ASSERT(!lt.isMapped() && !lt.isRotated());
+        CPPUNIT_ASSERT((lt.size() == table.size()) && (lt.getLength() == 2));
+        for (unsigned int i = 0; i < 6; i++)
+            for (unsigned int j = 0; j < 3; j++) {
+                CPPUNIT_ASSERT(lt.getMin()[i][j] == table.getMin()[i][j]);
+                CPPUNIT_ASSERT(lt.getMax()[i][j] == table.getMax()[i][j]);
+            }
+        // values are quantized to 16 bits
+        for (unsigned int n = 0; n < lt.size(); n++)
+            CPPUNIT_ASSERT(lt[n].calculateDeviation(table[n]) < 0.01);
+    }
+
+    void testLoopTable_mapped() {
+        table.rotateIntoXYPlane();
+        table.writeMapped(path + "testTable.ltb");
+        LoopTable lt;
+        lt.read(path + "testTable.ltb");
+        CPPUNIT_ASSERT(lt.isMapped() && lt.isRotated());
+        CPPUNIT_ASSERT((lt.size() == table.size()) && (lt.getLength() == 2));
+
+        LoopTableEntry dest = table[table.size() / 2];
+        dest.endPoint.x += 0.1;
+        LoopTableEntry c1 = table.getClosest(dest);
+        LoopTableEntry c2 = lt.getClosest(dest);
+        CPPUNIT_ASSERT(c1.calculateDeviation(c2) == 0.0);
+
+        for (unsigned int n = 0; n < lt.size(); n++)
+            for (unsigned int i = 0; i < 6; i++)
+                CPPUNIT_ASSERT(lt[n][i] == table[n][i]);
+
+        // modifying the table releases the mapping
+        lt.cluster(0.0);
+        CPPUNIT_ASSERT(!lt.isMapped() && (lt.size() > 0));
+    }
+
+    void testLoopTable_kdTree() {
+        LoopTableEntry dest = table[table.size() / 3];
+        dest.endPoint.y += 0.2;
+        dest.endNormal.x -= 0.1;
+
+        vector<double> all;
+        for (unsigned int n = 0; n < table.size(); n++)
+            all.push_back(table[n].calculateDeviation(dest));
+        sort(all.begin(), all.end());
+
+        LoopTable::USE_KD_TREE = true;
+        vector<LoopTableEntry> best = table.getNClosest(dest, 10, 8);
+        LoopTableEntry second = table.getClosest(dest, 1);
+        LoopTable::USE_KD_TREE = false;
+
+        CPPUNIT_ASSERT(best.size() > 0);
+        for (unsigned int i = 0; i < best.size(); i++)
+            CPPUNIT_ASSERT(best[i].calculateDeviation(dest) == all[i]);
+        CPPUNIT_ASSERT(second.calculateDeviation(dest) == all[1]);
+    }
+
+    void testLoopTable_moved() {
+        LoopTableEntry dest = table[table.size() / 2];
+        dest.endPoint.x += 0.1;
+        LoopTable fixed(table);
+        fixed.prepareSearch();
+
+        // the binned search moves the returned entries in the table
+        vector<LoopTableEntry> best = table.getNClosest(dest, 3, 2);
+        CPPUNIT_ASSERT(best.size() > 0);
+        unsigned int moved = 0;
+        for (unsigned int n = 0; n < table.size(); n++)
+            if (table[n].endPoint == dest.endPoint)
+                moved++;
+        CPPUNIT_ASSERT(moved == best.size());
+
+        // after prepareSearch() only the returned entries are moved
+        vector<LoopTableEntry> copies = fixed.getNClosest(dest, 3, 2);
+        CPPUNIT_ASSERT(copies.size() == best.size());
+        for (unsigned int i = 0; i < copies.size(); i++) {
+            CPPUNIT_ASSERT(copies[i].endPoint == dest.endPoint);
+            CPPUNIT_ASSERT(copies[i].midPoint == best[i].midPoint);
+        }
+        for (unsigned int n = 0; n < fixed.size(); n++)
+            CPPUNIT_ASSERT(fixed[n].endPoint != dest.endPoint);
+    }
+
+};
@@ -0,0 +1,43 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @Description: data files compiled into the libraries.
+ */
+#ifndef __EMBEDDED_DATA_H__
+#define __EMBEDDED_DATA_H__
+
+namespace Victor {
+
+    /**
+     * @Description Contents of a data file, generated at build time by
+     * tools/embedData.sh. In "tokens" mode the whitespace separated tokens
+     * are split into numbers and words, each kept in file order; in
+     * "lines" mode the lines are kept verbatim. The struct is an aggregate
+     * of constants, so it is initialised before any constructor runs.
+     */
+    struct EmbeddedData {
+        const double* numbers;
+        unsigned int sizeNumbers;
+        const char* const* words;
+        unsigned int sizeWords;
+        const char* const* lines;
+        unsigned int sizeLines;
+    };
+
+} // namespace
+
+#endif /* __EMBEDDED_DATA_H__ */
@@ -154,15 +154,22 @@ template int readNumber<int>(istream& is, int& result);
  * @Description:  read a whole line into a string*/
 string readLine(istream& is) {
     string str = "";
+    readLine(is, str);
+    return str;
+}
+
+/**
+ * @Description:  reads a whole line into str, reusing its memory*/
+void readLine(istream& is, string& str) {
+    str.clear();
     eatComment(is);
     char c;
     while (is.get(c)) {
         if ((c == '\n') || (c == '\r'))
             break;
         else
-            str = str + c;
+            str += c;
     }
-    return str;
 }
 
 /**
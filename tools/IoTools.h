@@ -56,6 +56,7 @@ template<class T> int readNumber(istream& is, T& result);
 
 /// Read a whole line into a string.
 string readLine(istream& is);
+void readLine(istream& is, string& str);
 
 /// Skips to new line.
 void skipToNewLine(istream& is);
@@ -0,0 +1,73 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "MappedFile.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+// CONSTRUCTORS/DESTRUCTOR:
+
+MappedFile::MappedFile() : mapData(NULL), mapSize(0) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+// MODIFIERS:
+
+/**
+ * @Description maps fileName, replacing any previous mapping
+ * @param fileName
+ * @return false if the file cannot be opened or is empty
+ */
+bool MappedFile::open(const string& fileName) {
+    close();
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size <= 0)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping stays valid
+    if (p == MAP_FAILED)
+        return false;
+
+    mapData = static_cast<const char*> (p);
+    mapSize = st.st_size;
+    return true;
+}
+
+/**
+ * @Description releases the mapping
+ */
+void MappedFile::close() {
+    if (mapData != NULL)
+        munmap(const_cast<char*> (mapData), mapSize);
+    mapData = NULL;
+    mapSize = 0;
+}
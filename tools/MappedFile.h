@@ -0,0 +1,66 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @Description: read-only memory mapping of a whole file.
+ */
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @Description Maps a file read-only into memory. The pages are shared
+ * with every other process mapping the same file, so large read-only data
+ * (eg. lookup tables) is loaded once per node and only on demand.
+ */
+class MappedFile {
+public:
+
+    // CONSTRUCTORS/DESTRUCTOR:
+    MappedFile();
+    ~MappedFile();
+
+    // PREDICATES:
+
+    bool isOpen() const {
+        return mapData != NULL;
+    }
+
+    const char* getData() const {
+        return mapData;
+    }
+
+    size_t size() const {
+        return mapSize;
+    }
+
+    // MODIFIERS:
+    bool open(const std::string& fileName);
+    void close();
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    // ATTRIBUTES:
+    const char* mapData;
+    size_t mapSize;
+};
+
+#endif
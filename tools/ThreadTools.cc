@@ -0,0 +1,125 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ThreadTools.h"
+#include <unistd.h>
+#include <sys/time.h>
+#include <cstdlib>
+#include <vector>
+#include <Debug.h>
+
+using namespace std;
+
+/// Shared state of the threads of one runParallel() call.
+struct ParallelJob {
+    ParallelTask* task;
+    unsigned int size;
+    unsigned int next; // next item to hand out
+};
+
+/**
+ * @Description thread body: takes items until none is left
+ * @param ParallelJob*
+ */
+static void* sRunItems(void* arg) {
+    ParallelJob* job = static_cast<ParallelJob*> (arg);
+    while (true) {
+        unsigned int n = __sync_fetch_and_add(&job->next, 1);
+        if (n >= job->size)
+            break;
+        job->task->run(n);
+    }
+    return NULL;
+}
+
+/**
+ * @Description number of processors online
+ * @return unsigned int, at least 1
+ */
+unsigned int getNumProcessors() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? static_cast<unsigned int> (n) : 1;
+}
+
+/**
+ * @Description runs all items of a task, on numThreads threads including
+ * the calling one. Items are handed out one at a time in increasing order.
+ * @param ParallelTask& task, unsigned int size, unsigned int numThreads
+ * (0 = one per processor)
+ */
+void runParallel(ParallelTask& task, unsigned int size,
+        unsigned int numThreads) {
+    if (numThreads == 0)
+        numThreads = getNumProcessors();
+    if (numThreads > size)
+        numThreads = size;
+    if (numThreads <= 1) {
+        for (unsigned int n = 0; n < size; n++)
+            task.run(n);
+        return;
+    }
+
+    ParallelJob job;
+    job.task = &task;
+    job.size = size;
+    job.next = 0;
+
+    vector<pthread_t> threads(numThreads - 1);
+    unsigned int started = 0;
+    for (; started < threads.size(); started++)
+        if (pthread_create(&threads[started], NULL, sRunItems, &job) != 0)
+            break; // go on with the threads we have
+    sRunItems(&job);
+    for (unsigned int i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+}
+
+/**
+ * @Description wall clock time
+ * @return seconds since the epoch, with microsecond resolution
+ */
+double getWallTime() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static pthread_key_t sSeedKey;
+static pthread_once_t sSeedOnce = PTHREAD_ONCE_INIT;
+
+static void sCreateSeedKey() {
+    pthread_key_create(&sSeedKey, NULL);
+}
+
+/**
+ * @Description selects the random number stream of the calling thread
+ * @param unsigned int* seed, owned by the caller, or NULL for rand()
+ */
+void setThreadSeed(unsigned int* seed) {
+    pthread_once(&sSeedOnce, sCreateSeedKey);
+    pthread_setspecific(sSeedKey, seed);
+}
+
+/**
+ * @Description random number in [0, RAND_MAX]
+ * @return int, from the stream selected by setThreadSeed()
+ */
+int threadRand() {
+    pthread_once(&sSeedOnce, sCreateSeedKey);
+    unsigned int* seed = static_cast<unsigned int*> (pthread_getspecific(sSeedKey));
+    return (seed != NULL) ? rand_r(seed) : rand();
+}
@@ -0,0 +1,109 @@
+/*  This file is part of Victor.
+
+    Victor is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Victor is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Victor.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @Description: minimal pthread helpers to spread independent work items
+ *               over several threads.
+ */
+#ifndef __THREAD_TOOLS_H__
+#define __THREAD_TOOLS_H__
+
+#include <pthread.h>
+
+/**
+ * @Description A set of independent work items, numbered 0..size-1.
+ * run() is called concurrently for different items and must only write
+ * to data owned by its item.
+ */
+class ParallelTask {
+public:
+
+    virtual ~ParallelTask() {
+    }
+
+    virtual void run(unsigned int n) = 0;
+};
+
+/**
+ * @Description Mutual exclusion lock.
+ */
+class Mutex {
+public:
+
+    Mutex() {
+        pthread_mutex_init(&mutex, NULL);
+    }
+
+    ~Mutex() {
+        pthread_mutex_destroy(&mutex);
+    }
+
+    void lock() {
+        pthread_mutex_lock(&mutex);
+    }
+
+    void unlock() {
+        pthread_mutex_unlock(&mutex);
+    }
+
+private:
+    Mutex(const Mutex&);
+    Mutex& operator=(const Mutex&);
+
+    pthread_mutex_t mutex;
+};
+
+/**
+ * @Description Holds a Mutex for the lifetime of the object.
+ */
+class MutexLock {
+public:
+
+    MutexLock(Mutex& m) : mutex(m) {
+        mutex.lock();
+    }
+
+    ~MutexLock() {
+        mutex.unlock();
+    }
+
+private:
+    MutexLock(const MutexLock&);
+    MutexLock& operator=(const MutexLock&);
+
+    Mutex& mutex;
+};
+
+/// Number of processors online, at least 1.
+unsigned int getNumProcessors();
+
+/// Wall clock time in seconds, for timing multi-threaded code (clock()
+/// adds up the CPU time of all threads).
+double getWallTime();
+
+/// Runs task items 0..size-1 on numThreads threads (0 = all processors).
+void runParallel(ParallelTask& task, unsigned int size,
+        unsigned int numThreads);
+
+/// Makes threadRand() on the calling thread draw from rand_r(seed), or
+/// from the shared rand() again if seed is NULL. Lets parallel work items
+/// use reproducible random numbers, independent of thread scheduling.
+void setThreadSeed(unsigned int* seed);
+
+/// rand() replacement honouring setThreadSeed().
+int threadRand();
+
+#endif
@@ -0,0 +1,105 @@
+#!/bin/sh
+#
+# Converts a text data file into a C++ source defining an EmbeddedData
+# table (see EmbeddedData.h), so that the data is compiled into a library
+# instead of being read and parsed at run time.
+#
+# usage: embedData.sh <tokens|lines> <data file> <name>
+#
+#  tokens: whitespace separated tokens, numbers and words kept apart, in
+#          file order. A token is a number if it reads as a decimal number.
+#  lines:  the lines of the file, verbatim.
+#
+
+if [ $# -lt 3 ]; then
+    echo "usage: $0 <tokens|lines> <data file> <name>" >&2
+    exit 1
+fi
+
+MODE=$1
+INPUT=$2
+NAME=$3
+
+if [ ! -r "$INPUT" ]; then
+    echo "$0: cannot read $INPUT" >&2
+    exit 1
+fi
+
+echo "// Generated from `basename $INPUT` by embedData.sh, do not edit."
+echo "#include <EmbeddedData.h>"
+echo ""
+echo "namespace Victor {"
+
+case $MODE in
+tokens)
+    awk -v name="$NAME" '
+    # drops leading zeros, which would make an octal literal
+    function literal(t,    sign) {
+        sign = ""
+        if (t ~ /^[-+]/) {
+            sign = substr(t, 1, 1)
+            t = substr(t, 2)
+        }
+        while ((length(t) > 1) && (t ~ /^0[0-9]/))
+            t = substr(t, 2)
+        return sign t
+    }
+    BEGIN { nNum = 0; nWord = 0 }
+    {
+        sub(/\r$/, "")
+        for (i = 1; i <= NF; i++)
+            if ($i ~ /^[-+]?([0-9]+\.?[0-9]*|\.[0-9]+)([eE][-+]?[0-9]+)?$/)
+                num[nNum++] = literal($i)
+            else {
+                gsub(/\\/, "\\\\", $i)
+                gsub(/"/, "\\\"", $i)
+                word[nWord++] = $i
+            }
+    }
+    END {
+        printf "    static const double sNumbers[] = {\n"
+        if (nNum == 0)
+            printf "        0"
+        for (i = 0; i < nNum; i++)
+            printf "%s%s", (i % 8 == 0 ? (i > 0 ? ",\n        " : "        ") : ", "), num[i]
+        printf "\n    };\n"
+        printf "    static const char* const sWords[] = {\n"
+        if (nWord == 0)
+            printf "        \"\""
+        for (i = 0; i < nWord; i++)
+            printf "%s\"%s\"", (i % 8 == 0 ? (i > 0 ? ",\n        " : "        ") : ", "), word[i]
+        printf "\n    };\n"
+        printf "\n    extern const EmbeddedData %s;\n", name
+        printf "    const EmbeddedData %s = {\n", name
+        printf "        sNumbers, %d, sWords, %d, 0, 0\n    };\n", nNum, nWord
+    }' "$INPUT"
+    ;;
+lines)
+    awk -v name="$NAME" '
+    BEGIN { n = 0 }
+    {
+        sub(/\r$/, "")
+        gsub(/\\/, "\\\\")
+        gsub(/"/, "\\\"")
+        line[n++] = $0
+    }
+    END {
+        printf "    static const char* const sLines[] = {\n"
+        if (n == 0)
+            printf "        \"\""
+        for (i = 0; i < n; i++)
+            printf "%s        \"%s\"", (i > 0 ? ",\n" : ""), line[i]
+        printf "\n    };\n"
+        printf "\n    extern const EmbeddedData %s;\n", name
+        printf "    const EmbeddedData %s = {\n", name
+        printf "        0, 0, 0, 0, sLines, %d\n    };\n", n
+    }' "$INPUT"
+    ;;
+*)
+    echo "$0: unknown mode $MODE" >&2
+    exit 1
+    ;;
+esac
+
+echo ""
+echo "} // namespace"